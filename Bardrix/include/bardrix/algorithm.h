@@ -6,6 +6,8 @@
 
 #include <bardrix/bardrix.h>
 #include <bardrix/objects.h>
+#include <bardrix/simd.h>
+#include <bardrix/quaternion.h>
 
 namespace bardrix {
 
@@ -470,9 +472,101 @@ namespace bardrix {
 
     }; // struct bvh_data
 
-    /// \brief Represents a binary tree used for building a bounding volume hierarchy (BVH).    \n
+    /// \brief Represents a node of a flattened bounding volume hierarchy (BVH).                                 \n
+    ///        The nodes are stored depth first in a single array, the left child of an interior node is always the \n
+    ///        next node in the array and the right child is stored at the offset.
+    /// \details The node is 56 bytes, it stores the bounds as plain doubles and indices instead of pointers.
+    struct bvh_node {
+        /// \brief The minimum point of the bounding box of the node (x, y, z).
+        double min[3];
+
+        /// \brief The maximum point of the bounding box of the node (x, y, z).
+        double max[3];
+
+        /// \brief Interior node: the index of the right child. \n
+        ///        Leaf node: the index of the first primitive.
+        std::uint32_t offset;
+
+        /// \brief The number of primitives in the node, 0 for interior nodes.
+        std::uint32_t count;
+
+        /// \brief Checks if the node is a leaf.
+        /// \return True if the node contains primitives, false if it's an interior node.
+        NODISCARD bool is_leaf() const noexcept;
+
+        /// \brief Gets the bounding box of the node.
+        /// \return The bounding box of the node.
+        NODISCARD bardrix::bounding_box bounding_box() const noexcept;
+
+        /// \brief Sets the bounds of the node to the given bounding box.
+        /// \param box The bounding box to set.
+        void set_bounding_box(const bardrix::bounding_box& box) noexcept;
+
+        /// \brief Gets the surface area of the bounding box of the node.
+        /// \return The surface area of the bounding box of the node.
+        NODISCARD double area() const noexcept;
+
+    }; // struct bvh_node
+
+    static_assert(sizeof(bvh_node) == 56, "bvh_node must stay 56 bytes");
+
+    /// \brief Represents the closest hit of a ray in a bounding volume hierarchy (BVH).
+    struct bvh_hit {
+        /// \brief The shape that was hit.
+        const bardrix::shape* shape;
+
+        /// \brief The distance from the origin of the ray to the intersection.
+        double distance;
+
+    }; // struct bvh_hit
+
+    /// \brief Represents a bounding volume hierarchy (BVH).                                                           \n
     ///        The BVH is used for optimizing ray intersections with shapes, as it reduces the number of shapes to check for intersections.
-    class bvh_tree : private binary_tree<bvh_data> {
+    /// \details The tree is stored as a depth first array of bvh_node, the shapes are stored in the order of the leaves.
+    class bvh_tree {
+        friend class instanced_bvh;
+        friend class mapped_bvh;
+        friend class scene;
+
+        template<typename Shape>
+        friend class indexed_bvh;
+
+        template<typename T>
+        friend class mesh_buffers;
+
+    public:
+        /// \brief The default number of bins per axis used by construct_sah.
+        static constexpr std::size_t default_sah_bins = 16;
+
+        /// \brief The default number of bits of the Morton codes used by construct_morton (10 bits per axis).
+        static constexpr std::size_t default_morton_bits = 30;
+
+        /// \brief The default number of extra shape references construct_sbvh may add, relative to the number of shapes.
+        static constexpr double default_sbvh_budget = 0.3;
+
+        /// \brief The version of the binary format written by save, load and mapped_bvh only accept this version.
+        static constexpr std::uint32_t file_version = 1;
+
+        /// \brief The maximum depth of the BVH tree, every builder stays within this depth.
+        /// \details Traversal uses a fixed size stack of this size, so it doesn't allocate.
+        static constexpr std::size_t max_depth = 64;
+
+        /// \brief The maximum number of rays traced together as one packet (8x8) by closest_hits.
+        static constexpr std::size_t max_packet_size = 64;
+
+    private:
+        /// \brief The nodes of the BVH tree, depth first, the root is the first node.
+        std::vector<bvh_node> nodes_;
+
+        /// \brief The shapes of the BVH tree, in the order of the leaves.
+        std::vector<std::shared_ptr<bardrix::shape>> primitives_;
+
+        /// \brief The sah_cost of the BVH tree right after it was constructed.
+        double build_cost_ = 0;
+
+        /// \brief True if a shape is referenced by more than one leaf (see construct_sbvh).
+        bool duplicates_ = false;
+
     public:
         explicit bvh_tree();
 
@@ -480,23 +574,160 @@ namespace bardrix {
         /// \tparam Shape Base of bardrix::shape.
         /// \param shapes The shapes to construct the BVH tree from.
         /// \param size The number of shapes to construct the BVH tree from.
+        /// \param threads The number of threads used to construct the BVH tree, 0 uses all hardware threads.
         /// \example std::shared_ptr<bardrix::shape> shapes[] = {sphere1, sphere2, sphere3}; \n
         ///          tree.construct_longest_axis(shapes, sizeof shapes / sizeof shapes[0]);
         template<typename Shape, typename = std::enable_if_t<std::is_base_of_v<bardrix::shape, Shape>>>
-        void construct_longest_axis(std::shared_ptr<Shape>* shapes, std::size_t size) noexcept;
+        void construct_longest_axis(std::shared_ptr<Shape>* shapes, std::size_t size, std::size_t threads = 1) noexcept;
 
         /// \brief Constructs a BVH tree from the given shapes, using the longest axis algorithm.
         /// \tparam Iterator Iterator must be of type std::shared_ptr<shape>::iterator, but can be derived from shape.
         /// \param begin The beginning of the shapes to construct the BVH tree from.
         /// \param end The end of the shapes to construct the BVH tree from.
+        /// \param threads The number of threads used to construct the BVH tree, 0 uses all hardware threads.
         /// \example std::vector<std::shared_ptr<bardrix::shape>> shapes = {sphere1, sphere2, sphere3}; \n
         ///          tree.construct_longest_axis(shapes.begin(), shapes.end());
         /// \details O(N log N) time complexity, where N is the number of shapes to construct the BVH tree from. \n
-        ///          However this might be deceptive, as the true complexity is O(4N log N) due to merging the bounding boxes.
+        ///          The bounding box of every shape is only calculated once. \n
+        ///          With more than one thread the sort and the subtrees are divided over the threads.
         template<typename Iterator, typename = std::enable_if_t<
                 std::is_base_of_v<bardrix::shape, typename std::iterator_traits<Iterator>::value_type::element_type> &&
                 std::is_same_v<std::shared_ptr<typename std::iterator_traits<Iterator>::value_type::element_type>, typename std::iterator_traits<Iterator>::value_type>>>
-        void construct_longest_axis(const Iterator& begin, const Iterator& end);
+        void construct_longest_axis(const Iterator& begin, const Iterator& end, std::size_t threads = 1);
+
+        /// \brief Constructs a BVH tree from the given shapes, using the surface area heuristic (SAH).
+        /// \tparam Shape Base of bardrix::shape.
+        /// \param shapes The shapes to construct the BVH tree from.
+        /// \param size The number of shapes to construct the BVH tree from.
+        /// \param bins The number of bins used per axis to evaluate the split candidates, it cannot be less than 2.
+        /// \param threads The number of threads used to construct the BVH tree, 0 uses all hardware threads.
+        /// \example std::shared_ptr<bardrix::shape> shapes[] = {sphere1, sphere2, sphere3}; \n
+        ///          tree.construct_sah(shapes, sizeof shapes / sizeof shapes[0]);
+        template<typename Shape, typename = std::enable_if_t<std::is_base_of_v<bardrix::shape, Shape>>>
+        void construct_sah(std::shared_ptr<Shape>* shapes, std::size_t size, std::size_t bins = default_sah_bins,
+                           std::size_t threads = 1) noexcept;
+
+        /// \brief Constructs a BVH tree from the given shapes, using the surface area heuristic (SAH).          \n
+        ///        At every level the centroids of the shapes are binned on all three axes, the split with the   \n
+        ///        lowest expected cost (area(left) * count(left) + area(right) * count(right)) is chosen.
+        /// \tparam Iterator Iterator must be of type std::shared_ptr<shape>::iterator, but can be derived from shape.
+        /// \param begin The beginning of the shapes to construct the BVH tree from.
+        /// \param end The end of the shapes to construct the BVH tree from.
+        /// \param bins The number of bins used per axis to evaluate the split candidates, it cannot be less than 2.
+        /// \param threads The number of threads used to construct the BVH tree, 0 uses all hardware threads.
+        /// \example std::vector<std::shared_ptr<bardrix::shape>> shapes = {sphere1, sphere2, sphere3}; \n
+        ///          tree.construct_sah(shapes.begin(), shapes.end(), bardrix::bvh_tree::default_sah_bins, 0);
+        /// \details O(N log N) time complexity, where N is the number of shapes to construct the BVH tree from. \n
+        ///          The bounding box of every shape is only calculated once. \n
+        ///          With more than one thread the binning and partitioning of large nodes and the subtrees are divided over the threads.
+        /// \note If the centroids cannot be separated (e.g. all shapes share the same center), the shapes are split by count. \n
+        ///       Deep subtrees are split by count as well, to stay within max_depth.
+        template<typename Iterator, typename = std::enable_if_t<
+                std::is_base_of_v<bardrix::shape, typename std::iterator_traits<Iterator>::value_type::element_type> &&
+                std::is_same_v<std::shared_ptr<typename std::iterator_traits<Iterator>::value_type::element_type>, typename std::iterator_traits<Iterator>::value_type>>>
+        void construct_sah(const Iterator& begin, const Iterator& end, std::size_t bins = default_sah_bins,
+                           std::size_t threads = 1);
+
+        /// \brief Constructs a BVH tree from the given shapes, using Morton codes (linear BVH).
+        /// \tparam Shape Base of bardrix::shape.
+        /// \param shapes The shapes to construct the BVH tree from.
+        /// \param size The number of shapes to construct the BVH tree from.
+        /// \param bits The number of bits of the Morton codes, 30 (10 per axis) or 63 (21 per axis).
+        /// \param threads The number of threads used to construct the BVH tree, 0 uses all hardware threads.
+        /// \example std::shared_ptr<bardrix::shape> shapes[] = {sphere1, sphere2, sphere3}; \n
+        ///          tree.construct_morton(shapes, sizeof shapes / sizeof shapes[0]);
+        template<typename Shape, typename = std::enable_if_t<std::is_base_of_v<bardrix::shape, Shape>>>
+        void construct_morton(std::shared_ptr<Shape>* shapes, std::size_t size, std::size_t bits = default_morton_bits,
+                              std::size_t threads = 1) noexcept;
+
+        /// \brief Constructs a BVH tree from the given shapes, using Morton codes (linear BVH).                \n
+        ///        The centers of the shapes are quantized to a grid over the scene and interleaved into Morton \n
+        ///        codes, which are radix sorted. Every node is split where the highest bit of the codes changes.
+        /// \tparam Iterator Iterator must be of type std::shared_ptr<shape>::iterator, but can be derived from shape.
+        /// \param begin The beginning of the shapes to construct the BVH tree from.
+        /// \param end The end of the shapes to construct the BVH tree from.
+        /// \param bits The number of bits of the Morton codes, 30 (10 per axis) or 63 (21 per axis), \n
+        ///             up to 30 uses 30 bit codes, more uses 63 bit codes.
+        /// \param threads The number of threads used to construct the BVH tree, 0 uses all hardware threads.
+        /// \example std::vector<std::shared_ptr<bardrix::shape>> shapes = {sphere1, sphere2, sphere3}; \n
+        ///          tree.construct_morton(shapes.begin(), shapes.end()); // e.g. every frame
+        /// \details O(N) time complexity for the codes and the radix sort, where N is the number of shapes, \n
+        ///          the split of every node is found with a binary search over its sorted codes. \n
+        ///          Much faster than construct_sah, but the tree is of lower quality (see sah_cost), \n
+        ///          meant for scenes that change every frame.
+        /// \note Shapes with the same Morton code (e.g. the same center) are split by count. \n
+        ///       Deep subtrees are split by count as well, to stay within max_depth.
+        template<typename Iterator, typename = std::enable_if_t<
+                std::is_base_of_v<bardrix::shape, typename std::iterator_traits<Iterator>::value_type::element_type> &&
+                std::is_same_v<std::shared_ptr<typename std::iterator_traits<Iterator>::value_type::element_type>, typename std::iterator_traits<Iterator>::value_type>>>
+        void construct_morton(const Iterator& begin, const Iterator& end, std::size_t bits = default_morton_bits,
+                              std::size_t threads = 1);
+
+        /// \brief Constructs a BVH tree from the given shapes, using the surface area heuristic with spatial splits (SBVH).
+        /// \tparam Shape Base of bardrix::shape.
+        /// \param shapes The shapes to construct the BVH tree from.
+        /// \param size The number of shapes to construct the BVH tree from.
+        /// \param budget The number of extra shape references that may be added, relative to the number of shapes.
+        /// \param bins The number of bins used per axis to evaluate the split candidates, it cannot be less than 2.
+        /// \example std::shared_ptr<bardrix::shape> shapes[] = {sphere1, sphere2, sphere3}; \n
+        ///          tree.construct_sbvh(shapes, sizeof shapes / sizeof shapes[0]);
+        template<typename Shape, typename = std::enable_if_t<std::is_base_of_v<bardrix::shape, Shape>>>
+        void construct_sbvh(std::shared_ptr<Shape>* shapes, std::size_t size, double budget = default_sbvh_budget,
+                            std::size_t bins = default_sah_bins) noexcept;
+
+        /// \brief Constructs a BVH tree from the given shapes, using the surface area heuristic with spatial splits (SBVH). \n
+        ///        Next to the object splits of construct_sah, a node can be split by a plane, a shape that crosses    \n
+        ///        the plane is referenced by both children with its bounding box clipped to their side.
+        /// \tparam Iterator Iterator must be of type std::shared_ptr<shape>::iterator, but can be derived from shape.
+        /// \param begin The beginning of the shapes to construct the BVH tree from.
+        /// \param end The end of the shapes to construct the BVH tree from.
+        /// \param budget The number of extra shape references that may be added, relative to the number of shapes, \n
+        ///               e.g. 0.3 allows 30% more references, 0 is the same as construct_sah without spatial splits.
+        /// \param bins The number of bins used per axis to evaluate the split candidates, it cannot be less than 2.
+        /// \example std::vector<std::shared_ptr<bardrix::shape>> shapes = {background, sphere1, sphere2}; \n
+        ///          tree.construct_sbvh(shapes.begin(), shapes.end(), 0.5);
+        /// \details O(N log N) time complexity, where N is the number of shape references. \n
+        ///          Spatial splits are only tried when the children of the best object split overlap, \n
+        ///          this helps scenes with shapes of very different sizes, e.g. a few large background spheres.
+        /// \note A shape can be in more than one leaf, primitives() can hold the same shape more than once. \n
+        ///       The construction is done on one thread.
+        template<typename Iterator, typename = std::enable_if_t<
+                std::is_base_of_v<bardrix::shape, typename std::iterator_traits<Iterator>::value_type::element_type> &&
+                std::is_same_v<std::shared_ptr<typename std::iterator_traits<Iterator>::value_type::element_type>, typename std::iterator_traits<Iterator>::value_type>>>
+        void construct_sbvh(const Iterator& begin, const Iterator& end, double budget = default_sbvh_budget,
+                            std::size_t bins = default_sah_bins);
+
+        /// \brief Calculates the expected cost of traversing the BVH tree with a random ray, using the surface area heuristic. \n
+        ///        cost = traversal_cost * sum(area(interior) / area(root)) + intersection_cost * sum(area(leaf) * count(leaf) / area(root))
+        /// \param traversal_cost The cost of visiting an interior node (a box test), default 1.
+        /// \param intersection_cost The cost of intersecting a shape, default 1.
+        /// \return The expected cost of the tree, 0 if the tree is empty.
+        /// \example bvh.construct_longest_axis(shapes.begin(), shapes.end()); double longest = bvh.sah_cost(); \n
+        ///          bvh.construct_sah(shapes.begin(), shapes.end()); double sah = bvh.sah_cost(); // sah <= longest
+        /// \details O(N) time complexity, where N is the number of nodes in the BVH tree.
+        /// \note If the root has no surface area (e.g. all shapes are points), every node counts as fully visited.
+        NODISCARD double sah_cost(double traversal_cost = 1, double intersection_cost = 1) const noexcept;
+
+        /// \brief Recalculates the bounding boxes of all nodes from the current bounding boxes of the shapes, \n
+        ///        while keeping the structure of the BVH tree. Use this after moving shapes (e.g. sphere::set_position).
+        /// \example sphere->set_position(sphere->get_position() + velocity); \n
+        ///          tree.refit();
+        /// \details O(N) time complexity, where N is the number of nodes in the BVH tree. \n
+        ///          The children of a node are always stored after the node, so one reverse pass is enough.
+        /// \note The quality of the BVH tree can degrade when shapes move far, see degradation(). \n
+        ///       The leaves of a construct_sbvh tree get the full bounding boxes of their shapes again, \n
+        ///       so the spatial splits are lost (the tree stays correct), construct it again to get them back.
+        void refit();
+
+        /// \brief Gives how much the BVH tree has degraded since it was constructed, using the surface area heuristic.
+        /// \return The sah_cost of the BVH tree divided by the sah_cost right after it was constructed, \n
+        ///         1 if the BVH tree is empty or had no cost. \n
+        ///         For a construct_sbvh tree the cost after construction is the cost of its unclipped leaves, \n
+        ///         like after a refit, so the clipped tree is below 1 and a refit without movement is 1.
+        /// \example tree.refit(); \n
+        ///          if (tree.degradation() > 1.5) tree.construct_sah(shapes.begin(), shapes.end());
+        /// \details O(N) time complexity, where N is the number of nodes in the BVH tree.
+        NODISCARD double degradation() const noexcept;
 
         /// \brief Gives all the shapes that intersect with the given ray, in the form of out_hits.
         /// \param ray The ray to check for intersections with the shapes.
@@ -504,39 +735,780 @@ namespace bardrix {
         /// \example std::vector<const bardrix::shape*> hits; \n
         ///          tree.intersections(ray, hits);
         /// \details O(N) worst case time complexity, where N is the number of nodes in the BVH tree. \n
-        ///          It's hard to determine the average and best case due to the nature of the ray hitting the bounding boxes, but it's generally faster than O(N).
+        ///          It's hard to determine the average and best case due to the nature of the ray hitting the bounding boxes, but it's generally faster than O(N). \n
+        ///          The nodes are visited with an explicit stack, there is no recursion.
         void intersections(const bardrix::ray& ray, std::vector<const bardrix::shape*>& out_hits) const noexcept;
 
+        /// \brief Gives the closest shape that intersects with the given ray, together with the distance to the intersection.
+        /// \param ray The ray to check for intersections with the shapes, only hits within ray.get_length() are considered.
+        /// \return The closest hit, std::nullopt if no shape intersects with the ray.
+        /// \example std::optional<bardrix::bvh_hit> hit = tree.closest_hit(ray); \n
+        ///          if (hit) bardrix::point3 point = ray.point_at(hit->distance);
+        /// \details O(N) worst case time complexity, where N is the number of nodes in the BVH tree. \n
+        ///          The children are visited front to back and every hit shortens the ray, \n
+        ///          so nodes behind the closest hit are skipped. It doesn't allocate.
+        NODISCARD std::optional<bvh_hit> closest_hit(const bardrix::ray& ray) const;
+
+        /// \brief Gives the closest hit of every ray, the rays are traced together as packets of up to max_packet_size rays. \n
+        ///        Meant for coherent rays, like the primary rays of a block of pixels (see camera::shoot_rays).
+        /// \param rays The rays to check for intersections with the shapes, only hits within ray.get_length() are considered.
+        /// \param size The number of rays.
+        /// \param out_hits The closest hit of every ray, std::nullopt if the ray doesn't hit a shape, it must hold size elements.
+        /// \example std::vector<bardrix::ray> rays; \n
+        ///          camera.shoot_rays(x, y, 8, 8, 100, rays); \n
+        ///          std::optional<bardrix::bvh_hit> hits[64]; \n
+        ///          tree.closest_hits(rays.data(), rays.size(), hits);
+        /// \details A packet shares one node stack, every node is fetched once for all rays that are still active. \n
+        ///          Every ray keeps its own closest hit, so rays that hit something early drop out of the nodes behind it. \n
+        ///          The results are the same as calling closest_hit for every ray. It doesn't allocate.
+        void closest_hits(const bardrix::ray* rays, std::size_t size, std::optional<bvh_hit>* out_hits) const;
+
+        /// \brief Checks if any shape intersects with the given ray, e.g. a shadow ray towards a light.
+        /// \param ray The ray to check for intersections with the shapes, only hits within ray.get_length() are considered.
+        /// \return True if a shape intersects with the ray, false otherwise.
+        /// \example bardrix::ray shadow_ray(point, light.position); \n
+        ///          bool in_shadow = tree.occluded(shadow_ray);
+        /// \details O(N) worst case time complexity, where N is the number of nodes in the BVH tree. \n
+        ///          It returns at the first hit found and doesn't allocate.
+        NODISCARD bool occluded(const bardrix::ray& ray) const;
+
+        /// \brief Saves the BVH tree to a binary file, which can be loaded with load or mapped with mapped_bvh.
+        /// \param path The path of the file, it's overwritten if it exists.
+        /// \param shapes The shapes the BVH tree was constructed from, the file stores the index of every shape in it.
+        /// \example tree.construct_sah(shapes.begin(), shapes.end()); \n
+        ///          tree.save("scene.bvh", shapes);
+        /// \details The file is a header followed by the nodes and the shape index of every leaf primitive, \n
+        ///          it contains no pointers so it can be used in place at any address (see mapped_bvh).
+        /// \throws std::invalid_argument If a shape of the BVH tree is not in the given shapes.
+        /// \throws std::runtime_error If the file cannot be written.
+        /// \note The file uses the byte order of the machine, it's rejected on a machine with a different byte order.
+        void save(const std::string& path, const std::vector<std::shared_ptr<bardrix::shape>>& shapes) const;
+
+        /// \brief Replaces the BVH tree with a BVH tree saved with save.
+        /// \param path The path of the file.
+        /// \param shapes The shapes the BVH tree was constructed from, in the same order as given to save.
+        /// \example tree.load("scene.bvh", shapes);
+        /// \details O(N) time complexity, where N is the number of nodes, there is no construction.
+        /// \throws std::runtime_error If the file cannot be read, is not a BVH file of file_version, \n
+        ///                            has a node with an offset, count or depth outside of the tree \n
+        ///                            or references a shape index outside of the given shapes.
+        void load(const std::string& path, const std::vector<std::shared_ptr<bardrix::shape>>& shapes);
+
+        /// \brief Gets the nodes of the BVH tree.
+        /// \return The nodes of the BVH tree, depth first, the root is the first node.
+        NODISCARD const std::vector<bvh_node>& nodes() const noexcept;
+
+        /// \brief Gets the shapes of the BVH tree.
+        /// \return The shapes of the BVH tree, in the order of the leaves (bvh_node::offset and bvh_node::count index into this).
+        NODISCARD const std::vector<std::shared_ptr<bardrix::shape>>& primitives() const noexcept;
+
+        /// \brief Checks if the BVH tree is empty.
+        /// \return True if the BVH tree has no nodes, false otherwise.
+        NODISCARD bool is_empty() const noexcept;
+
+        /// \brief Clears the BVH tree, removing all nodes and shapes.
+        void clear() noexcept;
+
     private:
-        /// \brief Helper function for the longest axis predicate.
-        /// \param shape_lhs The left-hand side shape to compare.
-        /// \param shape_rhs The right-hand side shape to compare.
-        /// \param axis The axis to compare the shapes on. (has to be either x, y or z, otherwise it will throw an exception based on operator[] of point3).
-        /// \return True if the left-hand side shape is less than the right-hand side shape on the given axis, false otherwise.
-        static bool longest_axis_predicate(const std::shared_ptr<bardrix::shape>& shape_lhs,
-                                           const std::shared_ptr<bardrix::shape>& shape_rhs, axis axis);
+        /// \brief A shape index together with its cached bounding box and center, used while building the BVH tree.
+        /// \details Caching avoids calling the virtual shape::bounding_box() more than once per shape.
+        struct build_primitive {
+            /// \brief The bounding box of the shape.
+            bardrix::bounding_box box;
+
+            /// \brief The center of the bounding box of the shape.
+            bardrix::point3 center;
+
+            /// \brief The index of the shape in the given shapes.
+            std::uint32_t index;
+        };
+
+        /// \brief The nodes and shape indices of a (partially) constructed BVH tree.
+        /// \details Subtrees constructed on other threads get their own build_output, which is appended afterwards.
+        struct build_output {
+            /// \brief The nodes, depth first.
+            std::vector<bvh_node> nodes;
+
+            /// \brief The index of the shape of every leaf primitive, in the order of the leaves.
+            std::vector<std::uint32_t> indices;
+        };
+
+        /// \brief The minimum number of shapes in a node before the work is divided over multiple threads.
+        static constexpr std::size_t parallel_threshold = 4096;
+
+        /// \brief Gets the number of threads to use.
+        /// \param threads The requested number of threads, 0 for all hardware threads.
+        /// \return The number of threads to use, at least 1.
+        static std::size_t thread_count(std::size_t threads) noexcept;
+
+        /// \brief Divides [0, size) into equal chunks and calls the function for every chunk, on its own thread.
+        /// \param size The number of elements.
+        /// \param threads The number of threads (and chunks) to use.
+        /// \param function The function to call with the chunk index, the first and the last (exclusive) element.
+        static void parallel_for(std::size_t size, std::size_t threads,
+                                 const std::function<void(std::size_t, std::size_t, std::size_t)>& function);
+
+        /// \brief The rays of a packet, prepared for slab tests the same way as traversal_ray, stored as a structure of arrays.
+        struct ray_packet {
+            /// \brief The origin of every ray, per axis (x, y, z).
+            double origin[3][max_packet_size];
+
+            /// \brief The inverse direction of every ray, per axis (x, y, z).
+            double inverse_direction[3][max_packet_size];
+
+            /// \brief The end of the interval of every ray, it shrinks to the closest hit.
+            double t_max[max_packet_size];
+
+            /// \brief The sign of the direction of every ray, per axis (x, y, z).
+            std::uint8_t sign[3][max_packet_size];
+        };
+
+        /// \brief Traces up to max_packet_size rays together, this function is a helper function for closest_hits.
+        /// \param rays The rays to trace.
+        /// \param size The number of rays, at most max_packet_size.
+        /// \param out_hits The closest hit of every ray.
+        void closest_hits_packet(const bardrix::ray* rays, std::size_t size, std::optional<bvh_hit>* out_hits) const;
+
+        /// \brief Calculates the distance at which one ray of a packet enters the bounding box of a node.
+        /// \param node The node to check.
+        /// \param packet The rays of the packet.
+        /// \param lane The ray to check.
+        /// \return The distance within [0, t_max] of the ray, infinity if it misses the bounding box.
+        /// \details Uses the inverse direction and signs of the packet, so it doesn't divide.
+        static double entry_distance(const bvh_node& node, const ray_packet& packet, std::size_t lane) noexcept;
+
+        /// \brief Check which rays of a packet hit the bounding box of a node.
+        /// \param node The node to check.
+        /// \param packet The rays to check.
+        /// \param mask The rays to check, bit i is ray i.
+        /// \return The rays of the mask that hit the bounding box of the node within [0, t_max].
+        static std::uint64_t intersects(const bvh_node& node, const ray_packet& packet, std::uint64_t mask) noexcept;
+
+        /// \brief Calculates the build primitives of the given shapes.
+        /// \param shapes The shapes to calculate the build primitives from.
+        /// \param threads The number of threads to use.
+        /// \return The build primitives, in the same order as the shapes.
+        static std::vector<build_primitive> make_build_primitives(const std::vector<std::shared_ptr<bardrix::shape>>& shapes,
+                                                                  std::size_t threads);
+
+        /// \brief Adds a leaf node for the given primitive to the output.
+        /// \param output The output to add the leaf to.
+        /// \param primitive The primitive to add.
+        static void push_leaf(build_output& output, const build_primitive& primitive);
+
+        /// \brief Appends a subtree to the output, the subtree becomes the right child of the last interior node.
+        /// \param output The output to append to.
+        /// \param subtree The subtree to append, its offsets are moved to after the output.
+        static void append(build_output& output, const build_output& subtree);
+
+        /// \brief Replaces the BVH tree with the given output.
+        /// \param shapes The shapes the BVH tree is built from.
+        /// \param output The constructed nodes and shape indices.
+        void finish(const std::vector<std::shared_ptr<bardrix::shape>>& shapes, build_output&& output);
 
         /// \brief Constructs a BVH tree from the given shapes, using the longest axis algorithm. \n
         ///        This function is a helper function for the public construct_longest_axis function.
-        /// \tparam Iterator Iterator must be of type std::shared_ptr<shape>::iterator, but can be derived from shape.
-        /// \param current The current node to construct the BVH tree from.
-        /// \param begin The beginning of the shapes to construct the BVH tree from.
-        /// \param end The end of the shapes to construct the BVH tree from.
-        template<typename Iterator, typename = std::enable_if_t<
-                std::is_base_of_v<bardrix::shape, typename std::iterator_traits<Iterator>::value_type::element_type> &&
-                std::is_same_v<std::shared_ptr<typename std::iterator_traits<Iterator>::value_type::element_type>, typename std::iterator_traits<Iterator>::value_type>>>
-        void construct_longest_axis(std::unique_ptr<bvh_tree::node>& current, const Iterator& begin, const Iterator& end);
-
-        /// \brief Gives all the shapes that intersect with the given ray, in the form of out_hits. \n
-        ///        This function is a helper function for the public intersect function.
-        /// \param current The current node to check for intersections with the ray.
-        /// \param ray The ray to check for intersections with the shapes.
-        /// \param out_hits The shapes that intersect with the given ray.
-        void intersections(const std::unique_ptr<node>& current, const bardrix::ray& ray,
-                           std::vector<const bardrix::shape*>& out_hits) const noexcept;
+        /// \param shapes The shapes to construct the BVH tree from.
+        /// \param threads The number of threads to use.
+        void construct_longest_axis(const std::vector<std::shared_ptr<bardrix::shape>>& shapes, std::size_t threads);
+
+        /// \brief Constructs a BVH subtree from the given sorted primitives, splitting them at the median. \n
+        ///        This function is called recursively.
+        /// \param output The output to add the subtree to.
+        /// \param begin The beginning of the primitives to construct the BVH tree from.
+        /// \param end The end of the primitives to construct the BVH tree from.
+        /// \param threads The number of threads to use.
+        static void construct_longest_axis(build_output& output, const build_primitive* begin,
+                                           const build_primitive* end, std::size_t threads);
+
+        /// \brief Constructs a BVH tree from the given shapes, using the surface area heuristic. \n
+        ///        This function is a helper function for the public construct_sah function.
+        /// \param shapes The shapes to construct the BVH tree from.
+        /// \param bins The number of bins used per axis to evaluate the split candidates.
+        /// \param threads The number of threads to use.
+        void construct_sah(const std::vector<std::shared_ptr<bardrix::shape>>& shapes, std::size_t bins,
+                           std::size_t threads);
+
+        /// \brief Constructs the nodes of a BVH tree from the given primitives, using the surface area heuristic.
+        /// \param primitives The primitives to construct the BVH tree from, they are reordered.
+        /// \param bins The number of bins used per axis to evaluate the split candidates.
+        /// \param threads The number of threads to use.
+        /// \return The nodes and the index of the primitive of every leaf.
+        static build_output build_sah(std::vector<build_primitive>& primitives, std::size_t bins, std::size_t threads);
+
+        /// \brief Turns every largest subtree of at most leaf_size primitives into one leaf.
+        /// \param output The nodes and primitive indices of a constructed BVH tree, the nodes are replaced.
+        /// \param leaf_size The maximum number of primitives in a leaf.
+        /// \details The primitives of a subtree are stored next to each other, so the leaf is a range of them. \n
+        ///          O(N) time complexity, where N is the number of nodes.
+        static void merge_leaves(build_output& output, std::size_t leaf_size);
+
+        /// \brief A bin of construct_sah, the number of primitives in it and the bounds of their bounding boxes.
+        /// \details Plain doubles instead of an optional bounding_box, an empty bin has a min of infinity and a max of -infinity.
+        struct sah_bin {
+            /// \brief The number of primitives whose center is in the bin.
+            std::size_t count;
+
+            /// \brief The minimum of the bounding boxes, per axis (x, y, z).
+            double min[3];
+
+            /// \brief The maximum of the bounding boxes, per axis (x, y, z).
+            double max[3];
+        };
+
+        /// \brief The bins and sweep costs of construct_sah, allocated once per thread and reused by every node.
+        struct sah_scratch {
+            /// \brief The bins of every axis, the bins of one axis are stored next to each other.
+            std::vector<sah_bin> bins;
+
+            /// \brief The cost of the right side of every split, per bin.
+            std::vector<double> right_cost;
+        };
+
+        /// \brief Constructs a BVH subtree from the given primitives, using the surface area heuristic. \n
+        ///        This function is called recursively, the primitives are partitioned in place.
+        /// \param output The output to add the subtree to.
+        /// \param begin The beginning of the primitives to construct the BVH tree from.
+        /// \param end The end of the primitives to construct the BVH tree from.
+        /// \param bins The number of bins used per axis to evaluate the split candidates.
+        /// \param depth The depth of the subtree.
+        /// \param threads The number of threads to use.
+        /// \param scratch The bins of the calling thread, 3 * bins bins and bins costs.
+        /// \details Only nodes of at least parallel_threshold primitives are divided into chunks, \n
+        ///          the other nodes don't allocate apart from the output.
+        static void construct_sah(build_output& output, build_primitive* begin, build_primitive* end,
+                                  std::size_t bins, std::size_t depth, std::size_t threads, sah_scratch& scratch);
+
+        /// \brief The Morton code of a build primitive, used while sorting the primitives.
+        struct morton_primitive {
+            /// \brief The Morton code of the center of the primitive.
+            std::uint64_t code;
+
+            /// \brief The index of the primitive.
+            std::uint32_t index;
+        };
+
+        /// \brief Calculates the Morton code of a point, by interleaving the bits of its quantized coordinates.
+        /// \param point The point to calculate the Morton code of.
+        /// \param bounds The bounds the point is quantized in.
+        /// \param bits The number of bits of the Morton code, 30 or 63.
+        /// \return The Morton code of the point, the x bit is the highest bit of every group of 3 bits.
+        static std::uint64_t morton_code(const bardrix::point3& point, const bardrix::bounding_box& bounds,
+                                         std::size_t bits) noexcept;
+
+        /// \brief Sorts the Morton codes with a least significant digit radix sort, 8 bits per pass.
+        /// \param codes The codes to sort, the sort is stable.
+        /// \param bits The number of bits of the Morton codes.
+        /// \param threads The number of threads to use.
+        static void radix_sort(std::vector<morton_primitive>& codes, std::size_t bits, std::size_t threads);
+
+        /// \brief Constructs a BVH tree from the given shapes, using Morton codes. \n
+        ///        This function is a helper function for the public construct_morton function.
+        /// \param shapes The shapes to construct the BVH tree from.
+        /// \param bits The number of bits of the Morton codes, 30 or 63.
+        /// \param threads The number of threads to use.
+        void construct_morton(const std::vector<std::shared_ptr<bardrix::shape>>& shapes, std::size_t bits,
+                              std::size_t threads);
+
+        /// \brief Constructs a BVH subtree from the given primitives, sorted on their Morton codes. \n
+        ///        This function is called recursively.
+        /// \param output The output to add the subtree to.
+        /// \param primitives The primitives to construct the BVH tree from.
+        /// \param codes The Morton code of every primitive.
+        /// \param count The number of primitives.
+        /// \param depth The depth of the subtree.
+        /// \param threads The number of threads to use.
+        static void construct_morton(build_output& output, const build_primitive* primitives,
+                                     const morton_primitive* codes, std::size_t count, std::size_t depth,
+                                     std::size_t threads);
+
+        /// \brief The minimum overlap of the children of an object split, relative to the area of the root, \n
+        ///        before construct_sbvh tries a spatial split.
+        static constexpr double sbvh_overlap_threshold = 1e-5;
+
+        /// \brief Constructs a BVH tree from the given shapes, using spatial splits. \n
+        ///        This function is a helper function for the public construct_sbvh function.
+        /// \param shapes The shapes to construct the BVH tree from.
+        /// \param budget The number of extra shape references that may be added, relative to the number of shapes.
+        /// \param bins The number of bins used per axis to evaluate the split candidates.
+        void construct_sbvh(const std::vector<std::shared_ptr<bardrix::shape>>& shapes, double budget, std::size_t bins);
+
+        /// \brief Constructs a BVH subtree from the given references, using object and spatial splits. \n
+        ///        This function is called recursively.
+        /// \param output The output to add the subtree to.
+        /// \param shapes The shapes to construct the BVH tree from, used to clip the shapes.
+        /// \param references The shape references, their bounding boxes are clipped to the node.
+        /// \param bins The number of bins used per axis to evaluate the split candidates.
+        /// \param depth The depth of the subtree.
+        /// \param root_area The surface area of the root.
+        /// \param budget The number of extra shape references that may still be added.
+        static void construct_sbvh(build_output& output, const std::vector<std::shared_ptr<bardrix::shape>>& shapes,
+                                   std::vector<build_primitive>&& references, std::size_t bins, std::size_t depth,
+                                   double root_area, std::size_t& budget);
+
+        /// \brief Check if a ray hits the bounding box of a node, the same way as bounding_box::intersects(ray).
+        /// \param node The node to check.
+        /// \param ray The ray to check.
+        /// \param inverse_direction The inverse of the direction of the ray (1 / direction).
+        /// \return The distance at which the ray enters the bounding box (negative if the ray starts inside), \n
+        ///         infinity if the ray doesn't hit the bounding box.
+        static double entry_distance(const bvh_node& node, const bardrix::ray& ray,
+                                     const bardrix::vector3& inverse_direction) noexcept;
+
+        /// \brief Check if a prepared ray hits the bounding box of a node within [ray.t_min, ray.t_max], \n
+        ///        the same way as bounding_box::intersects(traversal_ray).
+        /// \param node The node to check.
+        /// \param ray The ray to check.
+        /// \return The distance at which the ray enters the bounding box (at least ray.t_min), \n
+        ///         infinity if the ray doesn't hit the bounding box.
+        static double entry_distance(const bvh_node& node, const bardrix::traversal_ray& ray) noexcept;
+
+        /// \brief Gives the closest primitive hit by a ray in the given nodes, the nodes are visited front to back.
+        /// \tparam Intersect A callable (std::uint32_t primitive, const ray& ray) -> double, which gives the distance \n
+        ///                   to the hit of a leaf primitive within the length of the ray, infinity if there is no hit.
+        /// \param nodes The nodes, depth first, the root is the first node.
+        /// \param intersect Intersects a leaf primitive, the ray is shortened to the closest hit so far.
+        /// \param ray The ray to check.
+        /// \param out_primitive The closest primitive hit, only set if there is a hit.
+        /// \param out_distance The distance to the closest hit, only set if there is a hit.
+        /// \return True if a primitive is hit, false otherwise.
+        /// \details It doesn't allocate, this is the traversal of closest_hit, mapped_bvh, indexed_bvh, instanced_bvh \n
+        ///          and scene.
+        template<typename Intersect>
+        static bool closest_primitive(const bvh_node* nodes, const Intersect& intersect, const bardrix::ray& ray,
+                                      std::uint32_t& out_primitive, double& out_distance);
+
+        /// \brief Checks if any primitive in the given nodes is hit by a ray.
+        /// \tparam Intersects A callable (std::uint32_t primitive) -> bool, which checks if a leaf primitive is hit.
+        /// \param nodes The nodes, depth first, the root is the first node.
+        /// \param intersects Checks if a leaf primitive is hit.
+        /// \param ray The ray to check.
+        /// \return True if a primitive is hit, false otherwise.
+        /// \details It returns at the first hit found and doesn't allocate.
+        template<typename Intersects>
+        static bool any_primitive(const bvh_node* nodes, const Intersects& intersects, const bardrix::ray& ray);
+
+        /// \brief Gives the closest hit of a ray in the given nodes, this function is used by closest_hit and mapped_bvh.
+        /// \tparam Primitive A callable which gives the shape (const shape*) of a leaf primitive index.
+        /// \param nodes The nodes, depth first, the root is the first node.
+        /// \param primitive Gives the shape of a leaf primitive index.
+        /// \param ray The ray to check.
+        /// \return The closest hit, std::nullopt if no shape intersects with the ray.
+        template<typename Primitive>
+        static std::optional<bvh_hit> closest_hit(const bvh_node* nodes, const Primitive& primitive,
+                                                  const bardrix::ray& ray);
+
+        /// \brief Checks if any shape in the given nodes intersects with a ray, this function is used by occluded and mapped_bvh.
+        /// \tparam Primitive A callable which gives the shape (const shape*) of a leaf primitive index.
+        /// \param nodes The nodes, depth first, the root is the first node.
+        /// \param primitive Gives the shape of a leaf primitive index.
+        /// \param ray The ray to check.
+        /// \return True if a shape intersects with the ray, false otherwise.
+        template<typename Primitive>
+        static bool occluded(const bvh_node* nodes, const Primitive& primitive, const bardrix::ray& ray);
 
     }; // class bvh_tree
 
+    /// \brief Represents a BVH tree saved with bvh_tree::save, memory mapped from the file and traversed in place. \n
+    ///        Opening it checks the nodes once but doesn't copy them, the operating system loads the pages when used.
+    /// \details The shapes are referenced by index, the same shapes given to bvh_tree::save are given to every query.
+    /// \example bardrix::mapped_bvh bvh("scene.bvh"); \n
+    ///          std::optional<bardrix::bvh_hit> hit = bvh.closest_hit(ray, shapes);
+    /// \note It can be moved but not copied, the file is unmapped when it's destroyed.
+    class mapped_bvh {
+    private:
+        /// \brief The start of the mapped file, nullptr if no file is open.
+        const std::uint8_t* data_ = nullptr;
+
+        /// \brief The size of the mapped file in bytes.
+        std::size_t size_ = 0;
+
+        /// \brief The nodes in the mapped file, depth first, the root is the first node.
+        const bvh_node* nodes_ = nullptr;
+
+        /// \brief The number of nodes.
+        std::size_t node_count_ = 0;
+
+        /// \brief The shape index of every leaf primitive in the mapped file.
+        const std::uint32_t* indices_ = nullptr;
+
+        /// \brief The number of leaf primitives.
+        std::size_t primitive_count_ = 0;
+
+        /// \brief The largest shape index in the mapped file plus one, the queries need at least this many shapes.
+        std::size_t shape_count_ = 0;
+
+    public:
+        /// \brief Constructs a mapped BVH without a file.
+        explicit mapped_bvh() noexcept;
+
+        /// \brief Constructs a mapped BVH and opens the given file.
+        /// \param path The path of a file saved with bvh_tree::save.
+        /// \throws std::runtime_error If the file cannot be mapped, is not a BVH file of bvh_tree::file_version \n
+        ///                            or has a node with an offset, count or depth outside of the tree.
+        explicit mapped_bvh(const std::string& path);
+
+        mapped_bvh(const mapped_bvh&) = delete;
+
+        mapped_bvh& operator=(const mapped_bvh&) = delete;
+
+        mapped_bvh(mapped_bvh&& other) noexcept;
+
+        mapped_bvh& operator=(mapped_bvh&& other) noexcept;
+
+        ~mapped_bvh();
+
+        /// \brief Maps the given file, closing the file that was open.
+        /// \param path The path of a file saved with bvh_tree::save.
+        /// \example bvh.open("scene.bvh");
+        /// \details The nodes and shape indices are read once to check them, they are not copied.
+        /// \throws std::runtime_error If the file cannot be mapped, is not a BVH file of bvh_tree::file_version \n
+        ///                            or has a node with an offset, count or depth outside of the tree.
+        void open(const std::string& path);
+
+        /// \brief Unmaps the file, if a file is open.
+        void close() noexcept;
+
+        /// \brief Checks if a file is open.
+        /// \return True if a file is mapped, false otherwise.
+        NODISCARD bool is_open() const noexcept;
+
+        /// \brief Gives the closest shape that intersects with the given ray, the same as bvh_tree::closest_hit.
+        /// \param ray The ray to check for intersections with the shapes, only hits within ray.get_length() are considered.
+        /// \param shapes The shapes given to bvh_tree::save, in the same order.
+        /// \return The closest hit, std::nullopt if no shape intersects with the ray or no file is open.
+        /// \example std::optional<bardrix::bvh_hit> hit = bvh.closest_hit(ray, shapes);
+        /// \throws std::invalid_argument If the file references a shape index outside of shapes.
+        NODISCARD std::optional<bvh_hit> closest_hit(const bardrix::ray& ray,
+                                                     const std::vector<std::shared_ptr<bardrix::shape>>& shapes) const;
+
+        /// \brief Checks if any shape intersects with the given ray, the same as bvh_tree::occluded.
+        /// \param ray The ray to check for intersections with the shapes, only hits within ray.get_length() are considered.
+        /// \param shapes The shapes given to bvh_tree::save, in the same order.
+        /// \return True if a shape intersects with the ray, false otherwise or if no file is open.
+        /// \example bool in_shadow = bvh.occluded(shadow_ray, shapes);
+        /// \throws std::invalid_argument If the file references a shape index outside of shapes.
+        NODISCARD bool occluded(const bardrix::ray& ray,
+                                const std::vector<std::shared_ptr<bardrix::shape>>& shapes) const;
+
+        /// \brief Gets the nodes in the mapped file.
+        /// \return The nodes, depth first, the root is the first node, nullptr if no file is open.
+        NODISCARD const bvh_node* nodes() const noexcept;
+
+        /// \brief Gets the number of nodes in the mapped file.
+        /// \return The number of nodes.
+        NODISCARD std::size_t node_count() const noexcept;
+
+        /// \brief Gets the shape index of every leaf primitive in the mapped file, bvh_node::offset of a leaf indexes into this.
+        /// \return The shape indices, nullptr if no file is open.
+        NODISCARD const std::uint32_t* indices() const noexcept;
+
+        /// \brief Gets the number of leaf primitives in the mapped file.
+        /// \return The number of leaf primitives.
+        NODISCARD std::size_t primitive_count() const noexcept;
+
+    }; // class mapped_bvh
+
+    /// \brief Represents a bounding volume hierarchy (BVH) which owns its shapes by value, in one contiguous array. \n
+    ///        There are no shared pointers, the leaves are ranges of 32-bit indices into the array.
+    /// \tparam Shape The type of the shapes, derived from shape, e.g. sphere.
+    /// \details The shapes are stored in the order of the leaves, so the shapes of a leaf are next to each other in memory. \n
+    ///          indices() maps every shape back to its index in the shapes given to construct.
+    /// \example bardrix::indexed_bvh<bardrix::sphere> bvh; \n
+    ///          bvh.construct(spheres); \n
+    ///          std::optional<bardrix::bvh_hit> hit = bvh.closest_hit(ray);
+    template<typename Shape>
+    class indexed_bvh {
+    public:
+        static_assert(std::is_base_of_v<bardrix::shape, Shape>, "indexed_bvh only supports types derived from shape");
+
+        /// \brief The default maximum number of shapes in a leaf.
+        static constexpr std::size_t default_leaf_size = 4;
+
+    private:
+        /// \brief The nodes of the BVH, depth first, the root is the first node.
+        std::vector<bvh_node> nodes_;
+
+        /// \brief The shapes of the BVH, in the order of the leaves.
+        std::vector<Shape> shapes_;
+
+        /// \brief The index of every shape in the shapes given to construct.
+        std::vector<std::uint32_t> indices_;
+
+    public:
+        explicit indexed_bvh() = default;
+
+        /// \brief Constructs the BVH from the given shapes using the surface area heuristic, replacing the current BVH.
+        /// \param shapes The shapes to construct the BVH from, they are moved into the BVH.
+        /// \param leaf_size The maximum number of shapes in a leaf, every subtree of at most leaf_size shapes becomes \n
+        ///                  one leaf. Larger leaves mean fewer nodes, 1 gives the same nodes as bvh_tree::construct_sah.
+        /// \param bins The number of bins used per axis to evaluate the split candidates.
+        /// \param threads The number of threads to use, 0 uses all hardware threads.
+        /// \example bvh.construct(std::move(spheres));
+        /// \details O(N log N) time complexity, where N is the number of shapes, the same as bvh_tree::construct_sah.
+        /// \throws std::invalid_argument If there are more shapes than fit in a 32-bit index.
+        void construct(std::vector<Shape> shapes, std::size_t leaf_size = default_leaf_size,
+                       std::size_t bins = bvh_tree::default_sah_bins, std::size_t threads = 1);
+
+        /// \brief Gives the closest shape that intersects with the given ray, together with the distance to the intersection.
+        /// \param ray The ray to check for intersections with the shapes, only hits within ray.get_length() are considered.
+        /// \return The closest hit, std::nullopt if no shape intersects with the ray.
+        /// \example std::optional<bardrix::bvh_hit> hit = bvh.closest_hit(ray); \n
+        ///          if (hit) std::uint32_t index = bvh.index_of(hit->shape);
+        /// \details The same traversal as bvh_tree::closest_hit, it doesn't allocate.
+        NODISCARD std::optional<bvh_hit> closest_hit(const bardrix::ray& ray) const;
+
+        /// \brief Checks if any shape intersects with the given ray, e.g. a shadow ray towards a light.
+        /// \param ray The ray to check for intersections with the shapes, only hits within ray.get_length() are considered.
+        /// \return True if a shape intersects with the ray, false otherwise.
+        /// \example bool in_shadow = bvh.occluded(shadow_ray);
+        NODISCARD bool occluded(const bardrix::ray& ray) const;
+
+        /// \brief Gives the index of a shape of the BVH in the shapes given to construct.
+        /// \param shape A shape of the BVH, e.g. bvh_hit::shape.
+        /// \return The index of the shape in the shapes given to construct.
+        /// \note The shape must be a shape of this BVH.
+        NODISCARD std::uint32_t index_of(const bardrix::shape* shape) const noexcept;
+
+        /// \brief Gets the nodes of the BVH.
+        /// \return The nodes of the BVH, depth first, the root is the first node.
+        NODISCARD const std::vector<bvh_node>& nodes() const noexcept;
+
+        /// \brief Gets the shapes of the BVH.
+        /// \return The shapes of the BVH in the order of the leaves, bvh_node::offset and bvh_node::count of a leaf \n
+        ///         are the range of its shapes.
+        NODISCARD const std::vector<Shape>& shapes() const noexcept;
+
+        /// \brief Gets the index of every shape in the shapes given to construct.
+        /// \return The indices, in the order of shapes().
+        NODISCARD const std::vector<std::uint32_t>& indices() const noexcept;
+
+        /// \brief Checks if the BVH is empty.
+        /// \return True if the BVH has no nodes, false otherwise.
+        NODISCARD bool is_empty() const noexcept;
+
+        /// \brief Clears the BVH, removing all nodes and shapes.
+        void clear() noexcept;
+
+    }; // class indexed_bvh
+
+    /// \brief Represents a node of a wide bounding volume hierarchy, with the bounding boxes of its N children \n
+    ///        stored next to each other, so they can be tested in one SIMD step.
+    /// \tparam N The number of children, 4 or 8.
+    template<std::size_t N>
+    struct wide_bvh_node {
+        /// \brief The bounding boxes of the children, an unused child is empty.
+        bounding_box_pack<N> bounds;
+
+        /// \brief Interior child: the index of the child node. \n
+        ///        Leaf child: the index of the first primitive.
+        std::uint32_t child[N];
+
+        /// \brief The number of primitives of every child, 0 for interior children.
+        std::uint32_t count[N];
+
+    }; // struct wide_bvh_node
+
+    /// \brief Represents a wide bounding volume hierarchy (BVH4 or BVH8), collapsed from a binary bvh_tree.       \n
+    ///        Every node has up to N children, this halves (BVH4) or thirds (BVH8) the depth of the tree.
+    /// \tparam N The number of children per node, 4 or 8.
+    /// \example bardrix::bvh_tree tree; \n
+    ///          tree.construct_sah(shapes.begin(), shapes.end()); \n
+    ///          bardrix::wide_bvh<4> wide; \n
+    ///          wide.collapse(tree); \n
+    ///          std::optional<bardrix::bvh_hit> hit = wide.closest_hit(ray);
+    template<std::size_t N>
+    class wide_bvh {
+    public:
+        static_assert(N == 4 || N == 8, "wide_bvh only supports 4 or 8 children per node");
+
+    private:
+        /// \brief The nodes of the wide BVH, the root is the first node.
+        std::vector<wide_bvh_node<N>> nodes_;
+
+        /// \brief The shapes of the wide BVH, in the same order as the binary bvh_tree it was collapsed from.
+        std::vector<std::shared_ptr<bardrix::shape>> primitives_;
+
+    public:
+        explicit wide_bvh();
+
+        /// \brief Constructs the wide BVH from a binary bvh_tree.                                                   \n
+        ///        The children of a node are gathered by repeatedly opening the child with the largest surface area, \n
+        ///        until there are N children or every child is a leaf.
+        /// \param tree The binary BVH tree to collapse.
+        /// \example wide.collapse(tree);
+        /// \details O(N) time complexity, where N is the number of nodes in the binary BVH tree.
+        /// \note The wide BVH doesn't follow changes of the binary BVH tree, collapse it again after a rebuild or refit.
+        void collapse(const bvh_tree& tree);
+
+        /// \brief Gives the closest shape that intersects with the given ray, together with the distance to the intersection.
+        /// \param ray The ray to check for intersections with the shapes, only hits within ray.get_length() are considered.
+        /// \return The closest hit, std::nullopt if no shape intersects with the ray.
+        /// \example std::optional<bardrix::bvh_hit> hit = wide.closest_hit(ray);
+        /// \details The children of a node are tested in one SIMD step and visited front to back, \n
+        ///          every hit shortens the ray. It doesn't allocate.
+        NODISCARD std::optional<bvh_hit> closest_hit(const bardrix::ray& ray) const;
+
+        /// \brief Checks if any shape intersects with the given ray, e.g. a shadow ray towards a light.
+        /// \param ray The ray to check for intersections with the shapes, only hits within ray.get_length() are considered.
+        /// \return True if a shape intersects with the ray, false otherwise.
+        /// \example bool in_shadow = wide.occluded(shadow_ray);
+        /// \details The children of a node are tested in one SIMD step, it returns at the first hit found and doesn't allocate.
+        NODISCARD bool occluded(const bardrix::ray& ray) const;
+
+        /// \brief Gets the nodes of the wide BVH.
+        /// \return The nodes of the wide BVH, the root is the first node.
+        NODISCARD const std::vector<wide_bvh_node<N>>& nodes() const noexcept;
+
+        /// \brief Gets the shapes of the wide BVH.
+        /// \return The shapes of the wide BVH, wide_bvh_node::child and wide_bvh_node::count of a leaf index into this.
+        NODISCARD const std::vector<std::shared_ptr<bardrix::shape>>& primitives() const noexcept;
+
+        /// \brief Checks if the wide BVH is empty.
+        /// \return True if the wide BVH has no nodes, false otherwise.
+        NODISCARD bool is_empty() const noexcept;
+
+        /// \brief Clears the wide BVH, removing all nodes and shapes.
+        void clear() noexcept;
+
+    private:
+        /// \brief Collapses the subtree of a binary node into a wide node, this function is called recursively.
+        /// \param tree The binary BVH tree to collapse.
+        /// \param index The index of the binary node.
+        /// \return The index of the wide node.
+        std::uint32_t collapse(const bvh_tree& tree, std::uint32_t index);
+
+    }; // class wide_bvh
+
+    /// \brief A wide BVH with 4 children per node.
+    using bvh4 = wide_bvh<4>;
+
+    /// \brief A wide BVH with 8 children per node.
+    using bvh8 = wide_bvh<8>;
+
+    /// \brief Represents one placement of a shared BVH tree, rotated and then translated into the world.
+    /// \details Many instances can share one bottom level bvh_tree, the shapes are not copied.
+    /// \example auto tree = std::make_shared<bardrix::bvh_tree>(); \n
+    ///          tree->construct_sah(shapes.begin(), shapes.end()); \n
+    ///          bardrix::bvh_instance instance(tree, bardrix::quaternion::rotation_degrees(bardrix::vector3(0, 1, 0), 90), \n
+    ///                                         bardrix::vector3(10, 0, 0));
+    struct bvh_instance {
+        /// \brief The shared bottom level BVH tree, in instance space.
+        std::shared_ptr<const bvh_tree> tree;
+
+        /// \brief The rotation from instance space to world space, it must be a unit quaternion (the constructor normalizes it).
+        bardrix::quaternion rotation;
+
+        /// \brief The translation from instance space to world space, applied after the rotation.
+        bardrix::vector3 translation;
+
+        /// \brief Constructs an instance of a BVH tree.
+        /// \param tree The shared bottom level BVH tree.
+        /// \param rotation The rotation from instance space to world space, e.g. from quaternion::rotation_degrees, \n
+        ///                 it's normalized, so it becomes a unit quaternion.
+        /// \param translation The translation from instance space to world space.
+        /// \throws std::invalid_argument If the rotation has a length of 0 (or isn't finite), it can't be normalized.
+        explicit bvh_instance(std::shared_ptr<const bvh_tree> tree,
+                              const bardrix::quaternion& rotation = bardrix::quaternion::identity(),
+                              const bardrix::vector3& translation = bardrix::vector3(0, 0, 0));
+
+        /// \brief Transforms a point from instance space to world space.
+        /// \param point The point in instance space.
+        /// \return The point in world space.
+        NODISCARD bardrix::point3 to_world(const bardrix::point3& point) const noexcept;
+
+        /// \brief Transforms a vector (e.g. a normal) from instance space to world space, only rotating it.
+        /// \param vector The vector in instance space.
+        /// \return The vector in world space.
+        NODISCARD bardrix::vector3 to_world(const bardrix::vector3& vector) const noexcept;
+
+        /// \brief Transforms a ray from world space to instance space.
+        /// \param ray The ray in world space.
+        /// \return The ray in instance space, with the same length, distances along the ray stay the same.
+        NODISCARD bardrix::ray to_instance(const bardrix::ray& ray) const noexcept;
+
+        /// \brief Calculates the bounding box of the instance in world space.
+        /// \return The bounding box around the rotated and translated bounding box of the root of the tree.
+        /// \note The tree must not be empty.
+        NODISCARD bardrix::bounding_box bounding_box() const;
+
+    }; // struct bvh_instance
+
+    /// \brief The closest hit of a ray in an instanced_bvh.
+    struct instance_hit {
+        /// \brief The index of the hit instance in instanced_bvh::instances().
+        std::uint32_t instance;
+
+        /// \brief The hit shape, in the instance space of the instance.
+        const bardrix::shape* shape;
+
+        /// \brief The distance from the origin of the ray to the intersection, the same in world and instance space.
+        double distance;
+
+    }; // struct instance_hit
+
+    /// \brief Represents a two level bounding volume hierarchy, a top level BVH over instances of shared \n
+    ///        bottom level BVH trees. Memory grows with the number of shapes plus the number of instances.
+    /// \details Rays are transformed into the instance space of every instance they reach and traced through its tree.
+    /// \example bardrix::instanced_bvh scene; \n
+    ///          scene.construct(instances); \n
+    ///          std::optional<bardrix::instance_hit> hit = scene.closest_hit(ray); \n
+    ///          if (hit) { \n
+    ///              const bardrix::bvh_instance& instance = scene.instances()[hit->instance]; \n
+    ///              bardrix::point3 point = ray.point_at(hit->distance); \n
+    ///              bardrix::vector3 normal = instance.to_world(hit->shape->normal_at(instance.to_instance(ray).point_at(hit->distance))); \n
+    ///          }
+    class instanced_bvh {
+    private:
+        /// \brief The nodes of the top level BVH, depth first, the root is the first node.
+        std::vector<bvh_node> nodes_;
+
+        /// \brief The instances, in the order they were given.
+        std::vector<bvh_instance> instances_;
+
+        /// \brief The index of the instance of every leaf, bvh_node::offset of a leaf indexes into this.
+        std::vector<std::uint32_t> indices_;
+
+    public:
+        explicit instanced_bvh();
+
+        /// \brief Constructs the top level BVH over the given instances, using the surface area heuristic.
+        /// \param instances The instances, instances with an empty tree are ignored.
+        /// \param threads The number of threads used to construct the BVH, 0 uses all hardware threads.
+        /// \example scene.construct(instances); // e.g. every frame, the bottom level trees are kept
+        /// \details O(N log N) time complexity, where N is the number of instances.
+        void construct(std::vector<bvh_instance> instances, std::size_t threads = 1);
+
+        /// \brief Gives the closest shape of all instances that intersects with the given ray.
+        /// \param ray The ray in world space, only hits within ray.get_length() are considered.
+        /// \return The closest hit, std::nullopt if no shape intersects with the ray.
+        /// \example std::optional<bardrix::instance_hit> hit = scene.closest_hit(ray);
+        /// \details The instances are visited front to back, every hit shortens the ray.
+        NODISCARD std::optional<instance_hit> closest_hit(const bardrix::ray& ray) const;
+
+        /// \brief Checks if any shape of any instance intersects with the given ray, e.g. a shadow ray towards a light.
+        /// \param ray The ray in world space, only hits within ray.get_length() are considered.
+        /// \return True if a shape intersects with the ray, false otherwise.
+        /// \example bool in_shadow = scene.occluded(shadow_ray);
+        NODISCARD bool occluded(const bardrix::ray& ray) const;
+
+        /// \brief Gets the nodes of the top level BVH.
+        /// \return The nodes of the top level BVH, depth first, the root is the first node.
+        NODISCARD const std::vector<bvh_node>& nodes() const noexcept;
+
+        /// \brief Gets the instances.
+        /// \return The instances, in the order they were given to construct.
+        NODISCARD const std::vector<bvh_instance>& instances() const noexcept;
+
+        /// \brief Checks if the instanced BVH is empty.
+        /// \return True if the top level BVH has no nodes, false otherwise.
+        NODISCARD bool is_empty() const noexcept;
+
+        /// \brief Clears the instanced BVH, removing all nodes and instances.
+        void clear() noexcept;
+
+    }; // class instanced_bvh
+
     // binary_tree implementation start
 
     template<typename T>
@@ -800,62 +1772,247 @@ namespace bardrix {
     // bvh_tree implementation start
 
     template<typename Iterator, typename>
-    void bvh_tree::construct_longest_axis(const Iterator& begin, const Iterator& end) {
+    void bvh_tree::construct_longest_axis(const Iterator& begin, const Iterator& end, std::size_t threads) {
         clear();
         if (begin >= end) return;
 
+        construct_longest_axis(std::vector<std::shared_ptr<bardrix::shape>>(begin, end), thread_count(threads));
+    }
 
-        // Calculate the bounding box that encompasses all shapes
-        bardrix::bounding_box box = (*begin)->bounding_box();
-        for (auto it = std::next(begin); it != end; ++it)
-            box = box.merge((*it)->bounding_box());
+    template<typename Shape, typename>
+    void bvh_tree::construct_longest_axis(std::shared_ptr<Shape>* shapes, std::size_t size,
+                                          std::size_t threads) noexcept {
+        construct_longest_axis(shapes, shapes + size, threads);
+    }
 
-        // Calculate the longest axis
-        axis longest_axis = box.longest_axis();
+    template<typename Iterator, typename>
+    void bvh_tree::construct_sah(const Iterator& begin, const Iterator& end, std::size_t bins, std::size_t threads) {
+        clear();
+        if (begin >= end) return;
 
-        // Sort the shapes based on their centers along the longest axis
-        std::vector<std::shared_ptr<bardrix::shape>> sorted_shapes(begin, end);
-        std::sort(sorted_shapes.begin(), sorted_shapes.end(),
-                  [longest_axis](const auto& a, const auto& b) {
-                      return longest_axis_predicate(a, b, longest_axis);
-                  });
+        construct_sah(std::vector<std::shared_ptr<bardrix::shape>>(begin, end), bins, thread_count(threads));
+    }
 
-        // Build the BVH tree from the sorted shapes
-        construct_longest_axis(root, sorted_shapes.begin(), sorted_shapes.end());
+    template<typename Shape, typename>
+    void bvh_tree::construct_sah(std::shared_ptr<Shape>* shapes, std::size_t size, std::size_t bins,
+                                 std::size_t threads) noexcept {
+        construct_sah(shapes, shapes + size, bins, threads);
     }
 
-    // helper function for construct_longest_axis
     template<typename Iterator, typename>
-    void bvh_tree::construct_longest_axis(std::unique_ptr<bvh_tree::node>& current, const Iterator& begin, const Iterator& end) {
-        if (begin >= end) {
-            current = nullptr;
-            return;
-        }
+    void bvh_tree::construct_morton(const Iterator& begin, const Iterator& end, std::size_t bits, std::size_t threads) {
+        clear();
+        if (begin >= end) return;
 
-        // If there is only one shape, we make a node with the shape
-        if (std::next(begin) == end) {
-            current = std::make_unique<node>(bvh_data(*begin));
-            return;
-        }
+        construct_morton(std::vector<std::shared_ptr<bardrix::shape>>(begin, end), bits <= 30 ? 30 : 63,
+                         thread_count(threads));
+    }
 
-        // Merge all the bounding boxes to create a bounding box that encompasses all the shapes
-        bardrix::bounding_box box = (*begin)->bounding_box();
-        for (auto it = std::next(begin); it != end; ++it)
-            box = box.merge((*it)->bounding_box());
+    template<typename Shape, typename>
+    void bvh_tree::construct_morton(std::shared_ptr<Shape>* shapes, std::size_t size, std::size_t bits,
+                                    std::size_t threads) noexcept {
+        construct_morton(shapes, shapes + size, bits, threads);
+    }
 
-        // Create a new node with the bounding box
-        current = std::make_unique<node>(bvh_data(box));
+    template<typename Iterator, typename>
+    void bvh_tree::construct_sbvh(const Iterator& begin, const Iterator& end, double budget, std::size_t bins) {
+        clear();
+        if (begin >= end) return;
 
-        auto middle = begin + std::distance(begin, end) / 2;
-        construct_longest_axis(current->left, begin, middle);
-        construct_longest_axis(current->right, middle, end);
+        construct_sbvh(std::vector<std::shared_ptr<bardrix::shape>>(begin, end), budget, bins);
     }
 
     template<typename Shape, typename>
-    void bvh_tree::construct_longest_axis(std::shared_ptr<Shape>* shapes, std::size_t size) noexcept {
-        construct_longest_axis(shapes, shapes + size);
+    void bvh_tree::construct_sbvh(std::shared_ptr<Shape>* shapes, std::size_t size, double budget,
+                                  std::size_t bins) noexcept {
+        construct_sbvh(shapes, shapes + size, budget, bins);
+    }
+
+    template<typename Intersect>
+    bool bvh_tree::closest_primitive(const bvh_node* nodes, const Intersect& intersect, const bardrix::ray& ray,
+                                     std::uint32_t& out_primitive, double& out_distance) {
+        // The ray is shortened to the closest hit so far, nodes and primitives beyond it are skipped
+        bardrix::ray query = ray;
+        bardrix::traversal_ray traversal(ray);
+        bool found = false;
+
+        // Every node on the stack has been hit, together with the distance at which it was entered
+        std::uint32_t stack[max_depth];
+        double stack_distance[max_depth];
+        std::size_t stack_size = 0;
+
+        const double root_distance = entry_distance(nodes[0], traversal);
+        if (root_distance == std::numeric_limits<double>::infinity()) return false;
+
+        stack[stack_size] = 0;
+        stack_distance[stack_size++] = root_distance;
+
+        while (stack_size > 0) {
+            --stack_size;
+
+            // A closer hit may have been found since the node was pushed
+            if (stack_distance[stack_size] > traversal.t_max) continue;
+
+            const bvh_node& node = nodes[stack[stack_size]];
+
+            if (node.is_leaf()) {
+                for (std::uint32_t i = 0; i < node.count; ++i) {
+                    const double distance = intersect(node.offset + i, query);
+                    if (distance == std::numeric_limits<double>::infinity()) continue;
+                    if (found && distance >= out_distance) continue;
+
+                    found = true;
+                    out_primitive = node.offset + i;
+                    out_distance = distance;
+                    query.set_length(distance);
+                    traversal.t_max = distance;
+                }
+                continue;
+            }
+
+            const std::uint32_t left = static_cast<std::uint32_t>(&node - nodes) + 1;
+            const std::uint32_t right = node.offset;
+            const double left_distance = entry_distance(nodes[left], traversal);
+            const double right_distance = entry_distance(nodes[right], traversal);
+
+            // Push the farthest child first, so the nearest child is visited first
+            const bool left_first = left_distance <= right_distance;
+            const std::uint32_t near = left_first ? left : right;
+            const std::uint32_t far = left_first ? right : left;
+            const double near_distance = left_first ? left_distance : right_distance;
+            const double far_distance = left_first ? right_distance : left_distance;
+
+            if (far_distance != std::numeric_limits<double>::infinity()) {
+                stack[stack_size] = far;
+                stack_distance[stack_size++] = far_distance;
+            }
+            if (near_distance != std::numeric_limits<double>::infinity()) {
+                stack[stack_size] = near;
+                stack_distance[stack_size++] = near_distance;
+            }
+        }
+
+        return found;
+    }
+
+    template<typename Primitive>
+    std::optional<bvh_hit> bvh_tree::closest_hit(const bvh_node* nodes, const Primitive& primitive,
+                                                 const bardrix::ray& ray) {
+        const auto intersect = [&primitive](std::uint32_t index, const bardrix::ray& query) {
+            return primitive(index)->intersect_distance(query);
+        };
+
+        std::uint32_t index;
+        double distance;
+        if (!closest_primitive(nodes, intersect, ray, index, distance)) return std::nullopt;
+
+        return bvh_hit{ primitive(index), distance };
+    }
+
+    template<typename Intersects>
+    bool bvh_tree::any_primitive(const bvh_node* nodes, const Intersects& intersects, const bardrix::ray& ray) {
+        const bardrix::traversal_ray traversal(ray);
+
+        std::uint32_t stack[max_depth];
+        std::size_t stack_size = 0;
+        stack[stack_size++] = 0;
+
+        while (stack_size > 0) {
+            const bvh_node& node = nodes[stack[--stack_size]];
+            if (entry_distance(node, traversal) == std::numeric_limits<double>::infinity()) continue;
+
+            if (node.is_leaf()) {
+                // Any hit will do, there is no need to find the closest one
+                for (std::uint32_t i = 0; i < node.count; ++i)
+                    if (intersects(node.offset + i)) return true;
+                continue;
+            }
+
+            stack[stack_size++] = node.offset;
+            stack[stack_size++] = static_cast<std::uint32_t>(&node - nodes) + 1;
+        }
+
+        return false;
+    }
+
+    template<typename Primitive>
+    bool bvh_tree::occluded(const bvh_node* nodes, const Primitive& primitive, const bardrix::ray& ray) {
+        return any_primitive(nodes, [&](std::uint32_t index) {
+                                 return primitive(index)->intersect_distance(ray) != std::numeric_limits<double>::infinity();
+                             },
+                             ray);
     }
 
     // bvh_tree implementation end
 
+    // indexed_bvh implementation start
+
+    template<typename Shape>
+    void indexed_bvh<Shape>::construct(std::vector<Shape> shapes, std::size_t leaf_size, std::size_t bins,
+                                       std::size_t threads) {
+        clear();
+        if (shapes.empty()) return;
+        if (shapes.size() > std::numeric_limits<std::uint32_t>::max())
+            throw std::invalid_argument("Too many shapes for 32-bit indices");
+
+        std::vector<bvh_tree::build_primitive> primitives;
+        primitives.reserve(shapes.size());
+        for (std::size_t i = 0; i < shapes.size(); ++i) {
+            bardrix::bounding_box box = shapes[i].bounding_box();
+            bardrix::point3 center = box.center();
+            primitives.push_back({ std::move(box), std::move(center), static_cast<std::uint32_t>(i) });
+        }
+
+        bvh_tree::build_output output = bvh_tree::build_sah(primitives, bins, bvh_tree::thread_count(threads));
+        bvh_tree::merge_leaves(output, std::max<std::size_t>(leaf_size, 1));
+
+        // Every shape is in exactly one leaf, so it's moved once
+        shapes_.reserve(shapes.size());
+        for (const std::uint32_t index: output.indices)
+            shapes_.push_back(std::move(shapes[index]));
+
+        nodes_ = std::move(output.nodes);
+        indices_ = std::move(output.indices);
+    }
+
+    template<typename Shape>
+    std::optional<bvh_hit> indexed_bvh<Shape>::closest_hit(const bardrix::ray& ray) const {
+        if (nodes_.empty()) return std::nullopt;
+
+        return bvh_tree::closest_hit(nodes_.data(), [this](std::uint32_t index) { return &shapes_[index]; }, ray);
+    }
+
+    template<typename Shape>
+    bool indexed_bvh<Shape>::occluded(const bardrix::ray& ray) const {
+        if (nodes_.empty()) return false;
+
+        return bvh_tree::occluded(nodes_.data(), [this](std::uint32_t index) { return &shapes_[index]; }, ray);
+    }
+
+    template<typename Shape>
+    std::uint32_t indexed_bvh<Shape>::index_of(const bardrix::shape* shape) const noexcept {
+        return indices_[static_cast<const Shape*>(shape) - shapes_.data()];
+    }
+
+    template<typename Shape>
+    const std::vector<bvh_node>& indexed_bvh<Shape>::nodes() const noexcept { return nodes_; }
+
+    template<typename Shape>
+    const std::vector<Shape>& indexed_bvh<Shape>::shapes() const noexcept { return shapes_; }
+
+    template<typename Shape>
+    const std::vector<std::uint32_t>& indexed_bvh<Shape>::indices() const noexcept { return indices_; }
+
+    template<typename Shape>
+    bool indexed_bvh<Shape>::is_empty() const noexcept { return nodes_.empty(); }
+
+    template<typename Shape>
+    void indexed_bvh<Shape>::clear() noexcept {
+        nodes_.clear();
+        shapes_.clear();
+        indices_.clear();
+    }
+
+    // indexed_bvh implementation end
+
 } // namespace bardrix
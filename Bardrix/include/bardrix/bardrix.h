@@ -11,9 +11,15 @@
 #include <utility>
 #include <optional>
 #include <climits>
+#include <limits>
+#include <vector>
 #include <algorithm>
 #include <memory>
 #include <functional>
+#include <future>
+#include <thread>
+#include <string>
+#include <stdexcept>
 
 // C++20 feature
 #if __cplusplus > 201703L
@@ -27,6 +33,42 @@
 #define NODISCARD [[nodiscard]]
 #define INLINE inline
 
+// The widest instruction set enabled by the compiler is used, e.g. -mavx or /arch:AVX (see BARDRIX_AVX in CMake).
+// The CMake target defines BARDRIX_AVX as 1 or 0, the inline SIMD code has to use the same registers as the library,
+// so without AVX in the library it isn't used, and with AVX in the library every user has to enable it
+#if defined(BARDRIX_AVX) && BARDRIX_AVX && !defined(__AVX__)
+#error "Bardrix is built with AVX (BARDRIX_AVX), compile with AVX as well (-mavx or /arch:AVX)"
+#endif
+
+#if defined(__AVX__) && (!defined(BARDRIX_AVX) || BARDRIX_AVX)
+#define BARDRIX_SIMD_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BARDRIX_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+// True when a constexpr function is evaluated at compile time, the SIMD paths are skipped then (C++20 or a builtin)
+#if defined(__cpp_lib_is_constant_evaluated)
+#define BARDRIX_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#elif (defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#define BARDRIX_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#elif defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define BARDRIX_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+#endif
+
+// True when the constexpr functions may use lanes4, which can't be evaluated at compile time.
+// Without BARDRIX_CONSTANT_EVALUATED they always use the scalar code, the results are the same but not computed with SIMD
+#ifdef BARDRIX_CONSTANT_EVALUATED
+#define BARDRIX_USE_LANES() (!BARDRIX_CONSTANT_EVALUATED())
+#else
+#pragma message("Bardrix: is_constant_evaluated isn't supported, the constexpr math functions don't use lanes4 (SIMD)")
+#define BARDRIX_CONSTANT_EVALUATED() false
+#define BARDRIX_USE_LANES() false
+#endif
+
 namespace bardrix {
     enum class axis : std::uint8_t {
         none    = 0x00, // No axis
@@ -125,6 +125,17 @@ namespace bardrix {
         /// \details If the x or y is less than 0, it will return an empty optional
         NODISCARD std::optional<bardrix::ray> shoot_ray(int x, int y, double distance) const noexcept;
 
+        /// \brief Shoots the rays of a block of pixels from the camera to the screen, e.g. for bvh_tree::closest_hits
+        /// \param x The x position of the top left pixel of the block
+        /// \param y The y position of the top left pixel of the block
+        /// \param width The width of the block, e.g. 4 or 8
+        /// \param height The height of the block, e.g. 4 or 8
+        /// \param distance The length of the rays
+        /// \param out_rays The rays of the block, row by row, the vector is cleared first
+        /// \details Pixels outside the screen are skipped, like shoot_ray
+        /// \example std::vector<bardrix::ray> rays; camera.shoot_rays(0, 0, 8, 8, 100, rays); // 64 rays
+        void shoot_rays(int x, int y, int width, int height, double distance, std::vector<bardrix::ray>& out_rays) const;
+
         /// \brief Looks at a point from the camera
         /// \param point The point to look at
         /// \details If the point is the same as the position, it will not change the direction
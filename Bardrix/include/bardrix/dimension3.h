@@ -5,13 +5,18 @@
 #pragma once
 
 #include <bardrix/bardrix.h>
+#include <bardrix/lanes.h>
 
 namespace bardrix {
 
     /// \brief Abstract class to represent 3 dimensions
+    /// \tparam V The type of the values, float or double
     /// \note This class is not meant to be used directly, but to be inherited by other classes
-    /// \details This class implements the basic operations for 3 dimensions (+, +=, -, -=, *, *=, /, /=, %, %=, ==, !=, <, >, <=, >=, -, ++, --, <<)
-    class dimension3 {
+    /// \details This class implements the basic operations for 3 dimensions (+, +=, -, -=, *, *=, /, /=, %, %=, ==, !=, <, >, <=, >=, -, ++, --, <<) \n
+    ///          With double values the arithmetic, min and max use lanes4 (x, y, z padded to 4 lanes), so they are SIMD
+    template<typename V>
+    class basic_dimension3 {
+        static_assert(std::is_floating_point_v<V>, "basic_dimension3 only supports floating point values");
 
     public:
         /// \brief A template to check if a type is a derived class of dimension3
@@ -22,10 +27,13 @@ namespace bardrix {
         ///          Add<std::string>("hello") -> error \n
         ///          Add<point3>({}) -> ok
         template<typename T, typename Result>
-        using enable_if_dimension3 = std::enable_if_t<std::is_base_of_v<dimension3, T>, Result>;
+        using enable_if_dimension3 = std::enable_if_t<std::is_base_of_v<basic_dimension3, T>, Result>;
+
+        /// \brief The type of the values
+        using value_type = V;
 
     public:
-        double x{}, y{}, z{};
+        V x{}, y{}, z{};
 
         /// \brief Takes the minimum of each dimension of two dimension3 (T result = min(dim3, dim3))
         /// \tparam T Type of the dimension3, must be a derived class of dimension3
@@ -33,8 +41,14 @@ namespace bardrix {
         /// \return A copy of the dimension3 with the minimum of each dimension
         /// \example point3 min_point = point3(1, 2, 3).min(point3(2, 1, 4)); // min_point = (1, 1, 3)
         template<typename T>
-        NODISCARD auto min(const T& dimension3) const noexcept -> enable_if_dimension3<T, T> {
+        NODISCARD constexpr auto min(const T& dimension3) const noexcept -> enable_if_dimension3<T, T> {
             T result = dimension3;
+            if constexpr (std::is_same_v<V, double>) {
+                if (BARDRIX_USE_LANES()) {
+                    result.set_lanes(lanes4::min(dimension3.lanes(), lanes()));
+                    return result;
+                }
+            }
             result.x = std::min(x, result.x);
             result.y = std::min(y, result.y);
             result.z = std::min(z, result.z);
@@ -47,8 +61,14 @@ namespace bardrix {
         /// \return A copy of the dimension3 with the maximum of each dimension
         /// \example point3 max_point = point3(1, 2, 3).max(point3(2, 1, 4)); // max_point = (2, 2, 4)
         template<typename T>
-        NODISCARD auto max(const T& dimension3) const noexcept -> enable_if_dimension3<T, T> {
+        NODISCARD constexpr auto max(const T& dimension3) const noexcept -> enable_if_dimension3<T, T> {
             T result = dimension3;
+            if constexpr (std::is_same_v<V, double>) {
+                if (BARDRIX_USE_LANES()) {
+                    result.set_lanes(lanes4::max(dimension3.lanes(), lanes()));
+                    return result;
+                }
+            }
             result.x = std::max(x, result.x);
             result.y = std::max(y, result.y);
             result.z = std::max(z, result.z);
@@ -67,7 +87,7 @@ namespace bardrix {
         /// \param dimension3_rhs Dimension3 to add
         /// \return A copy of the dimension3 with the result of the addition
         template<typename T>
-        NODISCARD friend auto operator+(const T& dimension3_lhs, const T& dimension3_rhs) noexcept -> enable_if_dimension3<T, T> {
+        NODISCARD friend constexpr auto operator+(const T& dimension3_lhs, const T& dimension3_rhs) noexcept -> enable_if_dimension3<T, T> {
             T result = dimension3_lhs;
             result += dimension3_rhs;
             return result;
@@ -79,7 +99,7 @@ namespace bardrix {
         /// \param dimension3 Dimension3 to add
         /// \return A copy of the dimension3 with the result of the addition
         template<typename T>
-        NODISCARD friend auto operator+(double n, const T& dimension3) noexcept -> enable_if_dimension3<T, T> {
+        NODISCARD friend constexpr auto operator+(V n, const T& dimension3) noexcept -> enable_if_dimension3<T, T> {
             return dimension3 + n;
         }
 
@@ -89,7 +109,7 @@ namespace bardrix {
         /// \param n Value to add
         /// \return A copy of the dimension3 with the result of the addition
         template<typename T>
-        NODISCARD friend auto operator+(const T& dimension3, double n) noexcept -> enable_if_dimension3<T, T> {
+        NODISCARD friend constexpr auto operator+(const T& dimension3, V n) noexcept -> enable_if_dimension3<T, T> {
             T result = dimension3;
             result += n;
             return result;
@@ -101,7 +121,13 @@ namespace bardrix {
         /// \param dimension3_rhs Dimension3 to add
         /// \return A reference to the dimension3 with the result of the addition
         template<typename T>
-        friend auto operator+=(T& dimension3_lhs, const T& dimension3_rhs) noexcept -> enable_if_dimension3<T, const T&> {
+        friend constexpr auto operator+=(T& dimension3_lhs, const T& dimension3_rhs) noexcept -> enable_if_dimension3<T, const T&> {
+            if constexpr (std::is_same_v<V, double>) {
+                if (BARDRIX_USE_LANES()) {
+                    dimension3_lhs.set_lanes(dimension3_lhs.lanes() + dimension3_rhs.lanes());
+                    return dimension3_lhs;
+                }
+            }
             dimension3_lhs.x += dimension3_rhs.x;
             dimension3_lhs.y += dimension3_rhs.y;
             dimension3_lhs.z += dimension3_rhs.z;
@@ -114,7 +140,13 @@ namespace bardrix {
         /// \param n Value to add
         /// \return A reference to the dimension3 with the result of the addition
         template<typename T>
-        friend auto operator+=(T& dimension3, double n) noexcept -> enable_if_dimension3<T, const T&> {
+        friend constexpr auto operator+=(T& dimension3, V n) noexcept -> enable_if_dimension3<T, const T&> {
+            if constexpr (std::is_same_v<V, double>) {
+                if (BARDRIX_USE_LANES()) {
+                    dimension3.set_lanes(dimension3.lanes() + lanes4::broadcast(n));
+                    return dimension3;
+                }
+            }
             dimension3.x += n;
             dimension3.y += n;
             dimension3.z += n;
@@ -127,7 +159,7 @@ namespace bardrix {
         /// \param dimension3_rhs Dimension3 to subtract
         /// \return A copy of the dimension3 with the result of the subtraction
         template<typename T>
-        NODISCARD friend auto operator-(const T& dimension3_lhs, const T& dimension3_rhs) noexcept -> enable_if_dimension3<T, T> {
+        NODISCARD friend constexpr auto operator-(const T& dimension3_lhs, const T& dimension3_rhs) noexcept -> enable_if_dimension3<T, T> {
             T result = dimension3_lhs;
             result -= dimension3_rhs;
             return result;
@@ -139,7 +171,7 @@ namespace bardrix {
         /// \param dimension3 Dimension3 to subtract
         /// \return A copy of the dimension3 with the result of the subtraction
         template<typename T>
-        NODISCARD friend auto operator-(double n, const T& dimension3) noexcept -> enable_if_dimension3<T, T> {
+        NODISCARD friend constexpr auto operator-(V n, const T& dimension3) noexcept -> enable_if_dimension3<T, T> {
             T result = dimension3;
             result.x = n - dimension3.x;
             result.y = n - dimension3.y;
@@ -153,7 +185,7 @@ namespace bardrix {
         /// \param n Value to subtract
         /// \return A copy of the dimension3 with the result of the subtraction
         template<typename T>
-        NODISCARD friend auto operator-(const T& dimension3, double n) noexcept -> enable_if_dimension3<T, T> {
+        NODISCARD friend constexpr auto operator-(const T& dimension3, V n) noexcept -> enable_if_dimension3<T, T> {
             T result = dimension3;
             result -= n;
             return result;
@@ -165,7 +197,13 @@ namespace bardrix {
         /// \param dimension3_rhs Dimension3 to subtract
         /// \return A reference to the dimension3 with the result of the subtraction
         template<typename T>
-        friend auto operator-=(T& dimension3_lhs, const T& dimension3_rhs) noexcept -> enable_if_dimension3<T, const T&> {
+        friend constexpr auto operator-=(T& dimension3_lhs, const T& dimension3_rhs) noexcept -> enable_if_dimension3<T, const T&> {
+            if constexpr (std::is_same_v<V, double>) {
+                if (BARDRIX_USE_LANES()) {
+                    dimension3_lhs.set_lanes(dimension3_lhs.lanes() - dimension3_rhs.lanes());
+                    return dimension3_lhs;
+                }
+            }
             dimension3_lhs.x -= dimension3_rhs.x;
             dimension3_lhs.y -= dimension3_rhs.y;
             dimension3_lhs.z -= dimension3_rhs.z;
@@ -178,7 +216,13 @@ namespace bardrix {
         /// \param n Value to subtract
         /// \return A reference to the dimension3 with the result of the subtraction
         template<typename T>
-        friend auto operator-=(T& dimension3, double n) noexcept -> enable_if_dimension3<T, const T&> {
+        friend constexpr auto operator-=(T& dimension3, V n) noexcept -> enable_if_dimension3<T, const T&> {
+            if constexpr (std::is_same_v<V, double>) {
+                if (BARDRIX_USE_LANES()) {
+                    dimension3.set_lanes(dimension3.lanes() - lanes4::broadcast(n));
+                    return dimension3;
+                }
+            }
             dimension3.x -= n;
             dimension3.y -= n;
             dimension3.z -= n;
@@ -191,7 +235,7 @@ namespace bardrix {
         /// \param n Value to multiply (scalar)
         /// \return A copy of the dimension3 with the result of the multiplication
         template<typename T>
-        NODISCARD friend auto operator*(const T& dimension3, double n) noexcept -> enable_if_dimension3<T, T> {
+        NODISCARD friend constexpr auto operator*(const T& dimension3, V n) noexcept -> enable_if_dimension3<T, T> {
             T result = dimension3;
             result *= n;
             return result;
@@ -203,7 +247,7 @@ namespace bardrix {
         /// \param dimension3 Dimension3 to multiply
         /// \return A copy of the dimension3 with the result of the multiplication
         template<typename T>
-        NODISCARD friend auto operator*(double n, const T& dimension3) noexcept -> enable_if_dimension3<T, T> {
+        NODISCARD friend constexpr auto operator*(V n, const T& dimension3) noexcept -> enable_if_dimension3<T, T> {
             return dimension3 * n;
         }
 
@@ -213,7 +257,13 @@ namespace bardrix {
         /// \param n Value to multiply (scalar)
         /// \return A reference to the dimension3 with the result of the multiplication
         template<typename T>
-        friend auto operator*=(T& dimension3, double n) noexcept -> enable_if_dimension3<T, const T&> {
+        friend constexpr auto operator*=(T& dimension3, V n) noexcept -> enable_if_dimension3<T, const T&> {
+            if constexpr (std::is_same_v<V, double>) {
+                if (BARDRIX_USE_LANES()) {
+                    dimension3.set_lanes(dimension3.lanes() * lanes4::broadcast(n));
+                    return dimension3;
+                }
+            }
             dimension3.x *= n;
             dimension3.y *= n;
             dimension3.z *= n;
@@ -227,13 +277,11 @@ namespace bardrix {
         /// \throws std::invalid_argument If n is 0
         /// \return A copy of the dimension3 with the result of the division
         template<typename T>
-        NODISCARD friend auto operator/(const T& dimension3, double n) -> enable_if_dimension3<T, T> {
+        NODISCARD friend constexpr auto operator/(const T& dimension3, V n) -> enable_if_dimension3<T, T> {
             if (nearly_equal(n, 0))
                 throw std::invalid_argument("Division by zero");
 
-            T result = dimension3;
-            result /= n;
-            return result;
+            return divide_unchecked(dimension3, n);
         }
 
         /// \brief Divide a dimension3 by a scalar (T result = n / dim3)
@@ -243,15 +291,11 @@ namespace bardrix {
         /// \throws std::invalid_argument If any of the dimension3 values is 0
         /// \return A copy of the dimension3 with the result of the division
         template<typename T>
-        NODISCARD friend auto operator/(double n, const T& dimension3) -> enable_if_dimension3<T, T> {
+        NODISCARD friend constexpr auto operator/(V n, const T& dimension3) -> enable_if_dimension3<T, T> {
             if (nearly_equal(dimension3.x, 0) || nearly_equal(dimension3.y, 0) || nearly_equal(dimension3.z, 0))
                 throw std::invalid_argument("Division by zero");
 
-            T result = dimension3;
-            result.x = n / dimension3.x;
-            result.y = n / dimension3.y;
-            result.z = n / dimension3.z;
-            return result;
+            return divide_unchecked(n, dimension3);
         }
 
         /// \brief Divide a dimension3 by a scalar (dim3 /= n)
@@ -261,10 +305,57 @@ namespace bardrix {
         /// \throws std::invalid_argument If n is 0
         /// \return A reference to the dimension3 with the result of the division
         template<typename T>
-        friend auto operator/=(T& dimension3, double n) -> enable_if_dimension3<T, const T&> {
+        friend constexpr auto operator/=(T& dimension3, V n) -> enable_if_dimension3<T, const T&> {
             if (nearly_equal(n, 0))
                 throw std::invalid_argument("Division by zero");
 
+            return divide_assign_unchecked(dimension3, n);
+        }
+
+        /// \brief Divide a dimension3 by a scalar without checking for 0 (T result = dim3 / n)
+        /// \tparam T Type of the dimension3, must be a derived class of dimension3
+        /// \param dimension3 Dimension3 to divide
+        /// \param n Value to divide (scalar)
+        /// \return A copy of the dimension3 with the result of the division
+        /// \details Follows IEEE, dividing by 0 gives infinity (or NaN for 0 / 0) instead of throwing. \n
+        ///          Without the branch and exception, loops over many dimension3 can be vectorized
+        /// \example vector3 v = divide_unchecked(vector3(1, 2, 3), 2.0); // v = (0.5, 1, 1.5)
+        template<typename T>
+        NODISCARD friend constexpr auto divide_unchecked(const T& dimension3, V n) noexcept -> enable_if_dimension3<T, T> {
+            T result = dimension3;
+            divide_assign_unchecked(result, n);
+            return result;
+        }
+
+        /// \brief Divide a scalar by a dimension3 without checking for 0 (T result = n / dim3)
+        /// \tparam T Type of the dimension3, must be a derived class of dimension3
+        /// \param n Value to divide (scalar)
+        /// \param dimension3 Dimension3 to divide
+        /// \return A copy of the dimension3 with the result of the division
+        /// \details Follows IEEE, dividing by 0 gives infinity (or NaN for 0 / 0) instead of throwing
+        template<typename T>
+        NODISCARD friend constexpr auto divide_unchecked(V n, const T& dimension3) noexcept -> enable_if_dimension3<T, T> {
+            T result = dimension3;
+            result.x = n / dimension3.x;
+            result.y = n / dimension3.y;
+            result.z = n / dimension3.z;
+            return result;
+        }
+
+        /// \brief Divide a dimension3 by a scalar without checking for 0 (dim3 /= n)
+        /// \tparam T Type of the dimension3, must be a derived class of dimension3
+        /// \param dimension3 Dimension3 containing the result
+        /// \param n Value to divide (scalar)
+        /// \return A reference to the dimension3 with the result of the division
+        /// \details Follows IEEE, dividing by 0 gives infinity (or NaN for 0 / 0) instead of throwing
+        template<typename T>
+        friend constexpr auto divide_assign_unchecked(T& dimension3, V n) noexcept -> enable_if_dimension3<T, const T&> {
+            if constexpr (std::is_same_v<V, double>) {
+                if (BARDRIX_USE_LANES()) {
+                    dimension3.set_lanes(dimension3.lanes() / lanes4::broadcast(n));
+                    return dimension3;
+                }
+            }
             dimension3.x /= n;
             dimension3.y /= n;
             dimension3.z /= n;
@@ -279,7 +370,7 @@ namespace bardrix {
         /// \note It used the std::fmod function to calculate the modulus
         /// \return A copy of the dimension3 with the result of the modulus
         template<typename T>
-        NODISCARD friend auto operator%(const T& dimension3, double n) -> enable_if_dimension3<T, T> {
+        NODISCARD friend auto operator%(const T& dimension3, V n) -> enable_if_dimension3<T, T> {
             if (nearly_equal(n, 0))
                 throw std::invalid_argument("Division by zero");
 
@@ -296,7 +387,7 @@ namespace bardrix {
         /// \throws std::invalid_argument If any of the dimension3 values is 0
         /// \return A copy of the dimension3 with the result of the modulus
         template<typename T>
-        NODISCARD friend auto operator%(double n, const T& dimension3) -> enable_if_dimension3<T, T> {
+        NODISCARD friend auto operator%(V n, const T& dimension3) -> enable_if_dimension3<T, T> {
             if (nearly_equal(dimension3.x, 0) || nearly_equal(dimension3.y, 0) || nearly_equal(dimension3.z, 0))
                 throw std::invalid_argument("Division by zero");
 
@@ -315,7 +406,7 @@ namespace bardrix {
         /// \note It used the std::fmod function to calculate the modulus
         /// \return A reference to the dimension3 with the result of the modulus
         template<typename T>
-        friend auto operator%=(T& dimension3, double n) -> enable_if_dimension3<T, const T&> {
+        friend auto operator%=(T& dimension3, V n) -> enable_if_dimension3<T, const T&> {
             if (nearly_equal(n, 0))
                 throw std::invalid_argument("Division by zero");
 
@@ -333,7 +424,7 @@ namespace bardrix {
         /// \param dimension3_rhs Dimension3 to compare
         /// \return True if the two dimension3 are equal, false otherwise
         template<typename T>
-        NODISCARD friend auto operator==(const T& dimension3_lhs, const T& dimension3_rhs) noexcept -> enable_if_dimension3<T, bool> {
+        NODISCARD friend constexpr auto operator==(const T& dimension3_lhs, const T& dimension3_rhs) noexcept -> enable_if_dimension3<T, bool> {
             return nearly_equal(dimension3_lhs.x, dimension3_rhs.x) &&
                    nearly_equal(dimension3_lhs.y, dimension3_rhs.y) &&
                    nearly_equal(dimension3_lhs.z, dimension3_rhs.z);
@@ -345,7 +436,7 @@ namespace bardrix {
         /// \param n Value to compare
         /// \return True if the dimension3 is equal to the value, false otherwise
         template<typename T>
-        NODISCARD friend auto operator==(const T& dimension3, double n) noexcept -> enable_if_dimension3<T, bool> {
+        NODISCARD friend constexpr auto operator==(const T& dimension3, V n) noexcept -> enable_if_dimension3<T, bool> {
             return nearly_equal(dimension3.x, n) && nearly_equal(dimension3.y, n) && nearly_equal(dimension3.z, n);
         }
 
@@ -355,7 +446,7 @@ namespace bardrix {
         /// \param dimension3_rhs Dimension3 to compare
         /// \return True if the two dimension3 are different, false otherwise
         template<typename T>
-        NODISCARD friend auto operator!=(const T& dimension3_lhs, const T& dimension3_rhs) noexcept -> enable_if_dimension3<T, bool> {
+        NODISCARD friend constexpr auto operator!=(const T& dimension3_lhs, const T& dimension3_rhs) noexcept -> enable_if_dimension3<T, bool> {
             return !(dimension3_lhs == dimension3_rhs);
         }
 
@@ -365,7 +456,7 @@ namespace bardrix {
         /// \param dimension3_rhs Dimension3 to compare
         /// \return True if the first dimension3 is less than the second dimension3, false otherwise
         template<typename T>
-        NODISCARD friend auto operator<(const T& dimension3_lhs, const T& dimension3_rhs) noexcept -> enable_if_dimension3<T, bool> {
+        NODISCARD friend constexpr auto operator<(const T& dimension3_lhs, const T& dimension3_rhs) noexcept -> enable_if_dimension3<T, bool> {
             return dimension3_lhs.x < dimension3_rhs.x && dimension3_lhs.y < dimension3_rhs.y &&
                    dimension3_lhs.z < dimension3_rhs.z;
         }
@@ -376,7 +467,7 @@ namespace bardrix {
         /// \param dimension3_rhs Dimension3 to compare
         /// \return True if the first dimension3 is greater than the second dimension3, false otherwise
         template<typename T>
-        NODISCARD friend auto operator>(const T& dimension3_lhs, const T& dimension3_rhs) noexcept -> enable_if_dimension3<T, bool> {
+        NODISCARD friend constexpr auto operator>(const T& dimension3_lhs, const T& dimension3_rhs) noexcept -> enable_if_dimension3<T, bool> {
             return dimension3_lhs.x > dimension3_rhs.x && dimension3_lhs.y > dimension3_rhs.y &&
                    dimension3_lhs.z > dimension3_rhs.z;
         }
@@ -387,7 +478,7 @@ namespace bardrix {
         /// \param dimension3_rhs Dimension3 to compare
         /// \return True if the first dimension3 is less than or equal to the second dimension3, false otherwise
         template<typename T>
-        NODISCARD friend auto operator<=(const T& dimension3_lhs, const T& dimension3_rhs) noexcept -> enable_if_dimension3<T, bool> {
+        NODISCARD friend constexpr auto operator<=(const T& dimension3_lhs, const T& dimension3_rhs) noexcept -> enable_if_dimension3<T, bool> {
             return less_than_or_nearly_equal(dimension3_lhs.x, dimension3_rhs.x) &&
                    less_than_or_nearly_equal(dimension3_lhs.y, dimension3_rhs.y) &&
                    less_than_or_nearly_equal(dimension3_lhs.z, dimension3_rhs.z);
@@ -399,7 +490,7 @@ namespace bardrix {
         /// \param dimension3_rhs Dimension3 to compare
         /// \return True if the first dimension3 is greater than or equal to the second dimension3, false otherwise
         template<typename T>
-        NODISCARD friend auto operator>=(const T& dimension3_lhs, const T& dimension3_rhs) noexcept -> enable_if_dimension3<T, bool> {
+        NODISCARD friend constexpr auto operator>=(const T& dimension3_lhs, const T& dimension3_rhs) noexcept -> enable_if_dimension3<T, bool> {
             return greater_than_or_nearly_equal(dimension3_lhs.x, dimension3_rhs.x) &&
                    greater_than_or_nearly_equal(dimension3_lhs.y, dimension3_rhs.y) &&
                    greater_than_or_nearly_equal(dimension3_lhs.z, dimension3_rhs.z);
@@ -412,7 +503,7 @@ namespace bardrix {
         /// \param dimension3 Dimension3 to invert
         /// \return A copy of the dimension3 with the inverted sign
         template<typename T>
-        NODISCARD friend auto operator-(const T& dimension3) noexcept -> enable_if_dimension3<T, T> {
+        NODISCARD friend constexpr auto operator-(const T& dimension3) noexcept -> enable_if_dimension3<T, T> {
             T result = dimension3;
             result.x = -result.x;
             result.y = -result.y;
@@ -425,7 +516,7 @@ namespace bardrix {
         /// \param dimension3 Dimension3 to increment
         /// \return A reference to the dimension3 after the increment
         template<typename T>
-        friend auto operator++(T& dimension3) noexcept -> enable_if_dimension3<T, T&> {
+        friend constexpr auto operator++(T& dimension3) noexcept -> enable_if_dimension3<T, T&> {
             ++dimension3.x;
             ++dimension3.y;
             ++dimension3.z;
@@ -437,7 +528,7 @@ namespace bardrix {
         /// \param dimension3 Dimension3 to increment
         /// \return A copy of the dimension3 before the increment
         template<typename T>
-        NODISCARD friend auto operator++(T& dimension3, int) noexcept -> enable_if_dimension3<T, T> {
+        NODISCARD friend constexpr auto operator++(T& dimension3, int) noexcept -> enable_if_dimension3<T, T> {
             T result = dimension3;
             ++dimension3;
             return result;
@@ -448,7 +539,7 @@ namespace bardrix {
         /// \param dimension3 Dimension3 to decrement
         /// \return A reference to the dimension3 after the decrement
         template<typename T>
-        friend auto operator--(T& dimension3) noexcept -> enable_if_dimension3<T, T&> {
+        friend constexpr auto operator--(T& dimension3) noexcept -> enable_if_dimension3<T, T&> {
             --dimension3.x;
             --dimension3.y;
             --dimension3.z;
@@ -461,7 +552,7 @@ namespace bardrix {
         /// \param dimension3 Dimension3 to decrement
         /// \return A copy of the dimension3 before the decrement
         template<typename T>
-        NODISCARD friend auto operator--(T& dimension3, int) noexcept -> enable_if_dimension3<T, T> {
+        NODISCARD friend constexpr auto operator--(T& dimension3, int) noexcept -> enable_if_dimension3<T, T> {
             T result = dimension3;
             --dimension3;
             return result;
@@ -478,7 +569,9 @@ namespace bardrix {
         /// \param os Output stream
         /// \param dimension3 Dimension3 to output
         /// \return A reference to the output stream
-        friend std::ostream& operator<<(std::ostream& os, const dimension3& dimension3);
+        friend std::ostream& operator<<(std::ostream& os, const basic_dimension3& dimension3) {
+            return dimension3.print(os);
+        }
 
         /// \brief Get the value of a dimension
         /// \param axis The axis to get the value
@@ -486,8 +579,61 @@ namespace bardrix {
         /// \throws std::invalid_argument If the axis is invalid
         /// \note axis::x = 0, axis::y = 1, axis::z = 2
         /// \example point3(1, 2, 3)[axis::x] -> 1
-        NODISCARD double& operator[](axis axis);
+        NODISCARD constexpr V& operator[](axis axis);
 
-    }; // class dimension3
+        /// \brief Get the value of a dimension
+        /// \param axis The axis to get the value
+        /// \return The value of the axis
+        /// \throws std::invalid_argument If the axis is invalid
+        /// \note axis::x = 0, axis::y = 1, axis::z = 2
+        /// \example const point3 point(1, 2, 3); point[axis::x] -> 1
+        NODISCARD constexpr V operator[](axis axis) const;
+
+    protected:
+        /// \brief Gets x, y and z as lanes4, lane 3 is 0 (double values only)
+        /// \return The lanes
+        /// \note x, y and z are separate members, so they are set one by one instead of loaded as an array
+        NODISCARD lanes4 lanes() const noexcept { return lanes4::set(x, y, z); }
+
+        /// \brief Sets x, y and z to lane 0, 1 and 2 (double values only)
+        /// \param values The lanes
+        void set_lanes(const lanes4& values) noexcept { values.store3(x, y, z); }
+
+    }; // class basic_dimension3
+
+    /// \brief 3 dimensions with double values
+    using dimension3 = basic_dimension3<double>;
+
+    // basic_dimension3 implementation start
+
+    template<typename V>
+    constexpr V& basic_dimension3<V>::operator[](axis axis) {
+        switch (axis) {
+            case axis::x:
+                return x;
+            case axis::y:
+                return y;
+            case axis::z:
+                return z;
+            default:
+                throw std::invalid_argument("Invalid axis");
+        }
+    }
+
+    template<typename V>
+    constexpr V basic_dimension3<V>::operator[](axis axis) const {
+        switch (axis) {
+            case axis::x:
+                return x;
+            case axis::y:
+                return y;
+            case axis::z:
+                return z;
+            default:
+                throw std::invalid_argument("Invalid axis");
+        }
+    }
+
+    // basic_dimension3 implementation end
 
 } // namespace bardrix
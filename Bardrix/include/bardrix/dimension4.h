@@ -5,12 +5,14 @@
 #pragma once
 
 #include <bardrix/bardrix.h>
+#include <bardrix/lanes.h>
 
 namespace bardrix {
 
     /// \brief Abstract class to represent 4 dimensions (x, y, z, w)
     /// \note This class is not meant to be used directly, but to be inherited by other classes
-    /// \details This class implements the basic operations for 4 dimensions (+, +=, -, -=, *, *=, /, /=, %, %=, ==, !=, <, >, <=, >=, -, ++, --, <<)
+    /// \details This class implements the basic operations for 4 dimensions (+, +=, -, -=, *, *=, /, /=, %, %=, ==, !=, <, >, <=, >=, -, ++, --, <<) \n
+    ///          The arithmetic, min and max use lanes4, so x, y, z and w are computed in one SIMD step
     /// \example quaternion : public dimension4
     class dimension4 {
 
@@ -36,10 +38,7 @@ namespace bardrix {
         template<typename T>
         NODISCARD auto min(const T& dimension4) const noexcept -> enable_if_dimension4<T, T> {
             T result = dimension4;
-            result.x = std::min(x, dimension4.x);
-            result.y = std::min(y, dimension4.y);
-            result.z = std::min(z, dimension4.z);
-            result.w = std::min(w, dimension4.w);
+            result.set_lanes(lanes4::min(dimension4.lanes(), lanes()));
             return result;
         }
 
@@ -51,10 +50,7 @@ namespace bardrix {
         template<typename T>
         NODISCARD auto max(const T& dimension4) const noexcept -> enable_if_dimension4<T, T> {
             T result = dimension4;
-            result.x = std::max(x, dimension4.x);
-            result.y = std::max(y, dimension4.y);
-            result.z = std::max(z, dimension4.z);
-            result.w = std::max(w, dimension4.w);
+            result.set_lanes(lanes4::max(dimension4.lanes(), lanes()));
             return result;
         }
 
@@ -105,10 +101,7 @@ namespace bardrix {
         /// \return A reference to the dimension4 with the result of the addition
         template<typename T>
         friend auto operator+=(T& dimension4_lhs, const T& dimension4_rhs) noexcept -> enable_if_dimension4<T, const T&> {
-            dimension4_lhs.x += dimension4_rhs.x;
-            dimension4_lhs.y += dimension4_rhs.y;
-            dimension4_lhs.z += dimension4_rhs.z;
-            dimension4_lhs.w += dimension4_rhs.w;
+            dimension4_lhs.set_lanes(dimension4_lhs.lanes() + dimension4_rhs.lanes());
             return dimension4_lhs;
         }
 
@@ -119,10 +112,7 @@ namespace bardrix {
         /// \return A reference to the dimension4 with the result of the addition
         template<typename T>
         friend auto operator+=(T& dimension4, double n) noexcept -> enable_if_dimension4<T, const T&> {
-            dimension4.x += n;
-            dimension4.y += n;
-            dimension4.z += n;
-            dimension4.w += n;
+            dimension4.set_lanes(dimension4.lanes() + lanes4::broadcast(n));
             return dimension4;
         }
 
@@ -172,10 +162,7 @@ namespace bardrix {
         /// \return A reference to the dimension4 with the result of the subtraction
         template<typename T>
         friend auto operator-=(T& dimension4_lhs, const T& dimension4_rhs) noexcept -> enable_if_dimension4<T, const T&> {
-            dimension4_lhs.x -= dimension4_rhs.x;
-            dimension4_lhs.y -= dimension4_rhs.y;
-            dimension4_lhs.z -= dimension4_rhs.z;
-            dimension4_lhs.w -= dimension4_rhs.w;
+            dimension4_lhs.set_lanes(dimension4_lhs.lanes() - dimension4_rhs.lanes());
             return dimension4_lhs;
         }
 
@@ -186,10 +173,7 @@ namespace bardrix {
         /// \return A reference to the dimension4 with the result of the subtraction
         template<typename T>
         friend auto operator-=(T& dimension4, double n) noexcept -> enable_if_dimension4<T, const T&> {
-            dimension4.x -= n;
-            dimension4.y -= n;
-            dimension4.z -= n;
-            dimension4.w -= n;
+            dimension4.set_lanes(dimension4.lanes() - lanes4::broadcast(n));
             return dimension4;
         }
 
@@ -222,10 +206,7 @@ namespace bardrix {
         /// \return A reference to the dimension4 with the result of the multiplication
         template<typename T>
         friend auto operator*=(T& dimension4, double n) noexcept -> enable_if_dimension4<T, const T&> {
-            dimension4.x *= n;
-            dimension4.y *= n;
-            dimension4.z *= n;
-            dimension4.w *= n;
+            dimension4.set_lanes(dimension4.lanes() * lanes4::broadcast(n));
             return dimension4;
         }
 
@@ -276,10 +257,7 @@ namespace bardrix {
             if (nearly_equal(n, 0))
                 throw std::invalid_argument("Division by zero");
 
-            dimension4.x /= n;
-            dimension4.y /= n;
-            dimension4.z /= n;
-            dimension4.w /= n;
+            dimension4.set_lanes(dimension4.lanes() / lanes4::broadcast(n));
             return dimension4;
         }
 
@@ -510,6 +488,24 @@ namespace bardrix {
         /// \example point3(1, 2, 3, 4)[axis::x] -> 1
         NODISCARD double& operator[](axis axis);
 
+        /// \brief Get the value of a dimension
+        /// \param axis The axis to get the value
+        /// \return The value of the axis
+        /// \throws std::invalid_argument If the axis is invalid
+        /// \note axis::x = 0, axis::y = 1, axis::z = 2, axis::w = 3
+        /// \example const quaternion q(1, 2, 3, 4); q[axis::x] -> 1
+        NODISCARD double operator[](axis axis) const;
+
+    protected:
+        /// \brief Gets x, y, z and w as lanes4
+        /// \return The lanes
+        /// \note x, y, z and w are separate members, so they are set one by one instead of loaded as an array
+        NODISCARD lanes4 lanes() const noexcept { return lanes4::set(x, y, z, w); }
+
+        /// \brief Sets x, y, z and w to lane 0, 1, 2 and 3
+        /// \param values The lanes
+        void set_lanes(const lanes4& values) noexcept { values.store4(x, y, z, w); }
+
     }; // class dimension4
 
 } // namespace bardrix
@@ -0,0 +1,262 @@
+//
+// Created by Bardio on 16/10/2026.
+//
+
+#pragma once
+
+#include <bardrix/bardrix.h>
+#include <bardrix/vector3.h>
+#include <bardrix/point3.h>
+
+namespace bardrix {
+
+    /// \brief Checks if a type is derived from basic_dimension3, e.g. point3, vector3 or vector3_f.
+    /// \tparam T The type to check.
+    template<typename T>
+    struct is_dimension3 {
+    private:
+        template<typename V>
+        static std::true_type test(const basic_dimension3<V>*);
+
+        static std::false_type test(...);
+
+    public:
+        /// \brief True if T is derived from basic_dimension3.
+        static constexpr bool value = decltype(test(std::declval<const T*>()))::value;
+    };
+
+    /// \brief Gives the type of the sum or difference of two dimension3 types. \n
+    ///        point3 + vector3 and point3 - vector3 give a point3, otherwise both types must be the same.
+    template<typename Lhs, typename Rhs>
+    struct dimension3_sum {};
+
+    template<typename T>
+    struct dimension3_sum<T, T> {
+        using type = T;
+    };
+
+    template<typename V>
+    struct dimension3_sum<basic_point3<V>, basic_vector3<V>> {
+        using type = basic_point3<V>;
+    };
+
+    /// \brief The operations of a dimension3_expression, every operation computes one component.
+    struct expression_add {
+        template<typename Lhs, typename Rhs>
+        using result_type = typename dimension3_sum<Lhs, Rhs>::type;
+
+        template<typename V>
+        NODISCARD static constexpr V apply(V lhs, V rhs) noexcept { return lhs + rhs; }
+    };
+
+    struct expression_subtract {
+        template<typename Lhs, typename Rhs>
+        using result_type = typename dimension3_sum<Lhs, Rhs>::type;
+
+        template<typename V>
+        NODISCARD static constexpr V apply(V lhs, V rhs) noexcept { return lhs - rhs; }
+    };
+
+    struct expression_multiply {
+        template<typename Lhs, typename Rhs>
+        using result_type = Lhs;
+
+        template<typename V>
+        NODISCARD static constexpr V apply(V lhs, V rhs) noexcept { return lhs * rhs; }
+    };
+
+    struct expression_divide {
+        template<typename Lhs, typename Rhs>
+        using result_type = Lhs;
+
+        template<typename V>
+        NODISCARD static constexpr V apply(V lhs, V rhs) noexcept { return lhs / rhs; }
+    };
+
+    /// \brief A scalar in a dimension3_expression, every component is the same value.
+    /// \tparam V The type of the value, float or double.
+    template<typename V>
+    struct expression_scalar {
+        using result_type = V;
+
+        /// \brief The value of every component.
+        V value;
+
+        /// \brief Gets a component of the scalar.
+        /// \tparam I The index of the component, 0 = x, 1 = y, 2 = z.
+        /// \return The value.
+        template<std::size_t I>
+        NODISCARD constexpr V get() const noexcept { return value; }
+    };
+
+    /// \brief A leaf of a dimension3_expression, it references a point3 or vector3.
+    /// \tparam T The type of the referenced value, e.g. point3 or vector3_f.
+    /// \note The reference is only valid during the statement which creates it, see bardrix::lazy.
+    template<typename T>
+    class dimension3_reference {
+        /// \brief The referenced value
+        const T& value_;
+
+    public:
+        using result_type = T;
+        using value_type = typename T::value_type;
+
+        /// \brief Constructor for dimension3_reference
+        /// \param value The referenced value
+        constexpr explicit dimension3_reference(const T& value) noexcept : value_(value) {}
+
+        /// \brief Gets a component of the referenced value.
+        /// \tparam I The index of the component, 0 = x, 1 = y, 2 = z.
+        /// \return The component.
+        template<std::size_t I>
+        NODISCARD constexpr value_type get() const noexcept {
+            if constexpr (I == 0) return value_.x;
+            else if constexpr (I == 1) return value_.y;
+            else return value_.z;
+        }
+
+        /// \brief Evaluates the expression.
+        /// \return A copy of the referenced value.
+        NODISCARD constexpr operator T() const noexcept { return value_; }
+
+    }; // class dimension3_reference
+
+    /// \brief Represents an operation on point3 and vector3 values which isn't evaluated yet. \n
+    ///        The whole expression is evaluated in one pass when it's converted to its result type, \n
+    ///        without a temporary for every operator.
+    /// \tparam Lhs The left operand, a dimension3_reference or dimension3_expression.
+    /// \tparam Rhs The right operand, a dimension3_reference, dimension3_expression or expression_scalar.
+    /// \tparam Operation The operation, e.g. expression_add.
+    /// \details Every component is computed with the same operations in the same order as the operators of \n
+    ///          dimension3, so the result is bit-identical to them.
+    /// \example bardrix::point3 top_left = bardrix::lazy(position) + direction - right + up;
+    template<typename Lhs, typename Rhs, typename Operation>
+    class dimension3_expression {
+        /// \brief The left operand
+        Lhs lhs_;
+
+        /// \brief The right operand
+        Rhs rhs_;
+
+    public:
+        using result_type = typename Operation::template result_type<typename Lhs::result_type,
+                                                                     typename Rhs::result_type>;
+        using value_type = typename result_type::value_type;
+
+        /// \brief Constructor for dimension3_expression
+        /// \param lhs The left operand
+        /// \param rhs The right operand
+        constexpr dimension3_expression(const Lhs& lhs, const Rhs& rhs) noexcept : lhs_(lhs), rhs_(rhs) {}
+
+        /// \brief Computes a component of the expression.
+        /// \tparam I The index of the component, 0 = x, 1 = y, 2 = z.
+        /// \return The component.
+        template<std::size_t I>
+        NODISCARD constexpr value_type get() const noexcept {
+            return Operation::apply(lhs_.template get<I>(), rhs_.template get<I>());
+        }
+
+        /// \brief Evaluates the expression.
+        /// \return The result of the expression.
+        NODISCARD constexpr result_type eval() const noexcept {
+            result_type result;
+            result.x = get<0>();
+            result.y = get<1>();
+            result.z = get<2>();
+            return result;
+        }
+
+        /// \brief Evaluates the expression.
+        /// \return The result of the expression.
+        NODISCARD constexpr operator result_type() const noexcept { return eval(); }
+
+    }; // class dimension3_expression
+
+    /// \brief Checks if a type is a dimension3_reference or dimension3_expression.
+    /// \tparam T The type to check.
+    template<typename T>
+    struct is_dimension3_expression : std::false_type {};
+
+    template<typename T>
+    struct is_dimension3_expression<dimension3_reference<T>> : std::true_type {};
+
+    template<typename Lhs, typename Rhs, typename Operation>
+    struct is_dimension3_expression<dimension3_expression<Lhs, Rhs, Operation>> : std::true_type {};
+
+    /// \brief Gives the expression of an operand, a point3 or vector3 becomes a dimension3_reference.
+    template<typename T, bool = is_dimension3_expression<T>::value>
+    struct expression_of {
+        using type = T;
+    };
+
+    template<typename T>
+    struct expression_of<T, false> {
+        using type = dimension3_reference<T>;
+    };
+
+    /// \brief Enables an operator if one operand is an expression and the other is an expression or dimension3.
+    template<typename Lhs, typename Rhs, typename Result>
+    using enable_if_expression = std::enable_if_t<
+            (is_dimension3_expression<Lhs>::value || is_dimension3_expression<Rhs>::value) &&
+            (is_dimension3_expression<Lhs>::value || is_dimension3<Lhs>::value) &&
+            (is_dimension3_expression<Rhs>::value || is_dimension3<Rhs>::value), Result>;
+
+    /// \brief Starts an expression, the operators of the expression aren't evaluated until it's converted to \n
+    ///        its result type (e.g. point3), then every component is computed in one pass.
+    /// \tparam T The type of the value, e.g. point3 or vector3.
+    /// \param value The first operand of the expression.
+    /// \return A reference to the value, as an expression.
+    /// \example bardrix::point3 end = bardrix::lazy(ray.position) + ray.get_direction() * distance;
+    /// \details The result is bit-identical to the same expression without lazy.
+    /// \note The expression references its operands, it must be evaluated in the statement which creates it, \n
+    ///       e.g. assign it to a point3 instead of auto.
+    template<typename T, typename = std::enable_if_t<is_dimension3<T>::value>>
+    NODISCARD constexpr dimension3_reference<T> lazy(const T& value) noexcept {
+        return dimension3_reference<T>(value);
+    }
+
+    /// \brief Adds two operands of an expression (lhs + rhs), at least one must be an expression.
+    /// \return The expression of the sum.
+    template<typename Lhs, typename Rhs>
+    NODISCARD constexpr auto operator+(const Lhs& lhs, const Rhs& rhs) noexcept -> enable_if_expression<Lhs, Rhs,
+            dimension3_expression<typename expression_of<Lhs>::type, typename expression_of<Rhs>::type, expression_add>> {
+        return { typename expression_of<Lhs>::type(lhs), typename expression_of<Rhs>::type(rhs) };
+    }
+
+    /// \brief Subtracts two operands of an expression (lhs - rhs), at least one must be an expression.
+    /// \return The expression of the difference.
+    template<typename Lhs, typename Rhs>
+    NODISCARD constexpr auto operator-(const Lhs& lhs, const Rhs& rhs) noexcept -> enable_if_expression<Lhs, Rhs,
+            dimension3_expression<typename expression_of<Lhs>::type, typename expression_of<Rhs>::type, expression_subtract>> {
+        return { typename expression_of<Lhs>::type(lhs), typename expression_of<Rhs>::type(rhs) };
+    }
+
+    /// \brief Multiplies an expression by a scalar (expression * n).
+    /// \return The expression of the product.
+    template<typename E, typename = std::enable_if_t<is_dimension3_expression<E>::value>>
+    NODISCARD constexpr auto operator*(const E& expression, typename E::value_type n) noexcept
+    -> dimension3_expression<E, expression_scalar<typename E::value_type>, expression_multiply> {
+        return { expression, { n } };
+    }
+
+    /// \brief Multiplies an expression by a scalar (n * expression), the same as expression * n.
+    /// \return The expression of the product.
+    template<typename E, typename = std::enable_if_t<is_dimension3_expression<E>::value>>
+    NODISCARD constexpr auto operator*(typename E::value_type n, const E& expression) noexcept
+    -> dimension3_expression<E, expression_scalar<typename E::value_type>, expression_multiply> {
+        return { expression, { n } };
+    }
+
+    /// \brief Divides an expression by a scalar (expression / n).
+    /// \return The expression of the quotient.
+    /// \throws std::invalid_argument If n is 0, the same as the operator / of dimension3
+    template<typename E, typename = std::enable_if_t<is_dimension3_expression<E>::value>>
+    NODISCARD constexpr auto operator/(const E& expression, typename E::value_type n)
+    -> dimension3_expression<E, expression_scalar<typename E::value_type>, expression_divide> {
+        if (nearly_equal(n, 0))
+            throw std::invalid_argument("Division by zero");
+
+        return { expression, { n } };
+    }
+
+} // namespace bardrix
@@ -0,0 +1,338 @@
+//
+// Created by Bardio on 16/10/2026.
+//
+
+#pragma once
+
+#include <bardrix/bardrix.h>
+
+namespace bardrix {
+
+    /// \brief Represents 4 doubles which are computed at once, in one AVX register, two SSE2 registers or an array \n
+    ///        when there is no SIMD support. dimension3 (padded to 4 lanes) and dimension4 use it for their arithmetic.
+    /// \details Every lane is computed in the same order as the scalar code, so the results are bit-identical to it. \n
+    ///          load and store only take arrays, separate members (e.g. x, y and z) use set and the store overloads \n
+    ///          with references, since pointer arithmetic from one member to the next is undefined.
+    /// \example bardrix::lanes4 sum = bardrix::lanes4::set(a.x, a.y, a.z) + bardrix::lanes4::set(b.x, b.y, b.z); \n
+    ///          sum.store3(a.x, a.y, a.z);
+    struct lanes4 {
+#if defined(BARDRIX_SIMD_AVX)
+        /// \brief The 4 lanes.
+        __m256d value;
+#elif defined(BARDRIX_SIMD_SSE2)
+        /// \brief Lane 0 and 1.
+        __m128d low;
+
+        /// \brief Lane 2 and 3.
+        __m128d high;
+#else
+        /// \brief The 4 lanes.
+        double value[4];
+#endif
+
+        /// \brief Creates the lanes from 4 values.
+        /// \param x, y, z, w The values of lane 0, 1, 2 and 3.
+        static lanes4 set(double x, double y, double z, double w = 0) noexcept;
+
+        /// \brief Creates the lanes with the same value in every lane.
+        /// \param value The value of every lane.
+        static lanes4 broadcast(double value) noexcept;
+
+        /// \brief Loads 3 values of an array, lane 3 is 0.
+        /// \param values The array, only values[0], values[1] and values[2] are read.
+        static lanes4 load3(const double* values) noexcept;
+
+        /// \brief Loads 4 values of an array.
+        /// \param values The array.
+        static lanes4 load4(const double* values) noexcept;
+
+        /// \brief Stores lane 0, 1 and 2, lane 3 isn't written.
+        /// \param values The destination, only values[0], values[1] and values[2] are written.
+        void store3(double* values) const noexcept;
+
+        /// \brief Stores all 4 lanes.
+        /// \param values The destination.
+        void store4(double* values) const noexcept;
+
+        /// \brief Stores lane 0, 1 and 2 in separate values (e.g. x, y and z of a dimension3).
+        /// \param x, y, z The destination of lane 0, 1 and 2.
+        void store3(double& x, double& y, double& z) const noexcept;
+
+        /// \brief Stores all 4 lanes in separate values (e.g. x, y, z and w of a dimension4).
+        /// \param x, y, z, w The destination of lane 0, 1, 2 and 3.
+        void store4(double& x, double& y, double& z, double& w) const noexcept;
+
+        /// \brief Takes the minimum of every lane, the same as std::min(b, a) (b when they are equal or NaN).
+        static lanes4 min(const lanes4& a, const lanes4& b) noexcept;
+
+        /// \brief Takes the maximum of every lane, the same as std::max(b, a) (b when they are equal or NaN).
+        static lanes4 max(const lanes4& a, const lanes4& b) noexcept;
+
+        /// \brief Takes the square root of every lane.
+        static lanes4 sqrt(const lanes4& a) noexcept;
+
+        /// \brief Selects a value per lane, the same as a <= b ? if_true : if_false (if_false when a or b is NaN).
+        static lanes4 select_less_equal(const lanes4& a, const lanes4& b, const lanes4& if_true,
+                                        const lanes4& if_false) noexcept;
+
+        /// \brief Adds lane 0, 1 and 2, in that order.
+        /// \return (lane 0 + lane 1) + lane 2
+        NODISCARD double sum3() const noexcept;
+
+        /// \brief Adds all lanes, in order.
+        /// \return ((lane 0 + lane 1) + lane 2) + lane 3
+        NODISCARD double sum4() const noexcept;
+
+        /// \brief Adds every lane.
+        friend lanes4 operator+(const lanes4& lhs, const lanes4& rhs) noexcept;
+
+        /// \brief Subtracts every lane.
+        friend lanes4 operator-(const lanes4& lhs, const lanes4& rhs) noexcept;
+
+        /// \brief Multiplies every lane.
+        friend lanes4 operator*(const lanes4& lhs, const lanes4& rhs) noexcept;
+
+        /// \brief Divides every lane, following IEEE (no checks for 0).
+        friend lanes4 operator/(const lanes4& lhs, const lanes4& rhs) noexcept;
+
+    }; // struct lanes4
+
+    // lanes4 implementation start
+
+#if defined(BARDRIX_SIMD_AVX)
+
+    INLINE lanes4 lanes4::set(double x, double y, double z, double w) noexcept { return { _mm256_setr_pd(x, y, z, w) }; }
+
+    INLINE lanes4 lanes4::broadcast(double value) noexcept { return { _mm256_set1_pd(value) }; }
+
+    INLINE lanes4 lanes4::load3(const double* values) noexcept {
+        // Two loads instead of a masked load, which is slow to forward from a previous store
+        return { _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_loadu_pd(values)), _mm_load_sd(values + 2), 1) };
+    }
+
+    INLINE lanes4 lanes4::load4(const double* values) noexcept { return { _mm256_loadu_pd(values) }; }
+
+    INLINE void lanes4::store3(double* values) const noexcept {
+        _mm_storeu_pd(values, _mm256_castpd256_pd128(value));
+        _mm_store_sd(values + 2, _mm256_extractf128_pd(value, 1));
+    }
+
+    INLINE void lanes4::store4(double* values) const noexcept { _mm256_storeu_pd(values, value); }
+
+    INLINE void lanes4::store3(double& x, double& y, double& z) const noexcept {
+        const __m128d low = _mm256_castpd256_pd128(value);
+        _mm_storel_pd(&x, low);
+        _mm_storeh_pd(&y, low);
+        _mm_store_sd(&z, _mm256_extractf128_pd(value, 1));
+    }
+
+    INLINE void lanes4::store4(double& x, double& y, double& z, double& w) const noexcept {
+        const __m128d low = _mm256_castpd256_pd128(value);
+        const __m128d high = _mm256_extractf128_pd(value, 1);
+        _mm_storel_pd(&x, low);
+        _mm_storeh_pd(&y, low);
+        _mm_storel_pd(&z, high);
+        _mm_storeh_pd(&w, high);
+    }
+
+    INLINE lanes4 lanes4::min(const lanes4& a, const lanes4& b) noexcept { return { _mm256_min_pd(a.value, b.value) }; }
+
+    INLINE lanes4 lanes4::max(const lanes4& a, const lanes4& b) noexcept { return { _mm256_max_pd(a.value, b.value) }; }
+
+    INLINE lanes4 lanes4::sqrt(const lanes4& a) noexcept { return { _mm256_sqrt_pd(a.value) }; }
+
+    INLINE lanes4 lanes4::select_less_equal(const lanes4& a, const lanes4& b, const lanes4& if_true,
+                                            const lanes4& if_false) noexcept {
+        return { _mm256_blendv_pd(if_false.value, if_true.value, _mm256_cmp_pd(a.value, b.value, _CMP_LE_OQ)) };
+    }
+
+    INLINE double lanes4::sum3() const noexcept {
+        const __m128d low = _mm256_castpd256_pd128(value);
+        const __m128d sum = _mm_add_sd(low, _mm_unpackhi_pd(low, low));
+        return _mm_cvtsd_f64(_mm_add_sd(sum, _mm256_extractf128_pd(value, 1)));
+    }
+
+    INLINE double lanes4::sum4() const noexcept {
+        const __m128d high = _mm256_extractf128_pd(value, 1);
+        return sum3() + _mm_cvtsd_f64(_mm_unpackhi_pd(high, high));
+    }
+
+    INLINE lanes4 operator+(const lanes4& lhs, const lanes4& rhs) noexcept { return { _mm256_add_pd(lhs.value, rhs.value) }; }
+
+    INLINE lanes4 operator-(const lanes4& lhs, const lanes4& rhs) noexcept { return { _mm256_sub_pd(lhs.value, rhs.value) }; }
+
+    INLINE lanes4 operator*(const lanes4& lhs, const lanes4& rhs) noexcept { return { _mm256_mul_pd(lhs.value, rhs.value) }; }
+
+    INLINE lanes4 operator/(const lanes4& lhs, const lanes4& rhs) noexcept { return { _mm256_div_pd(lhs.value, rhs.value) }; }
+
+#elif defined(BARDRIX_SIMD_SSE2)
+
+    INLINE lanes4 lanes4::set(double x, double y, double z, double w) noexcept {
+        return { _mm_setr_pd(x, y), _mm_setr_pd(z, w) };
+    }
+
+    INLINE lanes4 lanes4::broadcast(double value) noexcept { return { _mm_set1_pd(value), _mm_set1_pd(value) }; }
+
+    INLINE lanes4 lanes4::load3(const double* values) noexcept {
+        return { _mm_loadu_pd(values), _mm_load_sd(values + 2) };
+    }
+
+    INLINE lanes4 lanes4::load4(const double* values) noexcept {
+        return { _mm_loadu_pd(values), _mm_loadu_pd(values + 2) };
+    }
+
+    INLINE void lanes4::store3(double* values) const noexcept {
+        _mm_storeu_pd(values, low);
+        _mm_store_sd(values + 2, high);
+    }
+
+    INLINE void lanes4::store4(double* values) const noexcept {
+        _mm_storeu_pd(values, low);
+        _mm_storeu_pd(values + 2, high);
+    }
+
+    INLINE void lanes4::store3(double& x, double& y, double& z) const noexcept {
+        _mm_storel_pd(&x, low);
+        _mm_storeh_pd(&y, low);
+        _mm_storel_pd(&z, high);
+    }
+
+    INLINE void lanes4::store4(double& x, double& y, double& z, double& w) const noexcept {
+        _mm_storel_pd(&x, low);
+        _mm_storeh_pd(&y, low);
+        _mm_storel_pd(&z, high);
+        _mm_storeh_pd(&w, high);
+    }
+
+    INLINE lanes4 lanes4::min(const lanes4& a, const lanes4& b) noexcept {
+        return { _mm_min_pd(a.low, b.low), _mm_min_pd(a.high, b.high) };
+    }
+
+    INLINE lanes4 lanes4::max(const lanes4& a, const lanes4& b) noexcept {
+        return { _mm_max_pd(a.low, b.low), _mm_max_pd(a.high, b.high) };
+    }
+
+    INLINE lanes4 lanes4::sqrt(const lanes4& a) noexcept { return { _mm_sqrt_pd(a.low), _mm_sqrt_pd(a.high) }; }
+
+    INLINE lanes4 lanes4::select_less_equal(const lanes4& a, const lanes4& b, const lanes4& if_true,
+                                            const lanes4& if_false) noexcept {
+        // SSE2 has no blend, select with and/andnot instead
+        const __m128d low = _mm_cmple_pd(a.low, b.low);
+        const __m128d high = _mm_cmple_pd(a.high, b.high);
+        return { _mm_or_pd(_mm_and_pd(low, if_true.low), _mm_andnot_pd(low, if_false.low)),
+                 _mm_or_pd(_mm_and_pd(high, if_true.high), _mm_andnot_pd(high, if_false.high)) };
+    }
+
+    INLINE double lanes4::sum3() const noexcept {
+        return _mm_cvtsd_f64(_mm_add_sd(_mm_add_sd(low, _mm_unpackhi_pd(low, low)), high));
+    }
+
+    INLINE double lanes4::sum4() const noexcept { return sum3() + _mm_cvtsd_f64(_mm_unpackhi_pd(high, high)); }
+
+    INLINE lanes4 operator+(const lanes4& lhs, const lanes4& rhs) noexcept {
+        return { _mm_add_pd(lhs.low, rhs.low), _mm_add_pd(lhs.high, rhs.high) };
+    }
+
+    INLINE lanes4 operator-(const lanes4& lhs, const lanes4& rhs) noexcept {
+        return { _mm_sub_pd(lhs.low, rhs.low), _mm_sub_pd(lhs.high, rhs.high) };
+    }
+
+    INLINE lanes4 operator*(const lanes4& lhs, const lanes4& rhs) noexcept {
+        return { _mm_mul_pd(lhs.low, rhs.low), _mm_mul_pd(lhs.high, rhs.high) };
+    }
+
+    INLINE lanes4 operator/(const lanes4& lhs, const lanes4& rhs) noexcept {
+        return { _mm_div_pd(lhs.low, rhs.low), _mm_div_pd(lhs.high, rhs.high) };
+    }
+
+#else
+
+    INLINE lanes4 lanes4::set(double x, double y, double z, double w) noexcept { return { { x, y, z, w } }; }
+
+    INLINE lanes4 lanes4::broadcast(double value) noexcept { return { { value, value, value, value } }; }
+
+    INLINE lanes4 lanes4::load3(const double* values) noexcept { return { { values[0], values[1], values[2], 0 } }; }
+
+    INLINE lanes4 lanes4::load4(const double* values) noexcept {
+        return { { values[0], values[1], values[2], values[3] } };
+    }
+
+    INLINE void lanes4::store3(double* values) const noexcept {
+        for (int i = 0; i < 3; ++i) values[i] = value[i];
+    }
+
+    INLINE void lanes4::store4(double* values) const noexcept {
+        for (int i = 0; i < 4; ++i) values[i] = value[i];
+    }
+
+    INLINE void lanes4::store3(double& x, double& y, double& z) const noexcept {
+        x = value[0];
+        y = value[1];
+        z = value[2];
+    }
+
+    INLINE void lanes4::store4(double& x, double& y, double& z, double& w) const noexcept {
+        x = value[0];
+        y = value[1];
+        z = value[2];
+        w = value[3];
+    }
+
+    INLINE lanes4 lanes4::min(const lanes4& a, const lanes4& b) noexcept {
+        lanes4 result;
+        for (int i = 0; i < 4; ++i) result.value[i] = a.value[i] < b.value[i] ? a.value[i] : b.value[i];
+        return result;
+    }
+
+    INLINE lanes4 lanes4::max(const lanes4& a, const lanes4& b) noexcept {
+        lanes4 result;
+        for (int i = 0; i < 4; ++i) result.value[i] = a.value[i] > b.value[i] ? a.value[i] : b.value[i];
+        return result;
+    }
+
+    INLINE lanes4 lanes4::sqrt(const lanes4& a) noexcept {
+        lanes4 result;
+        for (int i = 0; i < 4; ++i) result.value[i] = std::sqrt(a.value[i]);
+        return result;
+    }
+
+    INLINE lanes4 lanes4::select_less_equal(const lanes4& a, const lanes4& b, const lanes4& if_true,
+                                            const lanes4& if_false) noexcept {
+        lanes4 result;
+        for (int i = 0; i < 4; ++i) result.value[i] = a.value[i] <= b.value[i] ? if_true.value[i] : if_false.value[i];
+        return result;
+    }
+
+    INLINE double lanes4::sum3() const noexcept { return value[0] + value[1] + value[2]; }
+
+    INLINE double lanes4::sum4() const noexcept { return value[0] + value[1] + value[2] + value[3]; }
+
+    INLINE lanes4 operator+(const lanes4& lhs, const lanes4& rhs) noexcept {
+        lanes4 result;
+        for (int i = 0; i < 4; ++i) result.value[i] = lhs.value[i] + rhs.value[i];
+        return result;
+    }
+
+    INLINE lanes4 operator-(const lanes4& lhs, const lanes4& rhs) noexcept {
+        lanes4 result;
+        for (int i = 0; i < 4; ++i) result.value[i] = lhs.value[i] - rhs.value[i];
+        return result;
+    }
+
+    INLINE lanes4 operator*(const lanes4& lhs, const lanes4& rhs) noexcept {
+        lanes4 result;
+        for (int i = 0; i < 4; ++i) result.value[i] = lhs.value[i] * rhs.value[i];
+        return result;
+    }
+
+    INLINE lanes4 operator/(const lanes4& lhs, const lanes4& rhs) noexcept {
+        lanes4 result;
+        for (int i = 0; i < 4; ++i) result.value[i] = lhs.value[i] / rhs.value[i];
+        return result;
+    }
+
+#endif
+
+    // lanes4 implementation end
+
+} // namespace bardrix
@@ -29,8 +29,12 @@ namespace bardrix {
     /// \brief (pi / 180) constant, used for converting degrees to radians
     INLINE constexpr double _pi_180 = 0.017453292519943295;
 
+    /// \brief The default epsilon value used for the nearly equal functions
+    INLINE constexpr double default_epsilon = 0.0001;
+
     /// \brief The epsilon value used for the nearly equal functions
-    INLINE double epsilon = 0.0001;
+    /// \note At compile time (constexpr) the nearly equal functions use default_epsilon, this value can't be read then
+    INLINE double epsilon = default_epsilon;
 
     /// \brief Converts degrees to radians
     /// \param degrees The degrees to convert
@@ -38,7 +42,7 @@ namespace bardrix {
     /// \tparam T The type of the degrees, e.g. int, float, double, etc.
     /// \details T must be an arithmetic type, (https://en.cppreference.com/w/cpp/types/is_arithmetic)
     template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
-    double degrees_to_radians(T degrees) noexcept {
+    constexpr double degrees_to_radians(T degrees) noexcept {
         return degrees * _pi_180;
     }
 
@@ -48,29 +52,47 @@ namespace bardrix {
     /// \tparam T The type of the radians, e.g. int, float, double, etc.
     /// \details T must be an arithmetic type, (https://en.cppreference.com/w/cpp/types/is_arithmetic)
     template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
-    double radians_to_degrees(T radians) noexcept {
+    constexpr double radians_to_degrees(T radians) noexcept {
         return radians * _180_pi;
     }
 
+    /// \brief Checks if the number is nearly equal to another number, within a given tolerance
+    /// \param lhs The first number
+    /// \param rhs The second number
+    /// \param tolerance The maximum difference between the numbers
+    /// \return True if the numbers are nearly equal, false otherwise
+    /// \example static_assert(bardrix::nearly_equal(0.1 + 0.2, 0.3, 1e-9));
+    NODISCARD constexpr bool nearly_equal(double lhs, double rhs, double tolerance) noexcept {
+        const double difference = lhs - rhs;
+        return (difference < 0 ? -difference : difference) <= tolerance;
+    }
+
     /// \brief Checks if the number is nearly equal to another number
     /// \param lhs The first number
     /// \param rhs The second number
     /// \return True if the numbers are nearly equal, false otherwise
-    /// \details It uses the epsilon value to check if the numbers are nearly equal
-    NODISCARD bool nearly_equal(double lhs, double rhs) noexcept;
+    /// \details It uses the epsilon value to check if the numbers are nearly equal, default_epsilon at compile time \n
+    ///          (only when is_constant_evaluated is supported, see BARDRIX_CONSTANT_EVALUATED)
+    NODISCARD constexpr bool nearly_equal(double lhs, double rhs) noexcept {
+        return nearly_equal(lhs, rhs, BARDRIX_CONSTANT_EVALUATED() ? default_epsilon : epsilon);
+    }
 
     /// \brief Checks if the number is greater than or nearly equal to another number
     /// \param lhs The first number
     /// \param rhs The second number
     /// \return True if the first number is greater than or nearly equal to the second number, false otherwise
     /// \details It uses the epsilon value to check if the numbers are nearly equal
-    NODISCARD bool greater_than_or_nearly_equal(double lhs, double rhs) noexcept;
+    NODISCARD constexpr bool greater_than_or_nearly_equal(double lhs, double rhs) noexcept {
+        return lhs > rhs || nearly_equal(lhs, rhs);
+    }
 
     /// \brief Checks if the number is less than or nearly equal to another number
     /// \param lhs The first number
     /// \param rhs The second number
     /// \return True if the first number is less than or nearly equal to the second number, false otherwise
     /// \details It uses the epsilon value to check if the numbers are nearly equal
-    NODISCARD bool less_than_or_nearly_equal(double lhs, double rhs) noexcept;
+    NODISCARD constexpr bool less_than_or_nearly_equal(double lhs, double rhs) noexcept {
+        return lhs < rhs || nearly_equal(lhs, rhs);
+    }
 
 } // namespace bardrix
\ No newline at end of file
@@ -0,0 +1,198 @@
+//
+// Created by Bardio on 16/10/2026.
+//
+
+#pragma once
+
+#include <bardrix/bardrix.h>
+#include <bardrix/objects.h>
+#include <bardrix/algorithm.h>
+
+namespace bardrix {
+
+    /// \brief Represents the vertex and index buffers of a triangle mesh, together with a BVH over its triangles. \n
+    ///        The buffers are shared by every triangle mesh that uses them, so a mesh is stored once.
+    /// \tparam T The type of the vertex coordinates, double or float (which halves the memory of the vertices).
+    /// \details The buffers are kept as given, the BVH references the triangles by index. \n
+    ///          Intersections are computed in double precision with the watertight ray-triangle test \n
+    ///          (Woop, Benthin and Wald), so a ray never slips through the shared edge of two triangles.
+    /// \example auto buffers = std::make_shared<bardrix::mesh_buffers<float>>(vertices, indices); \n
+    ///          bardrix::triangle_mesh_f mesh(buffers, bardrix::point3(0, 0, 10));
+    template<typename T>
+    class mesh_buffers {
+    public:
+        static_assert(std::is_floating_point_v<T>, "mesh_buffers only supports floating point vertices");
+
+        /// \brief The default maximum number of triangles in a leaf of the BVH.
+        static constexpr std::size_t default_leaf_size = 4;
+
+    private:
+        /// \brief The x, y and z of every vertex.
+        std::vector<T> vertices_;
+
+        /// \brief The indices of the three vertices of every triangle.
+        std::vector<std::uint32_t> indices_;
+
+        /// \brief The nodes of the BVH over the triangles, depth first, the root is the first node.
+        std::vector<bvh_node> nodes_;
+
+        /// \brief The triangle of every leaf primitive of the BVH.
+        std::vector<std::uint32_t> triangles_;
+
+    public:
+        /// \brief Constructs the buffers and the BVH over the triangles, using the surface area heuristic.
+        /// \param vertices The x, y and z of every vertex.
+        /// \param indices The indices of the three vertices of every triangle.
+        /// \param leaf_size The maximum number of triangles in a leaf of the BVH.
+        /// \param threads The number of threads used to construct the BVH, 0 uses all hardware threads.
+        /// \example bardrix::mesh_buffers<double> buffers({ 0, 0, 0, 1, 0, 0, 0, 1, 0 }, { 0, 1, 2 });
+        /// \details O(N log N) time complexity, where N is the number of triangles.
+        /// \throws std::invalid_argument If the number of vertex coordinates or indices is not a multiple of 3, \n
+        ///                               or an index is not a vertex.
+        explicit mesh_buffers(std::vector<T> vertices, std::vector<std::uint32_t> indices,
+                              std::size_t leaf_size = default_leaf_size, std::size_t threads = 1);
+
+        /// \brief Gets a vertex.
+        /// \param index The index of the vertex, it must be less than vertex_count().
+        /// \return The vertex.
+        NODISCARD bardrix::point3 vertex(std::size_t index) const noexcept;
+
+        /// \brief Gets the number of vertices.
+        /// \return The number of vertices.
+        NODISCARD std::size_t vertex_count() const noexcept;
+
+        /// \brief Gets the number of triangles.
+        /// \return The number of triangles.
+        NODISCARD std::size_t triangle_count() const noexcept;
+
+        /// \brief Gets the x, y and z of every vertex.
+        /// \return The vertex buffer.
+        NODISCARD const std::vector<T>& vertices() const noexcept;
+
+        /// \brief Gets the indices of the three vertices of every triangle.
+        /// \return The index buffer.
+        NODISCARD const std::vector<std::uint32_t>& indices() const noexcept;
+
+        /// \brief Gets the nodes of the BVH over the triangles.
+        /// \return The nodes, depth first, the root is the first node.
+        NODISCARD const std::vector<bvh_node>& nodes() const noexcept;
+
+        /// \brief Gets the bounding box of the triangles.
+        /// \return The bounding box of the triangles, an empty box at the origin if there are no triangles.
+        NODISCARD bardrix::bounding_box bounding_box() const noexcept;
+
+        /// \brief Gets the normal of a triangle, following the order of its vertices (counter clockwise).
+        /// \param triangle The index of the triangle, it must be less than triangle_count().
+        /// \return The normalized normal of the triangle.
+        NODISCARD bardrix::vector3 normal(std::size_t triangle) const;
+
+        /// \brief Gives the closest triangle that intersects with the given ray.
+        /// \param ray The ray to check, in the space of the vertices, only hits within ray.get_length() are considered.
+        /// \return The hit, hit::primitive is the index of the triangle, std::nullopt if no triangle is hit.
+        /// \example std::optional<bardrix::hit> hit = buffers.closest_hit(ray);
+        /// \details Both sides of a triangle are hit. It doesn't allocate.
+        NODISCARD std::optional<bardrix::hit> closest_hit(const bardrix::ray& ray) const;
+
+        /// \brief Checks if any triangle intersects with the given ray, e.g. a shadow ray towards a light.
+        /// \param ray The ray to check, in the space of the vertices, only hits within ray.get_length() are considered.
+        /// \return True if a triangle intersects with the ray, false otherwise.
+        NODISCARD bool occluded(const bardrix::ray& ray) const;
+
+        /// \brief Gets the normal of the triangle the point is on.
+        /// \param point The point, in the space of the vertices.
+        /// \return The normal of the closest triangle within bardrix::epsilon of the point, \n
+        ///         a zero vector if the point is not on the mesh.
+        /// \note closest_hit gives the normal together with the hit, which is faster.
+        NODISCARD bardrix::vector3 normal_at(const bardrix::point3& point) const;
+
+    }; // class mesh_buffers
+
+    /// \brief Triangle mesh shape, it references shared mesh_buffers and places them at its position. \n
+    ///        The mesh is one shape for a bvh_tree, its triangles have their own BVH in the buffers.
+    /// \tparam T The type of the vertex coordinates, double or float.
+    /// \example auto buffers = std::make_shared<bardrix::mesh_buffers<double>>(vertices, indices); \n
+    ///          auto mesh = std::make_shared<bardrix::triangle_mesh>(buffers, bardrix::point3(0, 0, 10)); \n
+    ///          std::optional<bardrix::hit> hit = mesh->intersect(ray);
+    template<typename T>
+    class basic_triangle_mesh : public bardrix::shape {
+    protected:
+        /// \brief The shared vertex and index buffers
+        std::shared_ptr<const mesh_buffers<T>> buffers_;
+
+        /// \brief The position of the mesh, added to every vertex
+        bardrix::point3 position_;
+
+        /// \brief Material of the mesh
+        bardrix::material material_;
+
+    public:
+        /// \brief Constructor for triangle mesh
+        /// \param buffers The shared vertex and index buffers
+        /// \param position The position of the mesh, added to every vertex
+        /// \param material The material of the mesh
+        /// \throws std::invalid_argument If the buffers are nullptr
+        explicit basic_triangle_mesh(std::shared_ptr<const mesh_buffers<T>> buffers,
+                                     const bardrix::point3& position = bardrix::point3(0, 0, 0),
+                                     const bardrix::material& material = bardrix::material());
+
+        /// \brief Constructor for triangle mesh, which creates its own buffers
+        /// \param vertices The x, y and z of every vertex
+        /// \param indices The indices of the three vertices of every triangle
+        /// \throws std::invalid_argument If the buffers are invalid, see mesh_buffers
+        basic_triangle_mesh(std::vector<T> vertices, std::vector<std::uint32_t> indices);
+
+        /// \brief Gets the shared vertex and index buffers
+        /// \return The buffers of the mesh
+        NODISCARD const std::shared_ptr<const mesh_buffers<T>>& buffers() const noexcept;
+
+        /// \brief Gets the material of the mesh
+        /// \return The material of the mesh
+        NODISCARD const bardrix::material& get_material() const override;
+
+        /// \brief Gets the position of the mesh
+        /// \return The position of the mesh
+        NODISCARD const bardrix::point3& get_position() const override;
+
+        /// \brief Sets the material of the mesh
+        /// \param material The material to set
+        void set_material(const bardrix::material& material) override;
+
+        /// \brief Sets the position of the mesh, this moves every vertex without changing the buffers
+        /// \param position The position to set
+        void set_position(const bardrix::point3& position) override;
+
+        /// \brief Get the normal at a point on the mesh
+        /// \param intersection The point to get the normal at
+        /// \return The normal of the triangle the point is on, a zero vector if the point is not on the mesh
+        /// \note intersect gives the normal together with the hit, which is faster
+        NODISCARD bardrix::vector3 normal_at(const bardrix::point3& intersection) const override;
+
+        /// \brief Get the intersection point of a ray with the closest triangle of the mesh
+        /// \param ray The ray to check for intersection
+        /// \return The intersection point if it exists, otherwise std::nullopt
+        NODISCARD std::optional<bardrix::point3> intersection(const bardrix::ray& ray) const override;
+
+        /// \brief Get the hit of a ray with the closest triangle of the mesh
+        /// \param ray The ray to check for intersection
+        /// \return The hit if it exists, hit::primitive is the index of the triangle, otherwise std::nullopt
+        /// \example std::optional<bardrix::hit> hit = mesh.intersect(ray);
+        NODISCARD std::optional<bardrix::hit> intersect(const bardrix::ray& ray) const override;
+
+        /// \brief Get the distance to the closest triangle of the mesh hit by a ray
+        /// \param ray The ray to check for intersection
+        /// \return The distance from the origin of the ray to the hit, infinity if there is no hit
+        NODISCARD double intersect_distance(const bardrix::ray& ray) const override;
+
+        /// \brief Get the bounding box of the mesh
+        /// \return The bounding box of the triangles, moved to the position of the mesh
+        NODISCARD bardrix::bounding_box bounding_box() const override;
+
+    }; // class basic_triangle_mesh
+
+    /// \brief A triangle mesh with double precision vertices.
+    using triangle_mesh = basic_triangle_mesh<double>;
+
+    /// \brief A triangle mesh with single precision (float) vertices, half the memory of triangle_mesh.
+    using triangle_mesh_f = basic_triangle_mesh<float>;
+
+} // namespace bardrix
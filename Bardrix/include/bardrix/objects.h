@@ -182,6 +182,14 @@ namespace bardrix {
         /// \example bounding_box.intersects(ray) -> true
         NODISCARD bool intersects(const bardrix::ray& ray) const noexcept;
 
+        /// \brief Check if a prepared ray hits the bounding box within [ray.t_min, ray.t_max]
+        /// \param ray The ray to check
+        /// \return True if the ray hits the bounding box, false otherwise
+        /// \details Uses the cached inverse direction and signs of the ray, there are no divisions or epsilon comparisons
+        /// \note If the ray is inside the bounding box, it will return true
+        /// \example bounding_box.intersects(traversal_ray(ray)) -> true
+        NODISCARD bool intersects(const bardrix::traversal_ray& ray) const noexcept;
+
         /// \brief Merges two bounding boxes
         /// \param box The bounding box to merge with
         /// \return A reference to the bounding box merged with the other bounding box
@@ -320,6 +328,23 @@ namespace bardrix {
 
     }; // class bounding_box
 
+    /// \brief The record of a ray hitting a shape, filled in one pass by shape::intersect
+    /// \details The position and normal are computed together with the distance, so shading doesn't compute them again
+    struct hit {
+        /// \brief The distance from the origin of the ray to the hit
+        double t;
+
+        /// \brief The point where the ray hits the shape
+        bardrix::point3 position;
+
+        /// \brief The normal of the shape at the hit, it's normalized
+        bardrix::vector3 normal;
+
+        /// \brief The primitive of the shape that was hit, 0 for shapes that consist of one primitive (e.g. sphere)
+        std::uint32_t primitive;
+
+    }; // struct hit
+
     /// \brief A pure virtual class for a 3D shape
     /// \details This class represents a 3D shape, such as a sphere or a plane
     /// \note This is but a base class, it can be inherited to create more complex materials
@@ -351,10 +376,31 @@ namespace bardrix {
         /// \return The normal of the shape at the point
         NODISCARD virtual bardrix::vector3 normal_at(const bardrix::point3& point) const = 0;
 
+        /// \brief Intersection of a ray with the shape, giving the distance, position, normal and primitive at once
+        /// \param ray The ray to intersect with
+        /// \return The hit, std::nullopt if the ray doesn't hit the shape (the same hits as intersection)
+        /// \example std::optional<bardrix::hit> hit = shape.intersect(ray);
+        /// \details The default calls intersection and normal_at, shapes can override it to share the work between them
+        NODISCARD virtual std::optional<bardrix::hit> intersect(const bardrix::ray& ray) const;
+
+        /// \brief Distance to the intersection of a ray with the shape, without the position or normal
+        /// \param ray The ray to intersect with
+        /// \return The distance from the origin of the ray to the hit, infinity if the ray doesn't hit the shape
+        /// \example double distance = shape.intersect_distance(ray);
+        /// \details The default calls intersection, shapes can override it to skip the point, this is used by bvh_tree
+        NODISCARD virtual double intersect_distance(const bardrix::ray& ray) const;
+
         /// \brief Gets the bounding box of the shape
         /// \return The bounding box of the shape
         NODISCARD virtual bardrix::bounding_box bounding_box() const = 0;
 
+        /// \brief Gets the bounding box of the part of the shape inside the given bounds
+        /// \param bounds The bounds to clip the shape to
+        /// \return The bounding box of the part of the shape inside the bounds, std::nullopt if no part is inside
+        /// \details The default is the overlap of bounding_box() and the bounds, shapes can override it with a tighter box
+        /// \note This is used by bvh_tree::construct_sbvh to split shapes over multiple leaves
+        NODISCARD virtual std::optional<bardrix::bounding_box> clipped_bounding_box(const bardrix::bounding_box& bounds) const;
+
         /// \brief Virtual destructor for shape
         virtual ~shape() = default;
 
@@ -430,11 +476,41 @@ namespace bardrix {
         /// \details If the intersection point is inside the sphere, it will return an std::nullopt
         NODISCARD std::optional<bardrix::point3> intersection(const bardrix::ray& ray) const override;
 
+        /// \brief Get the hit of a ray with the sphere, giving the distance, position and normal at once
+        /// \param ray The ray to check for intersection
+        /// \return The hit if it exists, otherwise std::nullopt (the same hits as intersection)
+        /// \example std::optional<bardrix::hit> hit = sphere.intersect(ray);
+        /// \details The normal is the vector from the center to the hit divided by the radius, it's not normalized again
+        NODISCARD std::optional<bardrix::hit> intersect(const bardrix::ray& ray) const override;
+
+        /// \brief Get the distance to the intersection of a ray with the sphere, without the position or normal
+        /// \param ray The ray to check for intersection
+        /// \return The distance from the origin of the ray to the intersection, infinity if there is no intersection
+        /// \example double distance = sphere.intersect_distance(ray);
+        NODISCARD double intersect_distance(const bardrix::ray& ray) const override;
+
+        /// \brief Get the distance to the intersection of a ray with a sphere, the steps of intersect
+        /// \param center The center of the sphere
+        /// \param radius The radius of the sphere
+        /// \param ray The ray to check for intersection
+        /// \return The distance from the origin of the ray to the intersection, infinity if there is no intersection
+        /// \example double distance = bardrix::sphere::intersect_distance(center, radius, ray);
+        /// \details It's defined in the header, so sphere, scene_sphere and sphere_soa share it without a call
+        NODISCARD static double intersect_distance(const bardrix::point3& center, double radius,
+                                                   const bardrix::ray& ray) noexcept;
+
         /// \brief Get the bounding box of the sphere
         /// \return The bounding box of the sphere
         /// \example bardrix::bounding_box box = sphere.bounding_box();
         NODISCARD bardrix::bounding_box bounding_box() const override;
 
+        /// \brief Get the bounding box of the part of the sphere inside the given bounds
+        /// \param bounds The bounds to clip the sphere to
+        /// \return The bounding box of the part of the sphere inside the bounds, std::nullopt if no part is inside
+        /// \example std::optional<bardrix::bounding_box> box = sphere.clipped_bounding_box(bounds);
+        /// \details The extent on an axis is limited by the distance to the bounds on the other two axes
+        NODISCARD std::optional<bardrix::bounding_box> clipped_bounding_box(const bardrix::bounding_box& bounds) const override;
+
         /// \brief Check if two spheres are equal
         /// \param sphere The sphere to compare with
         /// \return True if the spheres are equal, false otherwise
@@ -447,4 +523,36 @@ namespace bardrix {
 
     }; // class sphere
 
+    // sphere implementation start
+
+    INLINE double sphere::intersect_distance(const bardrix::point3& center, double radius,
+                                             const bardrix::ray& ray) noexcept {
+        // Get direction of the ray
+        const bardrix::vector3& direction = ray.get_direction();
+
+        // Gets vector from points: ray origin and sphere center
+        const bardrix::vector3 ray_to_sphere_vector = ray.position.vector_to(center);
+
+        // Get dot product of origin-center-vector and normalized direction
+        const double dot = ray_to_sphere_vector.dot(direction);
+
+        // The vector from the center of the sphere to the closest point on the ray, vec.dot(vec) == |vec|^2
+        const bardrix::vector3 closest = direction * dot - ray_to_sphere_vector;
+        const double distance_squared = closest.dot(closest);
+
+        // Radius^2
+        const double radius_squared = radius * radius;
+
+        if (distance_squared > radius_squared)
+            return std::numeric_limits<double>::infinity(); // A smart way to check if ray intersects before taking the sqrt
+
+        // Calculate distance to intersection
+        const double distance = dot - std::sqrt(radius_squared - distance_squared);
+
+        // If we intersect sphere return the length
+        return distance < ray.get_length() && distance > 0 ? distance : std::numeric_limits<double>::infinity();
+    }
+
+    // sphere implementation end
+
 } // namespace bardrix
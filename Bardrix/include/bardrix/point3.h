@@ -11,65 +11,152 @@
 namespace bardrix {
 
     /// \brief A 3D point class
-    /// \brief This class inherits from dimension3
-    class point3 : public dimension3 {
+    /// \brief This class inherits from dimension3, use point3 (double) or point3_f (float)
+    /// \tparam V The type of the values, float or double
+    template<typename V>
+    class basic_point3 : public basic_dimension3<V> {
 
     public:
         /// \brief Default constructor for point3, (0,0,0)
-        point3() = default;
+        basic_point3() = default;
 
         /// \brief Constructor for point3, initializes x, y and z
         /// \param x Initial x value
         /// \param y Initial y value
         /// \param z Initial z value
-        point3(double x, double y, double z);
+        constexpr basic_point3(V x, V y, V z);
+
+        /// \brief Converts a point3 of another precision, e.g. point3_f to point3
+        /// \tparam U The type of the values of the other point
+        /// \param point3 The point to convert
+        /// \example bardrix::point3_f vertex = bardrix::point3_f(bardrix::point3(1, 2, 3));
+        /// \note Converting double to float rounds every value to the nearest float
+        template<typename U>
+        constexpr explicit basic_point3(const basic_point3<U>& point3) noexcept;
 
         /// \brief Distance between two points
         /// \param point3 The other point
         /// \return The distance between the two points
-        NODISCARD double distance(const point3& point3) const noexcept;
+        NODISCARD V distance(const basic_point3& point3) const noexcept;
 
         /// \brief Distance between two points squared
         /// \param point3 The other point
         /// \details This method is faster than distance, as it does not calculate the square root
         /// \return The distance between the two points squared
-        NODISCARD double distance_squared(const point3& point3) const noexcept;
+        NODISCARD constexpr V distance_squared(const basic_point3& point3) const noexcept;
 
         /// \brief Midpoint between two points
         /// \param point3 The other point
         /// \return The midpoint between the two points
-        NODISCARD point3 midpoint(const point3& point3) const noexcept;
+        NODISCARD constexpr basic_point3 midpoint(const basic_point3& point3) const noexcept;
 
         /// \brief Create a vector from this point to another point
         /// \param point3 The other point
         /// \return The vector from this point to the other point
-        NODISCARD vector3 vector_to(const point3& point3) const noexcept;
+        NODISCARD constexpr basic_vector3<V> vector_to(const basic_point3& point3) const noexcept;
 
         /// \brief Add a vector to a point and returns a new point
         /// \param vector3 The vector to add
         /// \return The point with the vector added
-        NODISCARD point3 operator+(const vector3& vector3) const noexcept;
+        NODISCARD constexpr basic_point3 operator+(const basic_vector3<V>& vector3) const noexcept;
 
         /// \brief Add a vector to this point and returns a reference to this point
         /// \param vector3 The vector to add
         /// \return A reference to this point
-        point3& operator+=(const vector3& vector3) noexcept;
+        constexpr basic_point3& operator+=(const basic_vector3<V>& vector3) noexcept;
 
         /// \brief Subtract a vector from a point and returns a new point
         /// \param vector3 The vector to subtract
         /// \return The point with the vector subtracted
-        NODISCARD point3 operator-(const vector3& vector3) const noexcept;
+        NODISCARD constexpr basic_point3 operator-(const basic_vector3<V>& vector3) const noexcept;
 
         /// \brief Subtract a vector from this point and returns a reference to this point
         /// \param vector3 The vector to subtract
         /// \return A reference to this point
-        point3& operator-=(const vector3& vector3) noexcept;
+        constexpr basic_point3& operator-=(const basic_vector3<V>& vector3) noexcept;
 
         /// \brief Print the point to an output stream
         /// \param os The output stream
         /// \return The output stream
         std::ostream& print(std::ostream& os) const override;
 
-    }; // class point3
+    }; // class basic_point3
+
+    /// \brief A 3D point with double values
+    using point3 = basic_point3<double>;
+
+    /// \brief A 3D point with float values, for data which doesn't need double precision (e.g. vertices)
+    /// \note The virtual print of dimension3 keeps a table pointer in every value, so a point3_f is 24 bytes and a \n
+    ///       point3 32 bytes (64-bit), not half the size. Store large arrays in flat buffers, like mesh_buffers<float>.
+    using point3_f = basic_point3<float>;
+
+    // basic_point3 implementation start
+
+    template<typename V>
+    constexpr basic_point3<V>::basic_point3(V x, V y, V z) {
+        this->x = x;
+        this->y = y;
+        this->z = z;
+    }
+
+    template<typename V>
+    template<typename U>
+    constexpr basic_point3<V>::basic_point3(const basic_point3<U>& point3) noexcept
+            : basic_point3(static_cast<V>(point3.x), static_cast<V>(point3.y), static_cast<V>(point3.z)) {}
+
+    template<typename V>
+    INLINE V basic_point3<V>::distance(const basic_point3& point3) const noexcept {
+        return std::sqrt(distance_squared(point3));
+    }
+
+    template<typename V>
+    constexpr V basic_point3<V>::distance_squared(const basic_point3& point3) const noexcept {
+        const V dx = point3.x - this->x;
+        const V dy = point3.y - this->y;
+        const V dz = point3.z - this->z;
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    template<typename V>
+    constexpr basic_point3<V> basic_point3<V>::midpoint(const basic_point3& point3) const noexcept {
+        return { (this->x + point3.x) / 2, (this->y + point3.y) / 2, (this->z + point3.z) / 2 };
+    }
+
+    template<typename V>
+    constexpr basic_vector3<V> basic_point3<V>::vector_to(const basic_point3& point3) const noexcept {
+        return { point3.x - this->x, point3.y - this->y, point3.z - this->z };
+    }
+
+    template<typename V>
+    constexpr basic_point3<V> basic_point3<V>::operator+(const basic_vector3<V>& vector3) const noexcept {
+        basic_point3 copy = *this;
+        copy += vector3;
+        return copy;
+    }
+
+    template<typename V>
+    constexpr basic_point3<V>& basic_point3<V>::operator+=(const basic_vector3<V>& vector3) noexcept {
+        this->x += vector3.x;
+        this->y += vector3.y;
+        this->z += vector3.z;
+        return *this;
+    }
+
+    template<typename V>
+    constexpr basic_point3<V> basic_point3<V>::operator-(const basic_vector3<V>& vector3) const noexcept {
+        basic_point3 copy = *this;
+        copy -= vector3;
+        return copy;
+    }
+
+    template<typename V>
+    constexpr basic_point3<V>& basic_point3<V>::operator-=(const basic_vector3<V>& vector3) noexcept {
+        this->x -= vector3.x;
+        this->y -= vector3.y;
+        this->z -= vector3.z;
+        return *this;
+    }
+
+    // basic_point3 implementation end
 
 } // namespace bardrix
\ No newline at end of file
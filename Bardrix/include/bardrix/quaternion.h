@@ -109,6 +109,40 @@ namespace bardrix {
         NODISCARD static auto rotate_degrees(const T& dim3, const vector3& rotation_vector,
                                              double theta) noexcept -> dimension3::enable_if_dimension3<T, T>;
 
+        /// \brief Creates the quaternion of a rotation around an axis by an angle in radians
+        /// \param rotation_vector The axis to rotate around
+        /// \param theta The angle in radians
+        /// \return The unit quaternion of the rotation, the identity if the rotation vector is 0
+        /// \details q.rotate(dim3) is the same as quaternion::rotate_radians(dim3, rotation_vector, theta)
+        /// \example quaternion::rotation_radians(vector3(1, 0, 0), bardrix::pi).rotate(point3(1, 2, 3)) == point3(1, -2, -3)
+        NODISCARD static quaternion rotation_radians(const vector3& rotation_vector, double theta) noexcept;
+
+        /// \brief Creates the quaternion of a rotation around an axis by an angle in degrees
+        /// \param rotation_vector The axis to rotate around
+        /// \param theta The angle in degrees
+        /// \return The unit quaternion of the rotation, the identity if the rotation vector is 0
+        /// \details q.rotate(dim3) is the same as quaternion::rotate_degrees(dim3, rotation_vector, theta)
+        /// \example quaternion::rotation_degrees(vector3(1, 0, 0), 180).rotate(point3(1, 2, 3)) == point3(1, -2, -3)
+        NODISCARD static quaternion rotation_degrees(const vector3& rotation_vector, double theta) noexcept;
+
+        /// \brief Rotates a 3D object by this quaternion
+        /// \tparam T The type of the point, e.g. point3, vector3, etc.
+        /// \param dim3 The 3D object to rotate
+        /// \return The rotated 3D object
+        /// \details The quaternion should be a unit quaternion, e.g. from quaternion::rotation_radians
+        /// \example quaternion::rotation_degrees(vector3(1, 0, 0), 180).rotate(point3(1, 2, 3)) == point3(1, -2, -3)
+        template<class T>
+        NODISCARD auto rotate(const T& dim3) const noexcept -> dimension3::enable_if_dimension3<T, T>;
+
+        /// \brief Rotates a 3D object by the inverse of this quaternion, undoing rotate
+        /// \tparam T The type of the point, e.g. point3, vector3, etc.
+        /// \param dim3 The 3D object to rotate
+        /// \return The rotated 3D object
+        /// \details The quaternion should be a unit quaternion, e.g. from quaternion::rotation_radians
+        /// \example q.rotate_inverse(q.rotate(point)) == point
+        template<class T>
+        NODISCARD auto rotate_inverse(const T& dim3) const noexcept -> dimension3::enable_if_dimension3<T, T>;
+
         /// \brief Mirrors a 3D object around an axis
         /// \tparam T The type of the point, e.g. point3, vector3, etc.
         /// \param dim3 The 3D object to mirror
@@ -190,6 +224,26 @@ namespace bardrix {
         return rotate_radians(dim3, rotation_vector, degrees_to_radians(theta));
     }
 
+    template<class T>
+    auto quaternion::rotate(const T& dim3) const noexcept -> dimension3::enable_if_dimension3<T, T> {
+        //quaternion from given point
+        const quaternion p = quaternion(dim3.x, dim3.y, dim3.z, 0);
+
+        const quaternion result = (conjugated() * p) * *this;
+
+        return {result.x, result.y, result.z};
+    }
+
+    template<class T>
+    auto quaternion::rotate_inverse(const T& dim3) const noexcept -> dimension3::enable_if_dimension3<T, T> {
+        //quaternion from given point
+        const quaternion p = quaternion(dim3.x, dim3.y, dim3.z, 0);
+
+        const quaternion result = (*this * p) * conjugated();
+
+        return {result.x, result.y, result.z};
+    }
+
     // end of template functions
 
 } // bardrix
\ No newline at end of file
@@ -100,4 +100,54 @@ namespace bardrix {
 
     }; // class ray
 
+    /// \brief A ray prepared for many bounding box tests, e.g. during a traversal of a bvh_tree
+    /// \details The inverse direction and the sign of every axis are calculated once, \n
+    ///          so a slab test doesn't need divisions or epsilon comparisons
+    class traversal_ray {
+
+    public:
+        /// \brief The start of the interval along the ray that is tested, 0 by default
+        double t_min;
+
+        /// \brief The end of the interval along the ray that is tested, the length of the ray by default
+        /// \details Shrink it to skip everything behind a hit
+        double t_max;
+
+    private:
+        /// \brief The position of the ray, the origin
+        point3 origin_;
+
+        /// \brief The inverse of the direction of the ray (1 / direction), an axis with direction 0 is infinity
+        vector3 inverse_direction_;
+
+        /// \brief The sign of the direction for every axis (x, y, z), 1 if the direction is negative, 0 otherwise
+        std::uint8_t sign_[3];
+
+    public:
+        /// \brief Constructor for traversal_ray, the interval is [0, ray.get_length()]
+        /// \param ray The ray to prepare
+        explicit traversal_ray(const ray& ray) noexcept;
+
+        /// \brief Constructor for traversal_ray, with the given interval
+        /// \param ray The ray to prepare
+        /// \param t_min The start of the interval along the ray
+        /// \param t_max The end of the interval along the ray
+        traversal_ray(const ray& ray, double t_min, double t_max) noexcept;
+
+        /// \brief Get the origin of the ray
+        /// \return The origin of the ray
+        NODISCARD const point3& get_origin() const noexcept;
+
+        /// \brief Get the inverse direction of the ray
+        /// \return The inverse direction of the ray (1 / direction)
+        NODISCARD const vector3& get_inverse_direction() const noexcept;
+
+        /// \brief Get the sign of the direction of an axis
+        /// \param index The index of the axis, 0 for x, 1 for y and 2 for z
+        /// \return 1 if the direction is negative, 0 otherwise
+        /// \example traversal_ray(ray(vector3(1, -1, 0))).get_sign(1) -> 1
+        NODISCARD std::uint8_t get_sign(std::size_t index) const noexcept;
+
+    }; // class traversal_ray
+
 } // namespace bardrix
\ No newline at end of file
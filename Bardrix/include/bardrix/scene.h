@@ -0,0 +1,172 @@
+//
+// Created by Bardio on 16/10/2026.
+//
+
+#pragma once
+
+#include <bardrix/bardrix.h>
+#include <bardrix/objects.h>
+#include <bardrix/algorithm.h>
+
+namespace bardrix {
+
+    /// \brief The concrete shape types stored by a scene, every type has its own array.
+    enum class shape_type : std::uint8_t {
+        sphere = 0,
+    };
+
+    /// \brief Represents a sphere stored by value in a scene. \n
+    ///        It has no virtual functions and references its material by index, so it's 40 bytes instead of a full sphere.
+    /// \details The center is stored as plain doubles, like bvh_node, since point3 carries a virtual table pointer.
+    /// \example bardrix::scene_sphere sphere{ { 0, 0, 10 }, 1, material };
+    struct scene_sphere {
+        /// \brief The center of the sphere (x, y, z).
+        double center[3];
+
+        /// \brief The radius of the sphere.
+        double radius;
+
+        /// \brief The index of the material of the sphere in scene::materials().
+        std::uint32_t material;
+
+        /// \brief Gets the center of the sphere.
+        /// \return The center of the sphere.
+        NODISCARD bardrix::point3 position() const noexcept;
+
+        /// \brief Gets the bounding box of the sphere.
+        /// \return The bounding box of the sphere.
+        NODISCARD bardrix::bounding_box bounding_box() const noexcept;
+
+        /// \brief Gives the distance to the intersection of a ray with the sphere, the same hit as sphere::intersection.
+        /// \param ray The ray to check for intersection.
+        /// \return The distance from the origin of the ray to the intersection, \n
+        ///         infinity if the ray doesn't hit the sphere within ray.get_length().
+        /// \example double distance = sphere.intersect(ray);
+        /// \details If the origin of the ray is inside the sphere there is no hit, the same as sphere::intersection.
+        NODISCARD double intersect(const bardrix::ray& ray) const noexcept;
+
+        /// \brief Gets the normal at a point on the sphere.
+        /// \param point The point to get the normal at.
+        /// \return The normal at the point.
+        NODISCARD bardrix::vector3 normal_at(const bardrix::point3& point) const;
+
+    }; // struct scene_sphere
+
+    static_assert(sizeof(scene_sphere) == 40, "scene_sphere must stay 40 bytes");
+
+    /// \brief The closest hit of a ray in a scene.
+    struct scene_hit {
+        /// \brief The type of the hit shape.
+        bardrix::shape_type type;
+
+        /// \brief The index of the hit shape in the array of its type, e.g. scene::spheres().
+        std::uint32_t index;
+
+        /// \brief The distance from the origin of the ray to the intersection.
+        double distance;
+
+    }; // struct scene_hit
+
+    /// \brief Represents a scene which stores every concrete shape type in its own contiguous array, \n
+    ///        starting with spheres. The materials are stored once and referenced by index.
+    /// \details Every type has its own BVH, the intersection of a type is called directly instead of through a \n
+    ///          virtual function, so it can be inlined into the traversal.
+    /// \example bardrix::scene scene; \n
+    ///          std::uint32_t red = scene.add_material(bardrix::material(0.1, 0.9, 0, 1, bardrix::color::red())); \n
+    ///          scene.add_sphere(bardrix::point3(0, 0, 10), 1, red); \n
+    ///          scene.construct(); \n
+    ///          std::optional<bardrix::scene_hit> hit = scene.closest_hit(ray);
+    class scene {
+    public:
+        /// \brief The default maximum number of shapes in a leaf of the BVH of a type.
+        static constexpr std::size_t default_leaf_size = 4;
+
+    private:
+        /// \brief The materials, referenced by index.
+        std::vector<bardrix::material> materials_;
+
+        /// \brief The spheres, in the order they were added.
+        std::vector<bardrix::scene_sphere> spheres_;
+
+        /// \brief The nodes of the BVH of the spheres, depth first, the root is the first node.
+        std::vector<bvh_node> sphere_nodes_;
+
+        /// \brief A copy of the spheres in the order of the leaves of their BVH, so the spheres of a leaf are next to each other.
+        std::vector<bardrix::scene_sphere> sphere_leaves_;
+
+        /// \brief The index in spheres_ of every sphere in sphere_leaves_.
+        std::vector<std::uint32_t> sphere_indices_;
+
+    public:
+        explicit scene();
+
+        /// \brief Adds a material to the scene.
+        /// \param material The material to add.
+        /// \return The index of the material, used by the shapes.
+        /// \example std::uint32_t red = scene.add_material(material);
+        std::uint32_t add_material(const bardrix::material& material);
+
+        /// \brief Adds a sphere to the scene.
+        /// \param position The center of the sphere.
+        /// \param radius The radius of the sphere, if it's less than 0 it will be set to 0.
+        /// \param material The index of the material of the sphere, from add_material.
+        /// \return The index of the sphere in spheres().
+        /// \example scene.add_sphere(bardrix::point3(0, 0, 10), 1, red);
+        /// \throws std::invalid_argument If the material is not in the scene.
+        /// \note The sphere is not hit until construct is called.
+        std::uint32_t add_sphere(const bardrix::point3& position, double radius, std::uint32_t material);
+
+        /// \brief Constructs the BVH of every shape type using the surface area heuristic, \n
+        ///        the same as bvh_tree::construct_sah.
+        /// \param leaf_size The maximum number of shapes in a leaf, every subtree of at most leaf_size shapes becomes one leaf.
+        /// \param bins The number of bins used per axis to evaluate the split candidates.
+        /// \param threads The number of threads to use, 0 uses all hardware threads.
+        /// \example scene.construct();
+        /// \details O(N log N) time complexity, where N is the number of shapes.
+        void construct(std::size_t leaf_size = default_leaf_size, std::size_t bins = bvh_tree::default_sah_bins,
+                       std::size_t threads = 1);
+
+        /// \brief Gives the closest shape of any type that intersects with the given ray.
+        /// \param ray The ray to check for intersections with the shapes, only hits within ray.get_length() are considered.
+        /// \return The closest hit, std::nullopt if no shape intersects with the ray.
+        /// \example std::optional<bardrix::scene_hit> hit = scene.closest_hit(ray); \n
+        ///          if (hit) const bardrix::material& material = scene.material_of(*hit);
+        /// \details The types are traversed one after another, a hit shortens the ray for the next types. \n
+        ///          It doesn't allocate.
+        NODISCARD std::optional<bardrix::scene_hit> closest_hit(const bardrix::ray& ray) const;
+
+        /// \brief Checks if any shape intersects with the given ray, e.g. a shadow ray towards a light.
+        /// \param ray The ray to check for intersections with the shapes, only hits within ray.get_length() are considered.
+        /// \return True if a shape intersects with the ray, false otherwise.
+        /// \example bool in_shadow = scene.occluded(shadow_ray);
+        NODISCARD bool occluded(const bardrix::ray& ray) const;
+
+        /// \brief Gets the normal of the hit shape at a point.
+        /// \param hit The hit, from closest_hit.
+        /// \param point The point on the shape, e.g. ray.point_at(hit.distance).
+        /// \return The normal at the point.
+        NODISCARD bardrix::vector3 normal_at(const bardrix::scene_hit& hit, const bardrix::point3& point) const;
+
+        /// \brief Gets the material of the hit shape.
+        /// \param hit The hit, from closest_hit.
+        /// \return The material of the shape.
+        NODISCARD const bardrix::material& material_of(const bardrix::scene_hit& hit) const;
+
+        /// \brief Gets the materials of the scene.
+        /// \return The materials, in the order they were added.
+        NODISCARD const std::vector<bardrix::material>& materials() const noexcept;
+
+        /// \brief Gets the spheres of the scene.
+        /// \return The spheres, in the order they were added.
+        NODISCARD const std::vector<bardrix::scene_sphere>& spheres() const noexcept;
+
+        /// \brief Checks if the scene is empty.
+        /// \return True if the scene has no shapes, false otherwise.
+        NODISCARD bool is_empty() const noexcept;
+
+        /// \brief Clears the scene, removing all shapes and materials.
+        void clear() noexcept;
+
+    }; // class scene
+
+} // namespace bardrix
@@ -0,0 +1,294 @@
+//
+// Created by Bardio on 16/10/2026.
+//
+
+#pragma once
+
+#include <bardrix/bardrix.h>
+#include <bardrix/objects.h>
+
+namespace bardrix {
+
+    /// \brief The number of doubles processed by one SIMD instruction, 1 if there is no SIMD support.
+#if defined(BARDRIX_SIMD_AVX)
+    constexpr std::size_t simd_width = 4;
+#elif defined(BARDRIX_SIMD_SSE2)
+    constexpr std::size_t simd_width = 2;
+#else
+    constexpr std::size_t simd_width = 1;
+#endif
+
+    /// \brief Represents N bounding boxes stored as a structure of arrays (SoA), so one ray can be tested against all \n
+    ///        of them at once with SIMD instructions.
+    /// \tparam N The number of bounding boxes, 4 or 8.
+    /// \details Every bound has its own array (min_x[N], min_y[N], ..., max_z[N]). \n
+    ///          A lane without a bounding box is empty, it stores min = infinity and max = -infinity and is never hit.
+    /// \example bardrix::bounding_box4 pack; \n
+    ///          pack.set(0, sphere.bounding_box()); \n
+    ///          double entry[4]; \n
+    ///          std::uint32_t mask = pack.intersects(bardrix::traversal_ray(ray), entry);
+    template<std::size_t N>
+    struct bounding_box_pack {
+        static_assert(N == 4 || N == 8, "bounding_box_pack only supports 4 or 8 bounding boxes");
+
+        /// \brief The number of bounding boxes in the pack.
+        static constexpr std::size_t size = N;
+
+        /// \brief The minimum x of every bounding box.
+        alignas(32) double min_x[N];
+
+        /// \brief The minimum y of every bounding box.
+        alignas(32) double min_y[N];
+
+        /// \brief The minimum z of every bounding box.
+        alignas(32) double min_z[N];
+
+        /// \brief The maximum x of every bounding box.
+        alignas(32) double max_x[N];
+
+        /// \brief The maximum y of every bounding box.
+        alignas(32) double max_y[N];
+
+        /// \brief The maximum z of every bounding box.
+        alignas(32) double max_z[N];
+
+        /// \brief Constructs a pack where every lane is empty.
+        bounding_box_pack() noexcept;
+
+        /// \brief Sets the bounding box of a lane.
+        /// \param lane The lane to set, it must be less than N.
+        /// \param box The bounding box to store in the lane.
+        void set(std::size_t lane, const bardrix::bounding_box& box) noexcept;
+
+        /// \brief Makes a lane empty, so it's never hit.
+        /// \param lane The lane to clear, it must be less than N.
+        void clear(std::size_t lane) noexcept;
+
+        /// \brief Checks if a lane is empty.
+        /// \param lane The lane to check, it must be less than N.
+        /// \return True if the lane has no bounding box, false otherwise.
+        NODISCARD bool is_empty(std::size_t lane) const noexcept;
+
+        /// \brief Tests one ray against all bounding boxes within [ray.t_min, ray.t_max], the same way as \n
+        ///        bounding_box::intersects(traversal_ray).
+        /// \param ray The ray to check.
+        /// \param entry The distance at which the ray enters every bounding box (at least ray.t_min), \n
+        ///              infinity for the bounding boxes that are not hit.
+        /// \return A mask where bit i is set if the ray hits bounding box i.
+        /// \details Uses AVX (4 doubles) or SSE2 (2 doubles) when the compiler enables it, otherwise a scalar loop. \n
+        ///          There are no divisions, branches or epsilon comparisons per bounding box.
+        NODISCARD std::uint32_t intersects(const bardrix::traversal_ray& ray, double (& entry)[N]) const noexcept;
+
+    }; // struct bounding_box_pack
+
+    /// \brief 4 bounding boxes stored as a structure of arrays.
+    using bounding_box4 = bounding_box_pack<4>;
+
+    /// \brief 8 bounding boxes stored as a structure of arrays.
+    using bounding_box8 = bounding_box_pack<8>;
+
+    /// \brief The closest hit of a ray in a batch of shapes.
+    struct batch_hit {
+        /// \brief The index of the hit shape in the batch.
+        std::uint32_t index;
+
+        /// \brief The distance from the origin of the ray to the intersection.
+        double distance;
+
+    }; // struct batch_hit
+
+    /// \brief Represents spheres stored as a structure of arrays (SoA), so one ray can be intersected with many \n
+    ///        spheres at once with SIMD instructions.
+    /// \details Every component has its own array (x[], y[], z[], radius[]), so simd_width spheres are loaded at once.
+    /// \example bardrix::sphere_soa spheres; \n
+    ///          spheres.push_back(bardrix::point3(0, 0, 10), 1); \n
+    ///          std::optional<bardrix::batch_hit> hit = spheres.closest_hit(ray);
+    class sphere_soa {
+    private:
+        /// \brief The x of the center of every sphere.
+        std::vector<double> x_;
+
+        /// \brief The y of the center of every sphere.
+        std::vector<double> y_;
+
+        /// \brief The z of the center of every sphere.
+        std::vector<double> z_;
+
+        /// \brief The radius of every sphere.
+        std::vector<double> radius_;
+
+    public:
+        explicit sphere_soa();
+
+        /// \brief Adds a sphere.
+        /// \param center The center of the sphere.
+        /// \param radius The radius of the sphere, if it's less than 0 it will be set to 0.
+        void push_back(const bardrix::point3& center, double radius);
+
+        /// \brief Reserves memory for the given number of spheres.
+        /// \param size The number of spheres.
+        void reserve(std::size_t size);
+
+        /// \brief Gets the center of a sphere.
+        /// \param index The index of the sphere, it must be less than size().
+        /// \return The center of the sphere.
+        NODISCARD bardrix::point3 center(std::size_t index) const noexcept;
+
+        /// \brief Gets the radius of a sphere.
+        /// \param index The index of the sphere, it must be less than size().
+        /// \return The radius of the sphere.
+        NODISCARD double radius(std::size_t index) const noexcept;
+
+        /// \brief Gets the number of spheres.
+        /// \return The number of spheres.
+        NODISCARD std::size_t size() const noexcept;
+
+        /// \brief Removes all spheres.
+        void clear() noexcept;
+
+        /// \brief Gives the closest sphere that intersects with the given ray, the same hits as sphere::intersection.
+        /// \param ray The ray to check, only hits within ray.get_length() are considered.
+        /// \return The index of the closest sphere and the distance to it, std::nullopt if no sphere is hit.
+        /// \example std::optional<bardrix::batch_hit> hit = spheres.closest_hit(ray);
+        /// \details Uses AVX (4 spheres) or SSE2 (2 spheres) when the compiler enables it, otherwise a scalar loop. \n
+        ///          There are no branches per sphere, every lane keeps its own closest hit until the end.
+        /// \note If two spheres are hit at the same distance, the lowest index is given.
+        NODISCARD std::optional<batch_hit> closest_hit(const bardrix::ray& ray) const noexcept;
+
+        /// \brief Gives the closest sphere in a range that intersects with the given ray, e.g. the spheres of a leaf.
+        /// \param ray The ray to check, only hits within ray.get_length() are considered.
+        /// \param first The index of the first sphere of the range.
+        /// \param last The index after the last sphere of the range, it must not be more than size().
+        /// \return The index of the closest sphere and the distance to it, std::nullopt if no sphere is hit.
+        /// \example std::optional<bardrix::batch_hit> hit = spheres.closest_hit(ray, node.offset, node.offset + node.count);
+        NODISCARD std::optional<batch_hit> closest_hit(const bardrix::ray& ray, std::size_t first,
+                                                       std::size_t last) const noexcept;
+
+    }; // class sphere_soa
+
+    // bounding_box_pack implementation start
+
+    template<std::size_t N>
+    bounding_box_pack<N>::bounding_box_pack() noexcept {
+        for (std::size_t lane = 0; lane < N; ++lane)
+            clear(lane);
+    }
+
+    template<std::size_t N>
+    void bounding_box_pack<N>::set(std::size_t lane, const bardrix::bounding_box& box) noexcept {
+        min_x[lane] = box.get_min().x;
+        min_y[lane] = box.get_min().y;
+        min_z[lane] = box.get_min().z;
+        max_x[lane] = box.get_max().x;
+        max_y[lane] = box.get_max().y;
+        max_z[lane] = box.get_max().z;
+    }
+
+    template<std::size_t N>
+    void bounding_box_pack<N>::clear(std::size_t lane) noexcept {
+        min_x[lane] = min_y[lane] = min_z[lane] = std::numeric_limits<double>::infinity();
+        max_x[lane] = max_y[lane] = max_z[lane] = -std::numeric_limits<double>::infinity();
+    }
+
+    template<std::size_t N>
+    bool bounding_box_pack<N>::is_empty(std::size_t lane) const noexcept {
+        return min_x[lane] > max_x[lane];
+    }
+
+    template<std::size_t N>
+    std::uint32_t bounding_box_pack<N>::intersects(const bardrix::traversal_ray& ray,
+                                                   double (& entry)[N]) const noexcept {
+        const bardrix::point3& origin = ray.get_origin();
+        const bardrix::vector3& inverse_direction = ray.get_inverse_direction();
+
+        // The near plane of an axis is the max bound if the direction is negative, this is the same for every lane
+        const double* near_x = ray.get_sign(0) ? max_x : min_x;
+        const double* far_x = ray.get_sign(0) ? min_x : max_x;
+        const double* near_y = ray.get_sign(1) ? max_y : min_y;
+        const double* far_y = ray.get_sign(1) ? min_y : max_y;
+        const double* near_z = ray.get_sign(2) ? max_z : min_z;
+        const double* far_z = ray.get_sign(2) ? min_z : max_z;
+
+        std::uint32_t mask = 0;
+
+#if defined(BARDRIX_SIMD_AVX)
+        const __m256d origin_x = _mm256_set1_pd(origin.x);
+        const __m256d origin_y = _mm256_set1_pd(origin.y);
+        const __m256d origin_z = _mm256_set1_pd(origin.z);
+        const __m256d inverse_x = _mm256_set1_pd(inverse_direction.x);
+        const __m256d inverse_y = _mm256_set1_pd(inverse_direction.y);
+        const __m256d inverse_z = _mm256_set1_pd(inverse_direction.z);
+        const __m256d t_min = _mm256_set1_pd(ray.t_min);
+        const __m256d t_max = _mm256_set1_pd(ray.t_max);
+        const __m256d infinity = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+
+        for (std::size_t i = 0; i < N; i += 4) {
+            // max and min return the second operand if the first is NaN, so NaN leaves the interval as is
+            __m256d t_near = _mm256_max_pd(_mm256_mul_pd(_mm256_sub_pd(_mm256_load_pd(near_x + i), origin_x), inverse_x), t_min);
+            t_near = _mm256_max_pd(_mm256_mul_pd(_mm256_sub_pd(_mm256_load_pd(near_y + i), origin_y), inverse_y), t_near);
+            t_near = _mm256_max_pd(_mm256_mul_pd(_mm256_sub_pd(_mm256_load_pd(near_z + i), origin_z), inverse_z), t_near);
+
+            __m256d t_far = _mm256_min_pd(_mm256_mul_pd(_mm256_sub_pd(_mm256_load_pd(far_x + i), origin_x), inverse_x), t_max);
+            t_far = _mm256_min_pd(_mm256_mul_pd(_mm256_sub_pd(_mm256_load_pd(far_y + i), origin_y), inverse_y), t_far);
+            t_far = _mm256_min_pd(_mm256_mul_pd(_mm256_sub_pd(_mm256_load_pd(far_z + i), origin_z), inverse_z), t_far);
+
+            const __m256d hit = _mm256_cmp_pd(t_near, t_far, _CMP_LE_OQ);
+            _mm256_storeu_pd(entry + i, _mm256_blendv_pd(infinity, t_near, hit));
+            mask |= static_cast<std::uint32_t>(_mm256_movemask_pd(hit)) << i;
+        }
+#elif defined(BARDRIX_SIMD_SSE2)
+        const __m128d origin_x = _mm_set1_pd(origin.x);
+        const __m128d origin_y = _mm_set1_pd(origin.y);
+        const __m128d origin_z = _mm_set1_pd(origin.z);
+        const __m128d inverse_x = _mm_set1_pd(inverse_direction.x);
+        const __m128d inverse_y = _mm_set1_pd(inverse_direction.y);
+        const __m128d inverse_z = _mm_set1_pd(inverse_direction.z);
+        const __m128d t_min = _mm_set1_pd(ray.t_min);
+        const __m128d t_max = _mm_set1_pd(ray.t_max);
+        const __m128d infinity = _mm_set1_pd(std::numeric_limits<double>::infinity());
+
+        for (std::size_t i = 0; i < N; i += 2) {
+            // max and min return the second operand if the first is NaN, so NaN leaves the interval as is
+            __m128d t_near = _mm_max_pd(_mm_mul_pd(_mm_sub_pd(_mm_load_pd(near_x + i), origin_x), inverse_x), t_min);
+            t_near = _mm_max_pd(_mm_mul_pd(_mm_sub_pd(_mm_load_pd(near_y + i), origin_y), inverse_y), t_near);
+            t_near = _mm_max_pd(_mm_mul_pd(_mm_sub_pd(_mm_load_pd(near_z + i), origin_z), inverse_z), t_near);
+
+            __m128d t_far = _mm_min_pd(_mm_mul_pd(_mm_sub_pd(_mm_load_pd(far_x + i), origin_x), inverse_x), t_max);
+            t_far = _mm_min_pd(_mm_mul_pd(_mm_sub_pd(_mm_load_pd(far_y + i), origin_y), inverse_y), t_far);
+            t_far = _mm_min_pd(_mm_mul_pd(_mm_sub_pd(_mm_load_pd(far_z + i), origin_z), inverse_z), t_far);
+
+            // SSE2 has no blend, select with and/andnot instead
+            const __m128d hit = _mm_cmple_pd(t_near, t_far);
+            _mm_storeu_pd(entry + i, _mm_or_pd(_mm_and_pd(hit, t_near), _mm_andnot_pd(hit, infinity)));
+            mask |= static_cast<std::uint32_t>(_mm_movemask_pd(hit)) << i;
+        }
+#else
+        for (std::size_t i = 0; i < N; ++i) {
+            // NaN fails the comparisons and leaves the interval as is
+            double t_near = ray.t_min;
+            double t_far = ray.t_max;
+            const double tx_near = (near_x[i] - origin.x) * inverse_direction.x;
+            const double ty_near = (near_y[i] - origin.y) * inverse_direction.y;
+            const double tz_near = (near_z[i] - origin.z) * inverse_direction.z;
+            const double tx_far = (far_x[i] - origin.x) * inverse_direction.x;
+            const double ty_far = (far_y[i] - origin.y) * inverse_direction.y;
+            const double tz_far = (far_z[i] - origin.z) * inverse_direction.z;
+            t_near = tx_near > t_near ? tx_near : t_near;
+            t_near = ty_near > t_near ? ty_near : t_near;
+            t_near = tz_near > t_near ? tz_near : t_near;
+            t_far = tx_far < t_far ? tx_far : t_far;
+            t_far = ty_far < t_far ? ty_far : t_far;
+            t_far = tz_far < t_far ? tz_far : t_far;
+
+            const bool hit = t_near <= t_far;
+            entry[i] = hit ? t_near : std::numeric_limits<double>::infinity();
+            mask |= static_cast<std::uint32_t>(hit) << i;
+        }
+#endif
+
+        return mask;
+    }
+
+    // bounding_box_pack implementation end
+
+} // namespace bardrix
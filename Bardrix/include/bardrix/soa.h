@@ -0,0 +1,157 @@
+//
+// Created by Bardio on 16/10/2026.
+//
+
+#pragma once
+
+#include <bardrix/bardrix.h>
+#include <bardrix/vector3.h>
+#include <bardrix/point3.h>
+#include <bardrix/quaternion.h>
+
+namespace bardrix {
+
+    /// \brief Represents many vector3 or point3 stored as a structure of arrays (SoA), every component has its own \n
+    ///        contiguous array (x[], y[], z[]), so the batch operations process 4 elements at once with lanes4.
+    /// \tparam T The type of the elements, vector3 or point3.
+    /// \details Every batch operation gives the same results as the operation on a single vector3 or point3, the SIMD \n
+    ///          loop and the scalar loop for the last elements compute every element in the same order.
+    /// \note Use vector3_soa or point3_soa, this class only has the operations which are the same for both.
+    template<typename T>
+    class basic_dimension3_soa {
+    protected:
+        /// \brief The x of every element.
+        std::vector<double> x_;
+
+        /// \brief The y of every element.
+        std::vector<double> y_;
+
+        /// \brief The z of every element.
+        std::vector<double> z_;
+
+    public:
+        explicit basic_dimension3_soa();
+
+        /// \brief Constructs the arrays from elements.
+        /// \param values The elements, in order.
+        explicit basic_dimension3_soa(const std::vector<T>& values);
+
+        /// \brief Adds an element.
+        /// \param value The element.
+        void push_back(const T& value);
+
+        /// \brief Reserves memory for the given number of elements.
+        /// \param size The number of elements.
+        void reserve(std::size_t size);
+
+        /// \brief Changes the number of elements, new elements are (0, 0, 0).
+        /// \param size The number of elements.
+        void resize(std::size_t size);
+
+        /// \brief Gets an element.
+        /// \param index The index of the element, it must be less than size().
+        /// \return The element.
+        NODISCARD T get(std::size_t index) const noexcept;
+
+        /// \brief Sets an element.
+        /// \param index The index of the element, it must be less than size().
+        /// \param value The element.
+        void set(std::size_t index, const T& value) noexcept;
+
+        /// \brief Gets the number of elements.
+        /// \return The number of elements.
+        NODISCARD std::size_t size() const noexcept;
+
+        /// \brief Removes all elements.
+        void clear() noexcept;
+
+        /// \brief Gets the array of one component, e.g. to update the elements directly.
+        /// \param axis The component, axis::x, axis::y or axis::z.
+        /// \return The array of the component, it has size() values.
+        /// \throws std::invalid_argument If the axis is invalid
+        /// \example double* heights = points.data(bardrix::axis::y);
+        NODISCARD double* data(axis axis);
+
+        /// \brief Gets the array of one component.
+        /// \param axis The component, axis::x, axis::y or axis::z.
+        /// \return The array of the component, it has size() values.
+        /// \throws std::invalid_argument If the axis is invalid
+        NODISCARD const double* data(axis axis) const;
+
+        /// \brief Rotates every element by a quaternion, the same as rotation.rotate(element).
+        /// \param rotation The rotation, it should be a unit quaternion, e.g. from quaternion::rotation_radians.
+        /// \example normals.rotate(bardrix::quaternion::rotation_degrees(bardrix::vector3(0, 1, 0), 90));
+        void rotate(const quaternion& rotation) noexcept;
+
+    }; // class basic_dimension3_soa
+
+    /// \brief Represents many vector3 stored as a structure of arrays, with batch operations (e.g. for normals).
+    /// \example bardrix::vector3_soa normals(vectors); \n
+    ///          normals.normalize(); \n
+    ///          std::vector<double> dots; \n
+    ///          normals.dot(light_directions, dots);
+    class vector3_soa : public basic_dimension3_soa<vector3> {
+    public:
+        using basic_dimension3_soa::basic_dimension3_soa;
+
+        /// \brief Normalizes every vector, the same as vector3::normalize.
+        /// \details A vector with a length of 0 stays the same, without a branch per vector.
+        void normalize() noexcept;
+
+        /// \brief Calculates the length of every vector, the same as vector3::length.
+        /// \param out_lengths The lengths, it's resized to size().
+        void length(std::vector<double>& out_lengths) const;
+
+        /// \brief Calculates the dot product of every vector with the vector at the same index, the same as vector3::dot.
+        /// \param vectors The other vectors, it must have the same size.
+        /// \param out_dots The dot products, it's resized to size().
+        /// \throws std::invalid_argument If the sizes are different
+        void dot(const vector3_soa& vectors, std::vector<double>& out_dots) const;
+
+        /// \brief Calculates the cross product of every vector with the vector at the same index, the same as vector3::cross.
+        /// \param vectors The other vectors, it must have the same size.
+        /// \param out_crosses The cross products, it's resized to size(), it may be this or vectors.
+        /// \throws std::invalid_argument If the sizes are different
+        void cross(const vector3_soa& vectors, vector3_soa& out_crosses) const;
+
+        /// \brief Adds the vector at the same index to every vector (vector += vectors[i]).
+        /// \param vectors The vectors to add, it must have the same size.
+        /// \throws std::invalid_argument If the sizes are different
+        void add(const vector3_soa& vectors);
+
+        /// \brief Multiplies every vector by a scalar (vector *= n).
+        /// \param n The scalar.
+        void scale(double n) noexcept;
+
+    }; // class vector3_soa
+
+    /// \brief Represents many point3 stored as a structure of arrays, with batch operations (e.g. for particles).
+    /// \example bardrix::point3_soa particles(positions); \n
+    ///          particles.add(velocities, delta_time); \n
+    ///          std::vector<double> distances; \n
+    ///          particles.distance(camera.position, distances);
+    class point3_soa : public basic_dimension3_soa<point3> {
+    public:
+        using basic_dimension3_soa::basic_dimension3_soa;
+
+        /// \brief Moves every point by the vector at the same index (point += vectors[i] * scale).
+        /// \param vectors The vectors to add, it must have the same size.
+        /// \param scale The scale of the vectors, e.g. the time step of a velocity.
+        /// \throws std::invalid_argument If the sizes are different
+        /// \example particles.add(velocities, 0.016);
+        void add(const vector3_soa& vectors, double scale = 1);
+
+        /// \brief Calculates the distance of every point to a point, the same as point3::distance.
+        /// \param point The other point.
+        /// \param out_distances The distances, it's resized to size().
+        void distance(const point3& point, std::vector<double>& out_distances) const;
+
+        /// \brief Calculates the distance of every point to the point at the same index, the same as point3::distance.
+        /// \param points The other points, it must have the same size.
+        /// \param out_distances The distances, it's resized to size().
+        /// \throws std::invalid_argument If the sizes are different
+        void distance(const point3_soa& points, std::vector<double>& out_distances) const;
+
+    }; // class point3_soa
+
+} // namespace bardrix
@@ -10,50 +10,73 @@
 namespace bardrix {
 
     /// \brief A 3D vector class
-    /// \details This class inherits from dimension3
-    class vector3 : public dimension3 {
+    /// \tparam V The type of the values, float or double
+    /// \details This class inherits from dimension3, use vector3 (double) or vector3_f (float)
+    template<typename V>
+    class basic_vector3 : public basic_dimension3<V> {
 
     public:
         /// \brief Default constructor for vector3, initializes x, y and z to 0
-        vector3() noexcept = default;
+        basic_vector3() noexcept = default;
 
         /// \brief Constructor for vector3, initializes x, y and z
         /// \param x Initial x value
         /// \param y Initial y value
         /// \param z Initial z value
-        vector3(double x, double y, double z);
+        constexpr basic_vector3(V x, V y, V z);
+
+        /// \brief Converts a vector3 of another precision, e.g. vector3_f to vector3
+        /// \tparam U The type of the values of the other vector
+        /// \param vec3 The vector to convert
+        /// \example bardrix::vector3_f normal = bardrix::vector3_f(bardrix::vector3(0, 1, 0));
+        /// \note Converting double to float rounds every value to the nearest float
+        template<typename U>
+        constexpr explicit basic_vector3(const basic_vector3<U>& vec3) noexcept;
 
         /// \brief Magnitude of the vector, the length of the vector
         /// \return The length of the vector
-        NODISCARD double length() const noexcept;
+        NODISCARD V length() const noexcept;
 
         /// \brief Magnitude of the vector squared, the length of the vector squared
         /// \return The length of the vector squared
-        NODISCARD double length_squared() const noexcept;
+        NODISCARD constexpr V length_squared() const noexcept;
 
         /// \brief Normalizes this vector, making it a unit vector
         /// \return A reference to this vector
         /// \details If the length of the vector is 0, it will not be normalized
         /// \example vector3(0, 0, 0).normalize() == vector3(0, 0, 0)
         /// \example vector3(1, 2, 3).normalize() == vector3(0.267, 0.534, 0.802)
-        vector3& normalize() noexcept;
+        basic_vector3& normalize() noexcept;
 
         /// \brief Normalize the vector, making it a unit vector
         /// \return The normalized vector
         /// \details If the length of the vector is 0, it will not be normalized
         /// \example vector3(0, 0, 0).normalize() == vector3(0, 0, 0)
         /// \example vector3(1, 2, 3).normalize() == vector3(0.267, 0.534, 0.802)
-        NODISCARD vector3 normalized() const noexcept;
+        NODISCARD basic_vector3 normalized() const noexcept;
+
+        /// \brief Normalizes this vector without checking its length, making it a unit vector
+        /// \return A reference to this vector
+        /// \details Follows IEEE, a vector with length 0 becomes NaN instead of staying the same. \n
+        ///          Without the branch, loops which normalize many vectors can be vectorized
+        /// \example vector3(1, 2, 3).normalize_unchecked() == vector3(0.267, 0.534, 0.802)
+        basic_vector3& normalize_unchecked() noexcept;
+
+        /// \brief Normalize the vector without checking its length, making it a unit vector
+        /// \return The normalized vector
+        /// \details Follows IEEE, a vector with length 0 gives NaN instead of the same vector
+        /// \example vector3(1, 2, 3).normalized_unchecked() == vector3(0.267, 0.534, 0.802)
+        NODISCARD basic_vector3 normalized_unchecked() const noexcept;
 
         /// \brief Dot product of two vectors
         /// \param vec3 The other vector
         /// \return The dot product of the two vectors
-        NODISCARD double dot(const vector3& vec3) const noexcept;
+        NODISCARD constexpr V dot(const basic_vector3& vec3) const noexcept;
 
         /// \brief Cross product of two vectors
         /// \param vec3 The other vector
         /// \return The cross product of the two vectors
-        NODISCARD vector3 cross(const vector3& vec3) const noexcept;
+        NODISCARD constexpr basic_vector3 cross(const basic_vector3& vec3) const noexcept;
 
         /// \brief Angle between two vectors [-1, 1]
         /// \param vec3 The other vector
@@ -61,7 +84,7 @@ namespace bardrix {
         /// \details This vector and the other vector will normalized before calculating the angle
         /// \details If the length of any of the vectors is 0, it will return 1, aka orthogonal
         /// \return The angle between the two vectors [-1, 1]
-        NODISCARD double angle(const vector3& vec3) const;
+        NODISCARD V angle(const basic_vector3& vec3) const;
 
         /// \brief Calculates the reflection of this vector onto a normal
         ///        The result will be an outgoing vector with the same length as the incoming vector
@@ -75,7 +98,7 @@ namespace bardrix {
         /// \details d is the vector
         /// \see https://math.stackexchange.com/a/4019883
         /// \see bardrix::quaternion::mirror for the same functionality
-        NODISCARD std::optional<vector3> reflection(const vector3& normal) const;
+        NODISCARD std::optional<basic_vector3> reflection(const basic_vector3& normal) const;
 
         /// \brief Calculates the refraction of this vector through a normal
         ///        The result will be an outgoing normalized vector
@@ -87,7 +110,7 @@ namespace bardrix {
         /// \note There mustn't be total internal reflection
         /// \see https://en.wikipedia.org/wiki/Refractive_index
         /// \see https://en.wikipedia.org/wiki/Snell%27s_law#Vector_form
-        NODISCARD std::optional<vector3> refraction(const vector3& normal, double refractive_ratio) const;
+        NODISCARD std::optional<basic_vector3> refraction(const basic_vector3& normal, V refractive_ratio) const;
 
         /// \brief Calculates the refraction of this vector through a normal
         ///        The result will be an outgoing normalized vector
@@ -100,12 +123,107 @@ namespace bardrix {
         /// \note There mustn't be total internal reflection
         /// \see https://en.wikipedia.org/wiki/Refractive_index
         /// \see https://en.wikipedia.org/wiki/Snell%27s_law#Vector_form
-        NODISCARD std::optional<vector3> refraction(const vector3& normal, double medium1, double medium2) const;
+        NODISCARD std::optional<basic_vector3> refraction(const basic_vector3& normal, V medium1, V medium2) const;
 
         /// \brief Print the vector to an output stream
         /// \param os The output stream
         /// \return The output stream
         std::ostream& print(std::ostream& os) const override;
 
-    }; // class vector3
+    }; // class basic_vector3
+
+    /// \brief A 3D vector with double values
+    using vector3 = basic_vector3<double>;
+
+    /// \brief A 3D vector with float values, for data which doesn't need double precision (e.g. normals)
+    /// \note The virtual print of dimension3 keeps a table pointer in every value, so a vector3_f is 24 bytes and a \n
+    ///       vector3 32 bytes (64-bit), not half the size. Store large arrays in flat buffers, like mesh_buffers<float>.
+    using vector3_f = basic_vector3<float>;
+
+    // basic_vector3 implementation start
+
+    template<typename V>
+    constexpr basic_vector3<V>::basic_vector3(const V x, const V y, const V z) {
+        this->x = x;
+        this->y = y;
+        this->z = z;
+    }
+
+    template<typename V>
+    template<typename U>
+    constexpr basic_vector3<V>::basic_vector3(const basic_vector3<U>& vec3) noexcept
+            : basic_vector3(static_cast<V>(vec3.x), static_cast<V>(vec3.y), static_cast<V>(vec3.z)) {}
+
+    template<typename V>
+    INLINE V basic_vector3<V>::length() const noexcept {
+        return std::sqrt(length_squared());
+    }
+
+    template<typename V>
+    constexpr V basic_vector3<V>::length_squared() const noexcept {
+        return dot(*this);
+    }
+
+    template<typename V>
+    INLINE basic_vector3<V> basic_vector3<V>::normalized() const noexcept {
+        const V mag = length();
+
+        if (nearly_equal(mag, 0))
+            return *this;
+
+        return divide_unchecked(*this, mag);
+    }
+
+    template<typename V>
+    INLINE basic_vector3<V>& basic_vector3<V>::normalize() noexcept {
+        const V mag = length();
+
+        if (nearly_equal(mag, 0))
+            return *this;
+
+        divide_assign_unchecked(*this, mag);
+        return *this;
+    }
+
+    template<typename V>
+    INLINE basic_vector3<V>& basic_vector3<V>::normalize_unchecked() noexcept {
+        divide_assign_unchecked(*this, length());
+        return *this;
+    }
+
+    template<typename V>
+    INLINE basic_vector3<V> basic_vector3<V>::normalized_unchecked() const noexcept {
+        return divide_unchecked(*this, length());
+    }
+
+    template<typename V>
+    constexpr V basic_vector3<V>::dot(const basic_vector3& vec3) const noexcept {
+        if constexpr (std::is_same_v<V, double>) {
+            if (BARDRIX_USE_LANES())
+                return (this->lanes() * vec3.lanes()).sum3();
+        }
+
+        return this->x * vec3.x + this->y * vec3.y + this->z * vec3.z;
+    }
+
+    template<typename V>
+    constexpr basic_vector3<V> basic_vector3<V>::cross(const basic_vector3& vec3) const noexcept {
+        if constexpr (std::is_same_v<V, double>) {
+            if (BARDRIX_USE_LANES()) {
+                // (y, z, x) * (z', x', y') - (z, x, y) * (y', z', x')
+                const lanes4 lhs = lanes4::set(this->y, this->z, this->x) * lanes4::set(vec3.z, vec3.x, vec3.y);
+                const lanes4 rhs = lanes4::set(this->z, this->x, this->y) * lanes4::set(vec3.y, vec3.z, vec3.x);
+
+                basic_vector3 result;
+                result.set_lanes(lhs - rhs);
+                return result;
+            }
+        }
+
+        return { this->y * vec3.z - this->z * vec3.y, this->z * vec3.x - this->x * vec3.z,
+                 this->x * vec3.y - this->y * vec3.x };
+    }
+
+    // basic_vector3 implementation end
+
 } // namespace bardrix
\ No newline at end of file
@@ -4,8 +4,113 @@
 
 #include <bardrix/algorithm.h>
 
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace bardrix {
 
+    namespace {
+
+        /// \brief The header at the start of a file saved with bvh_tree::save, the nodes follow directly after it, \n
+        ///        then the shape index (std::uint32_t) of every leaf primitive.
+        /// \details The header is 64 bytes so the nodes after it stay aligned.
+        struct bvh_file_header {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t byte_order;
+            std::uint32_t node_size;
+            std::uint32_t flags;
+            std::uint64_t node_count;
+            std::uint64_t primitive_count;
+            double build_cost;
+            std::uint8_t padding[16];
+        };
+
+        static_assert(sizeof(bvh_file_header) == 64, "bvh_file_header must be 64 bytes");
+        static_assert(std::is_trivially_copyable_v<bvh_node>, "bvh_node must be trivially copyable to be saved");
+
+        constexpr char bvh_file_magic[8] = {'B', 'A', 'R', 'D', 'B', 'V', 'H', '\0'};
+
+        // Written as is, so it reads differently on a machine with a different byte order
+        constexpr std::uint32_t bvh_file_byte_order = 0x01020304;
+
+        // Set in bvh_file_header::flags when a shape is referenced by more than one leaf (see construct_sbvh)
+        constexpr std::uint32_t bvh_file_duplicates = 1;
+
+        /// \brief Checks the header and the size of a BVH file.
+        /// \param data The start of the file.
+        /// \param size The size of the file in bytes.
+        /// \return The header of the file.
+        /// \throws std::runtime_error If the file is not a BVH file of bvh_tree::file_version or is too small.
+        bvh_file_header read_bvh_file_header(const std::uint8_t* data, std::size_t size) {
+            bvh_file_header header{};
+            if (size < sizeof(header))
+                throw std::runtime_error("BVH file is too small");
+
+            std::memcpy(&header, data, sizeof(header));
+            if (std::memcmp(header.magic, bvh_file_magic, sizeof(bvh_file_magic)) != 0)
+                throw std::runtime_error("Not a BVH file");
+            if (header.version != bvh_tree::file_version)
+                throw std::runtime_error("Unsupported BVH file version");
+            if (header.byte_order != bvh_file_byte_order)
+                throw std::runtime_error("BVH file has a different byte order");
+            if (header.node_size != sizeof(bvh_node))
+                throw std::runtime_error("BVH file has a different node layout");
+
+            // Divide instead of multiply, so a corrupt count cannot overflow
+            const std::size_t available = size - sizeof(header);
+            if (header.node_count > available / sizeof(bvh_node) ||
+                header.primitive_count > (available - header.node_count * sizeof(bvh_node)) / sizeof(std::uint32_t))
+                throw std::runtime_error("BVH file is truncated");
+
+            return header;
+        }
+
+        /// \brief Checks the nodes of a BVH file, so a corrupt file cannot make the traversal read out of bounds.
+        /// \param nodes The nodes of the file, depth first, the root is the first node.
+        /// \param header The header of the file, read with read_bvh_file_header.
+        /// \throws std::runtime_error If a node has an offset, count or depth outside of the tree.
+        void check_bvh_file_nodes(const bvh_node* nodes, const bvh_file_header& header) {
+            const std::size_t node_count = static_cast<std::size_t>(header.node_count);
+
+            // The children of a node always come after it, so the depth of every node is known when it's reached
+            std::vector<std::uint32_t> depth(node_count, 0);
+            if (node_count > 0) depth[0] = 1;
+
+            for (std::size_t i = 0; i < node_count; ++i) {
+                const bvh_node& node = nodes[i];
+                if (depth[i] > bvh_tree::max_depth)
+                    throw std::runtime_error("BVH file is deeper than bvh_tree::max_depth");
+
+                if (node.is_leaf()) {
+                    if (static_cast<std::uint64_t>(node.offset) + node.count > header.primitive_count)
+                        throw std::runtime_error("BVH file has a leaf outside of its primitives");
+                    continue;
+                }
+
+                // The left child is the next node, the right child comes after the left subtree
+                if (node.offset <= i + 1 || node.offset >= node_count)
+                    throw std::runtime_error("BVH file has a node with an invalid child");
+
+                depth[i + 1] = std::max(depth[i + 1], depth[i] + 1);
+                depth[node.offset] = std::max(depth[node.offset], depth[i] + 1);
+            }
+        }
+
+    } // namespace
+
     // bvh_data
 
     bvh_data::bvh_data(const std::shared_ptr<bardrix::shape>& shape) : bvh_data(shape, shape->bounding_box()) {}
@@ -23,30 +128,1626 @@ namespace bardrix {
         return !(lhs == rhs);
     }
 
+    // bvh_node
+
+    bool bvh_node::is_leaf() const noexcept { return count != 0; }
+
+    bardrix::bounding_box bvh_node::bounding_box() const noexcept {
+        return { point3(min[0], min[1], min[2]), point3(max[0], max[1], max[2]) };
+    }
+
+    void bvh_node::set_bounding_box(const bardrix::bounding_box& box) noexcept {
+        min[0] = box.get_min().x;
+        min[1] = box.get_min().y;
+        min[2] = box.get_min().z;
+        max[0] = box.get_max().x;
+        max[1] = box.get_max().y;
+        max[2] = box.get_max().z;
+    }
+
+    double bvh_node::area() const noexcept {
+        const double width = max[0] - min[0];
+        const double height = max[1] - min[1];
+        const double depth = max[2] - min[2];
+        return 2 * (width * height + width * depth + height * depth);
+    }
+
     // bvh_tree
 
-    bool bvh_tree::longest_axis_predicate(const std::shared_ptr<bardrix::shape>& shape_lhs,
-                                   const std::shared_ptr<bardrix::shape>& shape_rhs, axis axis) {
-        return shape_lhs && shape_rhs &&
-               shape_lhs->bounding_box().center()[axis] < shape_rhs->bounding_box().center()[axis];
+    bvh_tree::bvh_tree() = default;
+
+    std::size_t bvh_tree::thread_count(std::size_t threads) noexcept {
+        if (threads != 0) return threads;
+        return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    void bvh_tree::parallel_for(std::size_t size, std::size_t threads,
+                                const std::function<void(std::size_t, std::size_t, std::size_t)>& function) {
+        const std::size_t chunks = std::max<std::size_t>(std::min(threads, size), 1);
+
+        // The last chunk is done on the calling thread
+        std::vector<std::future<void>> futures;
+        futures.reserve(chunks - 1);
+        for (std::size_t chunk = 0; chunk + 1 < chunks; ++chunk)
+            futures.push_back(std::async(std::launch::async, function, chunk, chunk * size / chunks,
+                                         (chunk + 1) * size / chunks));
+
+        function(chunks - 1, (chunks - 1) * size / chunks, size);
+
+        for (std::future<void>& future: futures)
+            future.get();
+    }
+
+    std::vector<bvh_tree::build_primitive>
+    bvh_tree::make_build_primitives(const std::vector<std::shared_ptr<bardrix::shape>>& shapes, std::size_t threads) {
+        if (shapes.size() < parallel_threshold) threads = 1;
+
+        // Calculate the bounding box and center of every shape once
+        std::vector<std::vector<build_primitive>> chunks(std::max<std::size_t>(std::min(threads, shapes.size()), 1));
+        parallel_for(shapes.size(), threads, [&](std::size_t chunk, std::size_t first, std::size_t last) {
+            chunks[chunk].reserve(last - first);
+            for (std::size_t i = first; i < last; ++i) {
+                bardrix::bounding_box box = shapes[i]->bounding_box();
+                bardrix::point3 center = box.center();
+                chunks[chunk].push_back({ std::move(box), std::move(center), static_cast<std::uint32_t>(i) });
+            }
+        });
+
+        if (chunks.size() == 1) return std::move(chunks.front());
+
+        std::vector<build_primitive> primitives;
+        primitives.reserve(shapes.size());
+        for (const std::vector<build_primitive>& chunk: chunks)
+            primitives.insert(primitives.end(), chunk.begin(), chunk.end());
+        return primitives;
+    }
+
+    void bvh_tree::push_leaf(build_output& output, const build_primitive& primitive) {
+        bvh_node leaf{};
+        leaf.set_bounding_box(primitive.box);
+        leaf.offset = static_cast<std::uint32_t>(output.indices.size());
+        leaf.count = 1;
+
+        output.nodes.push_back(leaf);
+        output.indices.push_back(primitive.index);
+    }
+
+    void bvh_tree::append(build_output& output, const build_output& subtree) {
+        const auto node_offset = static_cast<std::uint32_t>(output.nodes.size());
+        const auto index_offset = static_cast<std::uint32_t>(output.indices.size());
+
+        for (bvh_node node: subtree.nodes) {
+            node.offset += node.is_leaf() ? index_offset : node_offset;
+            output.nodes.push_back(node);
+        }
+        output.indices.insert(output.indices.end(), subtree.indices.begin(), subtree.indices.end());
+    }
+
+    void bvh_tree::finish(const std::vector<std::shared_ptr<bardrix::shape>>& shapes, build_output&& output) {
+        nodes_ = std::move(output.nodes);
+
+        primitives_.reserve(output.indices.size());
+        for (std::uint32_t index: output.indices)
+            primitives_.push_back(shapes[index]);
+
+        duplicates_ = output.indices.size() > shapes.size();
+        if (!duplicates_) {
+            build_cost_ = sah_cost();
+            return;
+        }
+
+        // refit can't clip the leaves of a spatial split again, so degradation starts from the unclipped boxes
+        std::vector<bvh_node> clipped = nodes_;
+        refit();
+        build_cost_ = sah_cost();
+        nodes_ = std::move(clipped);
+    }
+
+    void bvh_tree::construct_longest_axis(const std::vector<std::shared_ptr<bardrix::shape>>& shapes,
+                                          std::size_t threads) {
+        std::vector<build_primitive> primitives = make_build_primitives(shapes, threads);
+        if (primitives.empty()) return;
+
+        // Sort the shapes on the longest axis of the scene
+        bardrix::bounding_box box = primitives.front().box;
+        for (const build_primitive& primitive: primitives)
+            box.merge(primitive.box);
+
+        const axis longest_axis = box.longest_axis();
+        const auto predicate = [longest_axis](const build_primitive& lhs, const build_primitive& rhs) {
+            return lhs.center[longest_axis] < rhs.center[longest_axis];
+        };
+
+        if (threads == 1 || primitives.size() < parallel_threshold) {
+            std::sort(primitives.begin(), primitives.end(), predicate);
+        } else {
+            // Sort every chunk on its own thread, then merge neighbouring chunks until one is left
+            std::vector<std::size_t> bounds;
+            parallel_for(primitives.size(), threads, [&](std::size_t, std::size_t first, std::size_t last) {
+                std::sort(primitives.begin() + first, primitives.begin() + last, predicate);
+            });
+
+            const std::size_t chunks = std::min(threads, primitives.size());
+            for (std::size_t chunk = 0; chunk <= chunks; ++chunk)
+                bounds.push_back(chunk * primitives.size() / chunks);
+
+            while (bounds.size() > 2) {
+                std::vector<std::size_t> merged;
+                const std::size_t pairs = (bounds.size() - 1) / 2;
+                parallel_for(pairs, pairs, [&](std::size_t, std::size_t first, std::size_t last) {
+                    for (std::size_t pair = first; pair < last; ++pair)
+                        std::inplace_merge(primitives.begin() + bounds[2 * pair], primitives.begin() + bounds[2 * pair + 1],
+                                           primitives.begin() + bounds[2 * pair + 2], predicate);
+                });
+
+                for (std::size_t i = 0; i < bounds.size(); i += 2)
+                    merged.push_back(bounds[i]);
+                if (merged.back() != bounds.back()) merged.push_back(bounds.back());
+                bounds = std::move(merged);
+            }
+        }
+
+        build_output output;
+        output.nodes.reserve(2 * primitives.size() - 1);
+        output.indices.reserve(primitives.size());
+        construct_longest_axis(output, primitives.data(), primitives.data() + primitives.size(), threads);
+        finish(shapes, std::move(output));
+    }
+
+    // helper function for construct_longest_axis
+    void bvh_tree::construct_longest_axis(build_output& output, const build_primitive* begin,
+                                          const build_primitive* end, std::size_t threads) {
+        const std::size_t count = end - begin;
+
+        // If there is only one shape, we make a leaf with the shape
+        if (count == 1) {
+            push_leaf(output, *begin);
+            return;
+        }
+
+        // Merge all the bounding boxes
+        bardrix::bounding_box box = begin->box;
+        for (const build_primitive* it = begin + 1; it != end; ++it)
+            box.merge(it->box);
+
+        const std::size_t index = output.nodes.size();
+        output.nodes.emplace_back().set_bounding_box(box);
+
+        // Split the shapes in half, the left child is the next node
+        const build_primitive* middle = begin + count / 2;
+        if (threads == 1 || count < parallel_threshold) {
+            construct_longest_axis(output, begin, middle, 1);
+            output.nodes[index].offset = static_cast<std::uint32_t>(output.nodes.size());
+            construct_longest_axis(output, middle, end, 1);
+            return;
+        }
+
+        // The right subtree is constructed on another thread
+        build_output right;
+        std::future<void> future = std::async(std::launch::async, [&right, middle, end, threads]() {
+            construct_longest_axis(right, middle, end, threads - threads / 2);
+        });
+        construct_longest_axis(output, begin, middle, threads / 2);
+        future.get();
+
+        output.nodes[index].offset = static_cast<std::uint32_t>(output.nodes.size());
+        append(output, right);
+    }
+
+    void bvh_tree::construct_sah(const std::vector<std::shared_ptr<bardrix::shape>>& shapes, std::size_t bins,
+                                 std::size_t threads) {
+        std::vector<build_primitive> primitives = make_build_primitives(shapes, threads);
+        if (primitives.empty()) return;
+
+        finish(shapes, build_sah(primitives, bins, threads));
+    }
+
+    bvh_tree::build_output bvh_tree::build_sah(std::vector<build_primitive>& primitives, std::size_t bins,
+                                               std::size_t threads) {
+        build_output output;
+        output.nodes.reserve(2 * primitives.size() - 1);
+        output.indices.reserve(primitives.size());
+        // The bins and sweep costs are reused by every node of this thread
+        bins = std::max<std::size_t>(bins, 2);
+        sah_scratch scratch{ std::vector<sah_bin>(3 * bins), std::vector<double>(bins) };
+        construct_sah(output, primitives.data(), primitives.data() + primitives.size(), bins, 1, threads, scratch);
+        return output;
+    }
+
+    void bvh_tree::merge_leaves(build_output& output, std::size_t leaf_size) {
+        if (leaf_size <= 1) return;
+
+        const std::vector<bvh_node>& nodes = output.nodes;
+        const std::size_t size = nodes.size();
+
+        // The children come after their parent, so the subtrees are counted bottom up
+        std::vector<std::uint32_t> first(size), count(size), subtree_size(size);
+        for (std::size_t i = size; i-- > 0;) {
+            const bvh_node& node = nodes[i];
+            if (node.is_leaf()) {
+                first[i] = node.offset;
+                count[i] = node.count;
+                subtree_size[i] = 1;
+                continue;
+            }
+
+            const std::size_t left = i + 1;
+            const std::size_t right = node.offset;
+            first[i] = first[left];
+            count[i] = count[left] + count[right];
+            subtree_size[i] = 1 + subtree_size[left] + subtree_size[right];
+        }
+
+        // Copy the nodes depth first, skipping the subtrees of merged nodes
+        std::vector<bvh_node> merged;
+        std::vector<std::uint32_t> remap(size);
+        merged.reserve(size);
+        for (std::size_t i = 0; i < size;) {
+            remap[i] = static_cast<std::uint32_t>(merged.size());
+            merged.push_back(nodes[i]);
+            if (count[i] > leaf_size || nodes[i].is_leaf()) {
+                ++i;
+                continue;
+            }
+
+            merged.back().offset = first[i];
+            merged.back().count = count[i];
+            i += subtree_size[i];
+        }
+
+        for (bvh_node& node: merged)
+            if (!node.is_leaf()) node.offset = remap[node.offset];
+
+        output.nodes = std::move(merged);
+    }
+
+    // helper function for construct_sah
+    void bvh_tree::construct_sah(build_output& output, build_primitive* begin, build_primitive* end,
+                                 std::size_t bins, std::size_t depth, std::size_t threads, sah_scratch& scratch) {
+        const std::size_t count = end - begin;
+
+        // If there is only one shape, we make a leaf with the shape
+        if (count == 1) {
+            push_leaf(output, *begin);
+            return;
+        }
+
+        // Small nodes are not worth dividing over threads, they are done in one chunk
+        const std::size_t chunks = count < parallel_threshold ? 1 : std::min(threads, count);
+
+        // Merge all the bounding boxes and centers, per chunk
+        const auto merge_bounds = [begin](std::size_t first, std::size_t last, bardrix::bounding_box& box,
+                                          bardrix::bounding_box& centers) {
+            for (std::size_t i = first; i < last; ++i) {
+                box.merge(begin[i].box);
+                centers.merge({ begin[i].center, begin[i].center });
+            }
+        };
+
+        bardrix::bounding_box box = begin->box;
+        bardrix::bounding_box centers(begin->center, begin->center);
+        if (chunks == 1) {
+            merge_bounds(1, count, box, centers);
+        } else {
+            std::vector<bardrix::bounding_box> chunk_boxes(chunks, box);
+            std::vector<bardrix::bounding_box> chunk_centers(chunks, centers);
+            parallel_for(count, chunks, [&](std::size_t chunk, std::size_t first, std::size_t last) {
+                merge_bounds(first, last, chunk_boxes[chunk], chunk_centers[chunk]);
+            });
+
+            for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+                box.merge(chunk_boxes[chunk]);
+                centers.merge(chunk_centers[chunk]);
+            }
+        }
+
+        const std::size_t index = output.nodes.size();
+        output.nodes.emplace_back().set_bounding_box(box);
+
+        // Past half of the maximum depth the shapes are split by count, a balanced split always fits in the other half
+        const bool split_by_count = depth >= max_depth / 2;
+
+        const axis axes[] = { axis::x, axis::y, axis::z };
+        double mins[3];
+        double extents[3];
+        for (std::size_t a = 0; a < 3; ++a) {
+            mins[a] = centers.get_min()[axes[a]];
+            extents[a] = split_by_count ? 0 : centers.get_max()[axes[a]] - mins[a];
+        }
+
+        const auto bin_index = [bins](double value, double min, double extent) {
+            return std::min(static_cast<std::size_t>((value - min) / extent * bins), bins - 1);
+        };
+
+        // An empty bin, merging with it changes nothing
+        constexpr double infinity = std::numeric_limits<double>::infinity();
+        constexpr sah_bin empty_bin{ 0, { infinity, infinity, infinity }, { -infinity, -infinity, -infinity } };
+
+        const auto merge_bin = [](sah_bin& bin, const sah_bin& other) {
+            bin.count += other.count;
+            for (std::size_t a = 0; a < 3; ++a) {
+                bin.min[a] = std::min(bin.min[a], other.min[a]);
+                bin.max[a] = std::max(bin.max[a], other.max[a]);
+            }
+        };
+
+        // The same formula as bounding_box::area
+        const auto bin_area = [](const sah_bin& bin) {
+            const double width = bin.max[0] - bin.min[0];
+            const double height = bin.max[1] - bin.min[1];
+            const double depth = bin.max[2] - bin.min[2];
+            return 2 * (width * height + width * depth + height * depth);
+        };
+
+        // Put the centers of the shapes into bins on every axis
+        const auto fill_bins = [&](sah_bin* bin_data, std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                const bardrix::point3& min = begin[i].box.get_min();
+                const bardrix::point3& max = begin[i].box.get_max();
+                const sah_bin primitive_bin{ 1, { min.x, min.y, min.z }, { max.x, max.y, max.z } };
+
+                for (std::size_t a = 0; a < 3; ++a)
+                    if (extents[a] > 0)
+                        merge_bin(bin_data[a * bins + bin_index(begin[i].center[axes[a]], mins[a], extents[a])],
+                                  primitive_bin);
+            }
+        };
+
+        std::fill(scratch.bins.begin(), scratch.bins.end(), empty_bin);
+        if (extents[0] > 0 || extents[1] > 0 || extents[2] > 0) {
+            if (chunks == 1) {
+                fill_bins(scratch.bins.data(), 0, count);
+            } else {
+                // Every chunk fills its own bins, they are merged afterwards
+                std::vector<sah_bin> chunk_bins(chunks * 3 * bins, empty_bin);
+                parallel_for(count, chunks, [&](std::size_t chunk, std::size_t first, std::size_t last) {
+                    fill_bins(chunk_bins.data() + chunk * 3 * bins, first, last);
+                });
+
+                for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+                    for (std::size_t i = 0; i < 3 * bins; ++i)
+                        merge_bin(scratch.bins[i], chunk_bins[chunk * 3 * bins + i]);
+            }
+        }
+
+        // Find the split with the lowest cost: area(left) * count(left) + area(right) * count(right)
+        double best_cost = infinity;
+        std::size_t best_axis = 3;
+        std::size_t best_split = 0;
+
+        for (std::size_t a = 0; a < 3; ++a) {
+            if (extents[a] <= 0) continue;
+            const sah_bin* axis_bins = scratch.bins.data() + a * bins;
+
+            // Sweep from the right, right_cost[i] is the cost of bins [i, bins)
+            sah_bin right = empty_bin;
+            for (std::size_t i = bins - 1; i > 0; --i) {
+                merge_bin(right, axis_bins[i]);
+                scratch.right_cost[i] = right.count > 0 ? bin_area(right) * static_cast<double>(right.count) : 0;
+            }
+
+            // Sweep from the left, splitting between bin i - 1 and bin i
+            sah_bin left = empty_bin;
+            for (std::size_t i = 1; i < bins; ++i) {
+                merge_bin(left, axis_bins[i - 1]);
+                if (left.count == 0 || left.count == count) continue;
+
+                const double cost = bin_area(left) * static_cast<double>(left.count) + scratch.right_cost[i];
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best_axis = a;
+                    best_split = i;
+                }
+            }
+        }
+
+        build_primitive* middle = begin + count / 2;
+        if (best_axis < 3) {
+            const auto is_left = [&](const build_primitive& primitive) {
+                return bin_index(primitive.center[axes[best_axis]], mins[best_axis], extents[best_axis]) < best_split;
+            };
+
+            if (chunks == 1) {
+                middle = std::partition(begin, end, is_left);
+            } else {
+                // Count the left primitives per chunk, then every chunk moves its primitives to their place
+                std::vector<std::size_t> left_counts(chunks);
+                parallel_for(count, chunks, [&](std::size_t chunk, std::size_t first, std::size_t last) {
+                    left_counts[chunk] = static_cast<std::size_t>(std::count_if(begin + first, begin + last, is_left));
+                });
+
+                std::vector<std::size_t> left_offsets(chunks);
+                std::vector<std::size_t> right_offsets(chunks);
+                std::size_t left_total = 0;
+                for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+                    left_offsets[chunk] = left_total;
+                    left_total += left_counts[chunk];
+                }
+                for (std::size_t chunk = 0, right_total = left_total; chunk < chunks; ++chunk) {
+                    right_offsets[chunk] = right_total;
+                    right_total += (chunk + 1) * count / chunks - chunk * count / chunks - left_counts[chunk];
+                }
+
+                const std::vector<build_primitive> primitives(begin, end);
+                parallel_for(count, chunks, [&](std::size_t chunk, std::size_t first, std::size_t last) {
+                    std::size_t left = left_offsets[chunk];
+                    std::size_t right = right_offsets[chunk];
+                    for (std::size_t i = first; i < last; ++i)
+                        begin[is_left(primitives[i]) ? left++ : right++] = primitives[i];
+                });
+
+                middle = begin + left_total;
+            }
+        }
+
+        if (threads == 1 || count < parallel_threshold) {
+            construct_sah(output, begin, middle, bins, depth + 1, 1, scratch);
+            output.nodes[index].offset = static_cast<std::uint32_t>(output.nodes.size());
+            construct_sah(output, middle, end, bins, depth + 1, 1, scratch);
+            return;
+        }
+
+        // The right subtree is constructed on another thread, with its own scratch
+        build_output right;
+        std::future<void> future = std::async(std::launch::async, [&right, middle, end, bins, depth, threads]() {
+            sah_scratch right_scratch{ std::vector<sah_bin>(3 * bins), std::vector<double>(bins) };
+            construct_sah(right, middle, end, bins, depth + 1, threads - threads / 2, right_scratch);
+        });
+        construct_sah(output, begin, middle, bins, depth + 1, threads / 2, scratch);
+        future.get();
+
+        output.nodes[index].offset = static_cast<std::uint32_t>(output.nodes.size());
+        append(output, right);
+    }
+
+    std::uint64_t bvh_tree::morton_code(const bardrix::point3& point, const bardrix::bounding_box& bounds,
+                                        std::size_t bits) noexcept {
+        const std::size_t axis_bits = bits / 3;
+        const double cells = static_cast<double>((std::uint64_t(1) << axis_bits) - 1);
+
+        // Spread the bits of a coordinate, so there are two zero bits between every bit
+        const auto expand = [](std::uint64_t value) {
+            value &= 0x1fffff;
+            value = (value | value << 32) & 0x1f00000000ffff;
+            value = (value | value << 16) & 0x1f0000ff0000ff;
+            value = (value | value << 8) & 0x100f00f00f00f00f;
+            value = (value | value << 4) & 0x10c30c30c30c30c3;
+            value = (value | value << 2) & 0x1249249249249249;
+            return value;
+        };
+
+        // Quantize a coordinate to [0, cells], an axis without extent is always 0
+        const auto quantize = [cells](double value, double min, double max) {
+            const double extent = max - min;
+            if (!(extent > 0)) return std::uint64_t(0);
+
+            const double cell = (value - min) / extent * cells;
+            return static_cast<std::uint64_t>(std::min(std::max(cell, 0.0), cells));
+        };
+
+        const bardrix::point3& min = bounds.get_min();
+        const bardrix::point3& max = bounds.get_max();
+        return expand(quantize(point.x, min.x, max.x)) << 2 |
+               expand(quantize(point.y, min.y, max.y)) << 1 |
+               expand(quantize(point.z, min.z, max.z));
+    }
+
+    void bvh_tree::radix_sort(std::vector<morton_primitive>& codes, std::size_t bits, std::size_t threads) {
+        constexpr std::size_t radix = 256;
+
+        const std::size_t chunks = codes.size() < parallel_threshold ? 1 : std::min(threads, codes.size());
+        std::vector<morton_primitive> scratch(codes.size());
+        std::vector<std::size_t> offsets(chunks * radix);
+
+        for (std::size_t shift = 0; shift < bits; shift += 8) {
+            // Count the digits per chunk
+            std::fill(offsets.begin(), offsets.end(), 0);
+            parallel_for(codes.size(), chunks, [&](std::size_t chunk, std::size_t first, std::size_t last) {
+                for (std::size_t i = first; i < last; ++i)
+                    ++offsets[chunk * radix + (codes[i].code >> shift & (radix - 1))];
+            });
+
+            // Every chunk writes a digit after the same digit of the previous chunks, so the sort stays stable
+            std::size_t offset = 0;
+            for (std::size_t digit = 0; digit < radix; ++digit) {
+                for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+                    const std::size_t count = offsets[chunk * radix + digit];
+                    offsets[chunk * radix + digit] = offset;
+                    offset += count;
+                }
+            }
+
+            parallel_for(codes.size(), chunks, [&](std::size_t chunk, std::size_t first, std::size_t last) {
+                for (std::size_t i = first; i < last; ++i)
+                    scratch[offsets[chunk * radix + (codes[i].code >> shift & (radix - 1))]++] = codes[i];
+            });
+
+            codes.swap(scratch);
+        }
+    }
+
+    void bvh_tree::construct_morton(const std::vector<std::shared_ptr<bardrix::shape>>& shapes, std::size_t bits,
+                                    std::size_t threads) {
+        const std::vector<build_primitive> primitives = make_build_primitives(shapes, threads);
+        if (primitives.empty()) return;
+
+        // The codes are quantized within the bounds of the centers
+        bardrix::bounding_box centers(primitives.front().center, primitives.front().center);
+        for (const build_primitive& primitive: primitives)
+            centers.merge({ primitive.center, primitive.center });
+
+        std::vector<morton_primitive> codes(primitives.size());
+        const std::size_t chunks = primitives.size() < parallel_threshold ? 1 : threads;
+        parallel_for(primitives.size(), chunks, [&](std::size_t, std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i)
+                codes[i] = { morton_code(primitives[i].center, centers, bits), static_cast<std::uint32_t>(i) };
+        });
+
+        radix_sort(codes, bits, threads);
+
+        std::vector<build_primitive> sorted;
+        sorted.reserve(primitives.size());
+        for (const morton_primitive& code: codes)
+            sorted.push_back(primitives[code.index]);
+
+        build_output output;
+        output.nodes.reserve(2 * sorted.size() - 1);
+        output.indices.reserve(sorted.size());
+        construct_morton(output, sorted.data(), codes.data(), sorted.size(), 1, threads);
+        finish(shapes, std::move(output));
+    }
+
+    // helper function for construct_morton
+    void bvh_tree::construct_morton(build_output& output, const build_primitive* primitives,
+                                    const morton_primitive* codes, std::size_t count, std::size_t depth,
+                                    std::size_t threads) {
+        // If there is only one shape, we make a leaf with the shape
+        if (count == 1) {
+            push_leaf(output, *primitives);
+            return;
+        }
+
+        // Split where the highest differing bit of the first and last code changes, the codes are sorted
+        std::size_t split = count / 2;
+        const std::uint64_t difference = codes[0].code ^ codes[count - 1].code;
+
+        // Past half of the maximum depth the shapes are split by count, a balanced split always fits in the other half
+        if (difference != 0 && depth < max_depth / 2) {
+            std::uint64_t bit = difference;
+            while (bit & (bit - 1))
+                bit &= bit - 1;
+
+            split = std::partition_point(codes, codes + count, [bit](const morton_primitive& code) {
+                return !(code.code & bit);
+            }) - codes;
+        }
+
+        const std::size_t index = output.nodes.size();
+        output.nodes.emplace_back();
+
+        if (threads == 1 || count < parallel_threshold) {
+            construct_morton(output, primitives, codes, split, depth + 1, 1);
+            output.nodes[index].offset = static_cast<std::uint32_t>(output.nodes.size());
+            construct_morton(output, primitives + split, codes + split, count - split, depth + 1, 1);
+        } else {
+            // The right subtree is constructed on another thread
+            build_output right;
+            std::future<void> future = std::async(std::launch::async, [&right, primitives, codes, count, split,
+                    depth, threads]() {
+                construct_morton(right, primitives + split, codes + split, count - split, depth + 1,
+                                 threads - threads / 2);
+            });
+            construct_morton(output, primitives, codes, split, depth + 1, threads / 2);
+            future.get();
+
+            output.nodes[index].offset = static_cast<std::uint32_t>(output.nodes.size());
+            append(output, right);
+        }
+
+        // The bounding box is the union of the bounding boxes of the children
+        bvh_node& node = output.nodes[index];
+        const bvh_node& left = output.nodes[index + 1];
+        const bvh_node& right = output.nodes[node.offset];
+        for (std::size_t a = 0; a < 3; ++a) {
+            node.min[a] = std::min(left.min[a], right.min[a]);
+            node.max[a] = std::max(left.max[a], right.max[a]);
+        }
+    }
+
+    void bvh_tree::construct_sbvh(const std::vector<std::shared_ptr<bardrix::shape>>& shapes, double budget,
+                                  std::size_t bins) {
+        std::vector<build_primitive> references = make_build_primitives(shapes, 1);
+        if (references.empty()) return;
+
+        bardrix::bounding_box box = references.front().box;
+        for (const build_primitive& reference: references)
+            box.merge(reference.box);
+
+        std::size_t remaining = budget > 0 ? static_cast<std::size_t>(budget * static_cast<double>(shapes.size())) : 0;
+
+        build_output output;
+        output.nodes.reserve(2 * (shapes.size() + remaining) - 1);
+        output.indices.reserve(shapes.size() + remaining);
+        construct_sbvh(output, shapes, std::move(references), std::max<std::size_t>(bins, 2), 1, box.area(), remaining);
+        finish(shapes, std::move(output));
+    }
+
+    // helper function for construct_sbvh
+    void bvh_tree::construct_sbvh(build_output& output, const std::vector<std::shared_ptr<bardrix::shape>>& shapes,
+                                  std::vector<build_primitive>&& references, std::size_t bins, std::size_t depth,
+                                  double root_area, std::size_t& budget) {
+        const std::size_t count = references.size();
+
+        // If there is only one shape, we make a leaf with the shape
+        if (count == 1) {
+            push_leaf(output, references.front());
+            return;
+        }
+
+        // Merge all the bounding boxes and centers
+        bardrix::bounding_box box = references.front().box;
+        bardrix::bounding_box centers(references.front().center, references.front().center);
+        for (const build_primitive& reference: references) {
+            box.merge(reference.box);
+            centers.merge({ reference.center, reference.center });
+        }
+
+        struct bin {
+            std::optional<bardrix::bounding_box> box;
+            std::size_t entries = 0;
+            std::size_t exits = 0;
+        };
+
+        const axis axes[] = { axis::x, axis::y, axis::z };
+        const auto merge = [](std::optional<bardrix::bounding_box>& lhs, const std::optional<bardrix::bounding_box>& rhs) {
+            if (!rhs) return;
+            if (lhs) lhs->merge(*rhs);
+            else lhs = rhs;
+        };
+
+        // Clips a shape reference to the slab [low, high] of an axis
+        const auto clip = [&shapes](const build_primitive& reference, axis axis, double low, double high) {
+            bardrix::point3 min = reference.box.get_min();
+            bardrix::point3 max = reference.box.get_max();
+            min[axis] = std::max(min[axis], low);
+            max[axis] = std::min(max[axis], high);
+            return shapes[reference.index]->clipped_bounding_box(bardrix::bounding_box(min, max));
+        };
+
+        // The best split, the plane of an object split is a bin of the centers, of a spatial split a position
+        bool spatial = false;
+        axis split_axis = axis::none;
+        std::size_t split_bin = 0;
+        double split_plane = 0;
+        double best_cost = std::numeric_limits<double>::infinity();
+        std::optional<bardrix::bounding_box> object_left;
+        std::optional<bardrix::bounding_box> object_right;
+
+        // Past half of the maximum depth the shapes are split by count, a balanced split always fits in the other half
+        const bool split_by_count = depth >= max_depth / 2;
+
+        // Object splits, the centers of the shapes are put into bins on every axis
+        for (std::size_t a = 0; a < 3 && !split_by_count; ++a) {
+            const double min = centers.get_min()[axes[a]];
+            const double extent = centers.get_max()[axes[a]] - min;
+            if (!(extent > 0)) continue;
+
+            std::vector<bin> bin_data(bins);
+            for (const build_primitive& reference: references) {
+                const auto index = std::min(static_cast<std::size_t>((reference.center[axes[a]] - min) / extent * bins),
+                                            bins - 1);
+                merge(bin_data[index].box, reference.box);
+                ++bin_data[index].entries;
+            }
+
+            // Sweep from the right, then evaluate every plane from the left
+            std::vector<std::optional<bardrix::bounding_box>> right_boxes(bins);
+            std::vector<std::size_t> right_counts(bins, 0);
+            for (std::size_t i = bins - 1; i > 0; --i) {
+                right_boxes[i - 1] = i < bins - 1 ? right_boxes[i] : std::nullopt;
+                merge(right_boxes[i - 1], bin_data[i].box);
+                right_counts[i - 1] = (i < bins - 1 ? right_counts[i] : 0) + bin_data[i].entries;
+            }
+
+            std::optional<bardrix::bounding_box> left_box;
+            std::size_t left_count = 0;
+            for (std::size_t i = 0; i + 1 < bins; ++i) {
+                merge(left_box, bin_data[i].box);
+                left_count += bin_data[i].entries;
+                if (left_count == 0 || right_counts[i] == 0) continue;
+
+                const double cost = left_box->area() * left_count + right_boxes[i]->area() * right_counts[i];
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    split_axis = axes[a];
+                    split_bin = i + 1;
+                    object_left = left_box;
+                    object_right = right_boxes[i];
+                }
+            }
+        }
+
+        // Spatial splits are only worth trying when the children of the object split overlap
+        bool try_spatial = !split_by_count && budget > 0;
+        if (try_spatial && object_left) {
+            bardrix::point3 min = object_left->get_min();
+            bardrix::point3 max = object_left->get_max();
+            for (const axis axis: axes) {
+                min[axis] = std::max(min[axis], object_right->get_min()[axis]);
+                max[axis] = std::min(max[axis], object_right->get_max()[axis]);
+            }
+            try_spatial = object_left->intersects(*object_right) &&
+                          bardrix::bounding_box(min, max).area() > sbvh_overlap_threshold * root_area;
+        }
+
+        for (std::size_t a = 0; a < 3 && try_spatial; ++a) {
+            const double min = box.get_min()[axes[a]];
+            const double extent = box.get_max()[axes[a]] - min;
+            if (!(extent > 0)) continue;
+
+            const auto bin_index = [min, extent, bins](double value) {
+                return std::min(static_cast<std::size_t>(std::max(value - min, 0.0) / extent * bins), bins - 1);
+            };
+
+            // Every shape is clipped into the bins it crosses, it enters the first and exits the last
+            std::vector<bin> bin_data(bins);
+            for (const build_primitive& reference: references) {
+                const std::size_t entry = bin_index(reference.box.get_min()[axes[a]]);
+                const std::size_t exit = bin_index(reference.box.get_max()[axes[a]]);
+                for (std::size_t i = entry; i <= exit; ++i)
+                    merge(bin_data[i].box, clip(reference, axes[a], min + extent * i / bins,
+                                                min + extent * (i + 1) / bins));
+                ++bin_data[entry].entries;
+                ++bin_data[exit].exits;
+            }
+
+            std::vector<std::optional<bardrix::bounding_box>> right_boxes(bins);
+            std::vector<std::size_t> right_counts(bins, 0);
+            for (std::size_t i = bins - 1; i > 0; --i) {
+                right_boxes[i - 1] = i < bins - 1 ? right_boxes[i] : std::nullopt;
+                merge(right_boxes[i - 1], bin_data[i].box);
+                right_counts[i - 1] = (i < bins - 1 ? right_counts[i] : 0) + bin_data[i].exits;
+            }
+
+            std::optional<bardrix::bounding_box> left_box;
+            std::size_t left_count = 0;
+            for (std::size_t i = 0; i + 1 < bins; ++i) {
+                merge(left_box, bin_data[i].box);
+                left_count += bin_data[i].entries;
+
+                // Both children must be smaller than the node and the duplicates must fit in the budget
+                if (left_count == 0 || right_counts[i] == 0 || left_count == count || right_counts[i] == count) continue;
+                if (left_count + right_counts[i] - count > budget) continue;
+
+                const double cost = left_box->area() * left_count + right_boxes[i]->area() * right_counts[i];
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    spatial = true;
+                    split_axis = axes[a];
+                    split_plane = min + extent * (i + 1) / bins;
+                }
+            }
+        }
+
+        std::vector<build_primitive> left;
+        std::vector<build_primitive> right;
+
+        if (spatial) {
+            // Shapes that cross the plane are referenced by both children, clipped to their side
+            for (build_primitive& reference: references) {
+                if (reference.box.get_max()[split_axis] <= split_plane) {
+                    left.push_back(std::move(reference));
+                } else if (reference.box.get_min()[split_axis] >= split_plane) {
+                    right.push_back(std::move(reference));
+                } else {
+                    // A side without a part of the shape doesn't get a reference
+                    const double infinity = std::numeric_limits<double>::infinity();
+                    std::optional<bardrix::bounding_box> left_box = clip(reference, split_axis, -infinity, split_plane);
+                    std::optional<bardrix::bounding_box> right_box = clip(reference, split_axis, split_plane, infinity);
+                    if (!left_box && !right_box) left_box = reference.box;
+
+                    if (left_box) left.push_back({ *left_box, left_box->center(), reference.index });
+                    if (right_box) right.push_back({ *right_box, right_box->center(), reference.index });
+                }
+            }
+
+            const std::size_t duplicates = left.size() + right.size() - count;
+            budget -= std::min(duplicates, budget);
+        } else if (split_axis != axis::none) {
+            const double min = centers.get_min()[split_axis];
+            const double extent = centers.get_max()[split_axis] - min;
+            for (build_primitive& reference: references) {
+                const auto index = std::min(static_cast<std::size_t>((reference.center[split_axis] - min) / extent * bins),
+                                            bins - 1);
+                (index < split_bin ? left : right).push_back(std::move(reference));
+            }
+        } else {
+            // The centers cannot be separated, split by count
+            left.assign(std::make_move_iterator(references.begin()),
+                        std::make_move_iterator(references.begin() + count / 2));
+            right.assign(std::make_move_iterator(references.begin() + count / 2),
+                         std::make_move_iterator(references.end()));
+        }
+
+        references.clear();
+        references.shrink_to_fit();
+
+        const std::size_t index = output.nodes.size();
+        output.nodes.emplace_back().set_bounding_box(box);
+
+        // The left child is the next node
+        construct_sbvh(output, shapes, std::move(left), bins, depth + 1, root_area, budget);
+        output.nodes[index].offset = static_cast<std::uint32_t>(output.nodes.size());
+        construct_sbvh(output, shapes, std::move(right), bins, depth + 1, root_area, budget);
+    }
+
+    double bvh_tree::sah_cost(double traversal_cost, double intersection_cost) const noexcept {
+        if (nodes_.empty()) return 0;
+
+        // If the root has no area every node is visited
+        const double root_area = nodes_.front().area();
+
+        double cost = 0;
+        for (const bvh_node& node: nodes_) {
+            const double probability = root_area > 0 ? node.area() / root_area : 1;
+            cost += node.is_leaf() ? intersection_cost * probability * node.count : traversal_cost * probability;
+        }
+
+        return cost;
     }
 
-    bvh_tree::bvh_tree() : binary_tree<bvh_data>(nullptr) {}
+    void bvh_tree::refit() {
+        // The children of a node are stored after the node, so they are refitted first
+        for (std::size_t i = nodes_.size(); i-- > 0;) {
+            bvh_node& node = nodes_[i];
+
+            if (node.is_leaf()) {
+                bardrix::bounding_box box = primitives_[node.offset]->bounding_box();
+                for (std::uint32_t j = 1; j < node.count; ++j)
+                    box.merge(primitives_[node.offset + j]->bounding_box());
+                node.set_bounding_box(box);
+                continue;
+            }
+
+            const bvh_node& left = nodes_[i + 1];
+            const bvh_node& right = nodes_[node.offset];
+            for (std::size_t a = 0; a < 3; ++a) {
+                node.min[a] = std::min(left.min[a], right.min[a]);
+                node.max[a] = std::max(left.max[a], right.max[a]);
+            }
+        }
+    }
+
+    double bvh_tree::degradation() const noexcept {
+        if (nodes_.empty() || build_cost_ <= 0) return 1;
+
+        return sah_cost() / build_cost_;
+    }
+
+    double bvh_tree::entry_distance(const bvh_node& node, const bardrix::ray& ray,
+                                    const bardrix::vector3& inverse_direction) noexcept {
+        const double t1 = (node.min[0] - ray.position.x) * inverse_direction.x;
+        const double t2 = (node.max[0] - ray.position.x) * inverse_direction.x;
+        const double t3 = (node.min[1] - ray.position.y) * inverse_direction.y;
+        const double t4 = (node.max[1] - ray.position.y) * inverse_direction.y;
+        const double t5 = (node.min[2] - ray.position.z) * inverse_direction.z;
+        const double t6 = (node.max[2] - ray.position.z) * inverse_direction.z;
+
+        const double tmin = std::max(std::max(std::min(t1, t2), std::min(t3, t4)), std::min(t5, t6));
+        const double tmax = std::min(std::min(std::max(t1, t2), std::max(t3, t4)), std::max(t5, t6));
+
+        return greater_than_or_nearly_equal(tmax, 0) &&
+               greater_than_or_nearly_equal(tmax, tmin) &&
+               greater_than_or_nearly_equal(ray.get_length(), tmin)
+               ? tmin
+               : std::numeric_limits<double>::infinity();
+    }
 
     void bvh_tree::intersections(const ray& ray, std::vector<const bardrix::shape*>& out_hits) const noexcept {
-        intersections(root, ray, out_hits);
+        if (nodes_.empty()) return;
+
+        const std::size_t first_hit = out_hits.size();
+
+        // The inverse direction is the same for every node
+        const bardrix::vector3 inverse_direction(1 / ray.get_direction().x, 1 / ray.get_direction().y,
+                                                 1 / ray.get_direction().z);
+
+        std::uint32_t stack[max_depth];
+        std::size_t stack_size = 0;
+        stack[stack_size++] = 0;
+
+        while (stack_size > 0) {
+            const bvh_node& node = nodes_[stack[--stack_size]];
+            if (entry_distance(node, ray, inverse_direction) == std::numeric_limits<double>::infinity()) continue;
+
+            if (node.is_leaf()) {
+                for (std::uint32_t i = 0; i < node.count; ++i)
+                    out_hits.push_back(primitives_[node.offset + i].get());
+                continue;
+            }
+
+            // Push the right child first, so the left child is visited first
+            stack[stack_size++] = node.offset;
+            stack[stack_size++] = static_cast<std::uint32_t>(&node - nodes_.data()) + 1;
+        }
+
+        // A shape in more than one leaf is only added once
+        if (duplicates_) {
+            std::sort(out_hits.begin() + first_hit, out_hits.end());
+            out_hits.erase(std::unique(out_hits.begin() + first_hit, out_hits.end()), out_hits.end());
+        }
+    }
+
+    double bvh_tree::entry_distance(const bvh_node& node, const bardrix::traversal_ray& ray) noexcept {
+        const double* bounds[2] = { node.min, node.max };
+        const bardrix::point3& origin = ray.get_origin();
+        const bardrix::vector3& inverse_direction = ray.get_inverse_direction();
+
+        const double tx_min = (bounds[ray.get_sign(0)][0] - origin.x) * inverse_direction.x;
+        const double tx_max = (bounds[1 - ray.get_sign(0)][0] - origin.x) * inverse_direction.x;
+        const double ty_min = (bounds[ray.get_sign(1)][1] - origin.y) * inverse_direction.y;
+        const double ty_max = (bounds[1 - ray.get_sign(1)][1] - origin.y) * inverse_direction.y;
+        const double tz_min = (bounds[ray.get_sign(2)][2] - origin.z) * inverse_direction.z;
+        const double tz_max = (bounds[1 - ray.get_sign(2)][2] - origin.z) * inverse_direction.z;
+
+        // The same slab test as bounding_box::intersects(traversal_ray), NaN leaves the interval as is
+        double t_min = ray.t_min;
+        double t_max = ray.t_max;
+        t_min = tx_min > t_min ? tx_min : t_min;
+        t_max = tx_max < t_max ? tx_max : t_max;
+        t_min = ty_min > t_min ? ty_min : t_min;
+        t_max = ty_max < t_max ? ty_max : t_max;
+        t_min = tz_min > t_min ? tz_min : t_min;
+        t_max = tz_max < t_max ? tz_max : t_max;
+
+        return t_min <= t_max ? t_min : std::numeric_limits<double>::infinity();
+    }
+
+    std::optional<bvh_hit> bvh_tree::closest_hit(const bardrix::ray& ray) const {
+        if (nodes_.empty()) return std::nullopt;
+
+        return closest_hit(nodes_.data(), [this](std::uint32_t index) { return primitives_[index].get(); }, ray);
+    }
+
+    void bvh_tree::closest_hits(const bardrix::ray* rays, std::size_t size,
+                                std::optional<bvh_hit>* out_hits) const {
+        for (std::size_t first = 0; first < size; first += max_packet_size)
+            closest_hits_packet(rays + first, std::min(size - first, max_packet_size), out_hits + first);
+    }
+
+    double bvh_tree::entry_distance(const bvh_node& node, const ray_packet& packet, std::size_t lane) noexcept {
+        const double* bounds[2] = { node.min, node.max };
+
+        // The same slab test as bounding_box::intersects(traversal_ray), NaN leaves the interval as is
+        double t_near = 0;
+        double t_far = packet.t_max[lane];
+        for (std::size_t a = 0; a < 3; ++a) {
+            const double near = (bounds[packet.sign[a][lane]][a] - packet.origin[a][lane]) * packet.inverse_direction[a][lane];
+            const double far = (bounds[1 - packet.sign[a][lane]][a] - packet.origin[a][lane]) * packet.inverse_direction[a][lane];
+            t_near = near > t_near ? near : t_near;
+            t_far = far < t_far ? far : t_far;
+        }
+
+        return t_near <= t_far ? t_near : std::numeric_limits<double>::infinity();
+    }
+
+    std::uint64_t bvh_tree::intersects(const bvh_node& node, const ray_packet& packet, std::uint64_t mask) noexcept {
+        std::uint64_t hits = 0;
+        for (std::size_t i = 0; i < max_packet_size; ++i) {
+            if (!(mask >> i & 1)) continue;
+
+            hits |= static_cast<std::uint64_t>(entry_distance(node, packet, i) != std::numeric_limits<double>::infinity()) << i;
+        }
+
+        return hits;
+    }
+
+    // helper function for closest_hits
+    void bvh_tree::closest_hits_packet(const bardrix::ray* rays, std::size_t size,
+                                       std::optional<bvh_hit>* out_hits) const {
+        for (std::size_t i = 0; i < size; ++i)
+            out_hits[i] = std::nullopt;
+
+        if (nodes_.empty() || size == 0) return;
+
+        ray_packet packet;
+        for (std::size_t i = 0; i < size; ++i) {
+            const bardrix::traversal_ray traversal(rays[i]);
+            packet.origin[0][i] = traversal.get_origin().x;
+            packet.origin[1][i] = traversal.get_origin().y;
+            packet.origin[2][i] = traversal.get_origin().z;
+            packet.inverse_direction[0][i] = traversal.get_inverse_direction().x;
+            packet.inverse_direction[1][i] = traversal.get_inverse_direction().y;
+            packet.inverse_direction[2][i] = traversal.get_inverse_direction().z;
+            packet.t_max[i] = traversal.t_max;
+            for (std::size_t a = 0; a < 3; ++a)
+                packet.sign[a][i] = traversal.get_sign(a);
+        }
+
+        // Every node on the stack has the rays that are active in it
+        std::uint32_t stack[max_depth];
+        std::uint64_t stack_mask[max_depth];
+        std::size_t stack_size = 0;
+
+        stack[stack_size] = 0;
+        stack_mask[stack_size++] = size == max_packet_size ? ~std::uint64_t(0) : (std::uint64_t(1) << size) - 1;
+
+        while (stack_size > 0) {
+            --stack_size;
+            const bvh_node& node = nodes_[stack[stack_size]];
+
+            // Rays that found a closer hit since the node was pushed drop out here
+            const std::uint64_t mask = intersects(node, packet, stack_mask[stack_size]);
+            if (!mask) continue;
+
+            if (node.is_leaf()) {
+                for (std::size_t i = 0; i < size; ++i) {
+                    if (!(mask >> i & 1)) continue;
+
+                    // The ray is shortened to its closest hit so far, shapes beyond it are skipped
+                    bardrix::ray query = rays[i];
+                    query.set_length(packet.t_max[i]);
+
+                    for (std::uint32_t j = 0; j < node.count; ++j) {
+                        const bardrix::shape* shape = primitives_[node.offset + j].get();
+                        const double distance = shape->intersect_distance(query);
+                        if (distance == std::numeric_limits<double>::infinity()) continue;
+                        if (out_hits[i] && distance >= out_hits[i]->distance) continue;
+
+                        out_hits[i] = bvh_hit{ shape, distance };
+                        query.set_length(distance);
+                        packet.t_max[i] = distance;
+                    }
+                }
+                continue;
+            }
+
+            // The first active ray decides which child is visited first, with its prepared lane of the packet
+            std::size_t first = 0;
+            while (!(mask >> first & 1)) ++first;
+
+            const std::uint32_t left = static_cast<std::uint32_t>(&node - nodes_.data()) + 1;
+            const bool left_first = entry_distance(nodes_[left], packet, first) <=
+                                    entry_distance(nodes_[node.offset], packet, first);
+
+            // Push the farthest child first, so the nearest child is visited first
+            stack[stack_size] = left_first ? node.offset : left;
+            stack_mask[stack_size++] = mask;
+            stack[stack_size] = left_first ? left : node.offset;
+            stack_mask[stack_size++] = mask;
+        }
+    }
+
+    bool bvh_tree::occluded(const bardrix::ray& ray) const {
+        if (nodes_.empty()) return false;
+
+        return occluded(nodes_.data(), [this](std::uint32_t index) { return primitives_[index].get(); }, ray);
+    }
+
+    const std::vector<bvh_node>& bvh_tree::nodes() const noexcept { return nodes_; }
+
+    const std::vector<std::shared_ptr<bardrix::shape>>& bvh_tree::primitives() const noexcept { return primitives_; }
+
+    bool bvh_tree::is_empty() const noexcept { return nodes_.empty(); }
+
+    void bvh_tree::clear() noexcept {
+        nodes_.clear();
+        primitives_.clear();
+        build_cost_ = 0;
+        duplicates_ = false;
+    }
+
+    void bvh_tree::save(const std::string& path, const std::vector<std::shared_ptr<bardrix::shape>>& shapes) const {
+        std::unordered_map<const bardrix::shape*, std::uint32_t> shape_indices;
+        shape_indices.reserve(shapes.size());
+        for (std::size_t i = 0; i < shapes.size(); ++i)
+            shape_indices.emplace(shapes[i].get(), static_cast<std::uint32_t>(i));
+
+        std::vector<std::uint32_t> indices(primitives_.size());
+        for (std::size_t i = 0; i < primitives_.size(); ++i) {
+            auto it = shape_indices.find(primitives_[i].get());
+            if (it == shape_indices.end())
+                throw std::invalid_argument("Shape of the BVH tree is not in the given shapes");
+            indices[i] = it->second;
+        }
+
+        bvh_file_header header{};
+        std::memcpy(header.magic, bvh_file_magic, sizeof(bvh_file_magic));
+        header.version = file_version;
+        header.byte_order = bvh_file_byte_order;
+        header.node_size = sizeof(bvh_node);
+        header.node_count = nodes_.size();
+        header.primitive_count = indices.size();
+        header.build_cost = build_cost_;
+        header.flags = duplicates_ ? bvh_file_duplicates : 0;
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(nodes_.data()),
+                   static_cast<std::streamsize>(nodes_.size() * sizeof(bvh_node)));
+        file.write(reinterpret_cast<const char*>(indices.data()),
+                   static_cast<std::streamsize>(indices.size() * sizeof(std::uint32_t)));
+        file.close();
+
+        if (!file)
+            throw std::runtime_error("Cannot write BVH file " + path);
+    }
+
+    void bvh_tree::load(const std::string& path, const std::vector<std::shared_ptr<bardrix::shape>>& shapes) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+            throw std::runtime_error("Cannot read BVH file " + path);
+
+        std::vector<std::uint8_t> data(static_cast<std::size_t>(file.tellg()));
+        file.seekg(0);
+        if (!file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size())))
+            throw std::runtime_error("Cannot read BVH file " + path);
+
+        const bvh_file_header header = read_bvh_file_header(data.data(), data.size());
+
+        std::vector<bvh_node> nodes(header.node_count);
+        if (!nodes.empty())
+            std::memcpy(nodes.data(), data.data() + sizeof(header), nodes.size() * sizeof(bvh_node));
+        check_bvh_file_nodes(nodes.data(), header);
+
+        std::vector<std::shared_ptr<bardrix::shape>> primitives(header.primitive_count);
+        const std::uint8_t* indices = data.data() + sizeof(header) + nodes.size() * sizeof(bvh_node);
+        for (std::size_t i = 0; i < primitives.size(); ++i) {
+            std::uint32_t index;
+            std::memcpy(&index, indices + i * sizeof(index), sizeof(index));
+            if (index >= shapes.size())
+                throw std::runtime_error("BVH file references a shape that is not in the given shapes");
+            primitives[i] = shapes[index];
+        }
+
+        nodes_ = std::move(nodes);
+        primitives_ = std::move(primitives);
+        build_cost_ = header.build_cost;
+        duplicates_ = (header.flags & bvh_file_duplicates) != 0;
+    }
+
+    // mapped_bvh
+
+    mapped_bvh::mapped_bvh() noexcept = default;
+
+    mapped_bvh::mapped_bvh(const std::string& path) { open(path); }
+
+    mapped_bvh::mapped_bvh(mapped_bvh&& other) noexcept { *this = std::move(other); }
+
+    mapped_bvh& mapped_bvh::operator=(mapped_bvh&& other) noexcept {
+        if (this == &other) return *this;
+
+        close();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        nodes_ = std::exchange(other.nodes_, nullptr);
+        node_count_ = std::exchange(other.node_count_, 0);
+        indices_ = std::exchange(other.indices_, nullptr);
+        primitive_count_ = std::exchange(other.primitive_count_, 0);
+        shape_count_ = std::exchange(other.shape_count_, 0);
+        return *this;
+    }
+
+    mapped_bvh::~mapped_bvh() { close(); }
+
+    void mapped_bvh::open(const std::string& path) {
+        close();
+
+        const void* data = nullptr;
+        std::size_t size = 0;
+
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            throw std::runtime_error("Cannot open BVH file " + path);
+
+        LARGE_INTEGER file_size{};
+        if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+            CloseHandle(file);
+            throw std::runtime_error("Cannot map BVH file " + path);
+        }
+
+        // The view keeps the file mapped after the handles are closed
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping != nullptr) {
+            data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+
+        if (data == nullptr)
+            throw std::runtime_error("Cannot map BVH file " + path);
+        size = static_cast<std::size_t>(file_size.QuadPart);
+#else
+        const int file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0)
+            throw std::runtime_error("Cannot open BVH file " + path);
+
+        struct stat status{};
+        if (fstat(file, &status) != 0 || status.st_size == 0) {
+            ::close(file);
+            throw std::runtime_error("Cannot map BVH file " + path);
+        }
+
+        // The mapping stays valid after the file is closed
+        size = static_cast<std::size_t>(status.st_size);
+        data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+        ::close(file);
+
+        if (data == MAP_FAILED)
+            throw std::runtime_error("Cannot map BVH file " + path);
+#endif
+
+        data_ = static_cast<const std::uint8_t*>(data);
+        size_ = size;
+
+        bvh_file_header header{};
+        try {
+            header = read_bvh_file_header(data_, size_);
+
+            // The file is mapped at a page boundary and the header is 64 bytes, so the nodes and indices are aligned
+            nodes_ = reinterpret_cast<const bvh_node*>(data_ + sizeof(header));
+            check_bvh_file_nodes(nodes_, header);
+        }
+        catch (...) {
+            close();
+            throw;
+        }
+
+        node_count_ = static_cast<std::size_t>(header.node_count);
+        indices_ = reinterpret_cast<const std::uint32_t*>(data_ + sizeof(header) + node_count_ * sizeof(bvh_node));
+        primitive_count_ = static_cast<std::size_t>(header.primitive_count);
+
+        // The queries check the given shapes against the largest shape index once, instead of every index
+        for (std::size_t i = 0; i < primitive_count_; ++i)
+            shape_count_ = std::max(shape_count_, static_cast<std::size_t>(indices_[i]) + 1);
+    }
+
+    void mapped_bvh::close() noexcept {
+        if (data_ != nullptr) {
+#if defined(_WIN32)
+            UnmapViewOfFile(data_);
+#else
+            munmap(const_cast<std::uint8_t*>(data_), size_);
+#endif
+        }
+
+        data_ = nullptr;
+        size_ = 0;
+        nodes_ = nullptr;
+        node_count_ = 0;
+        indices_ = nullptr;
+        primitive_count_ = 0;
+        shape_count_ = 0;
     }
 
-    void bvh_tree::intersections(const std::unique_ptr<node>& current, const ray& ray,
-                             std::vector<const bardrix::shape*>& out_hits) const noexcept {
-        if (!current) return;
-        if (!current->data.box.intersects(ray)) return;
+    bool mapped_bvh::is_open() const noexcept { return data_ != nullptr; }
+
+    std::optional<bvh_hit> mapped_bvh::closest_hit(const bardrix::ray& ray,
+                                                   const std::vector<std::shared_ptr<bardrix::shape>>& shapes) const {
+        if (node_count_ == 0) return std::nullopt;
+        if (shapes.size() < shape_count_)
+            throw std::invalid_argument("BVH file references a shape that is not in the given shapes");
+
+        return bvh_tree::closest_hit(nodes_, [&](std::uint32_t index) { return shapes[indices_[index]].get(); }, ray);
+    }
+
+    bool mapped_bvh::occluded(const bardrix::ray& ray,
+                              const std::vector<std::shared_ptr<bardrix::shape>>& shapes) const {
+        if (node_count_ == 0) return false;
+        if (shapes.size() < shape_count_)
+            throw std::invalid_argument("BVH file references a shape that is not in the given shapes");
+
+        return bvh_tree::occluded(nodes_, [&](std::uint32_t index) { return shapes[indices_[index]].get(); }, ray);
+    }
+
+    const bvh_node* mapped_bvh::nodes() const noexcept { return nodes_; }
+
+    std::size_t mapped_bvh::node_count() const noexcept { return node_count_; }
+
+    const std::uint32_t* mapped_bvh::indices() const noexcept { return indices_; }
+
+    std::size_t mapped_bvh::primitive_count() const noexcept { return primitive_count_; }
+
+    // wide_bvh
+
+    template<std::size_t N>
+    wide_bvh<N>::wide_bvh() = default;
+
+    template<std::size_t N>
+    void wide_bvh<N>::collapse(const bvh_tree& tree) {
+        clear();
+        if (tree.is_empty()) return;
+
+        primitives_ = tree.primitives();
+        nodes_.reserve(tree.nodes().size() / (N - 1) + 1);
+
+        // A single leaf still gets a wide node, so the root is always a node
+        if (tree.nodes().front().is_leaf()) {
+            const bvh_node& leaf = tree.nodes().front();
+            nodes_.emplace_back().bounds.set(0, leaf.bounding_box());
+            nodes_.front().child[0] = leaf.offset;
+            nodes_.front().count[0] = leaf.count;
+            return;
+        }
+
+        collapse(tree, 0);
+    }
+
+    // helper function for collapse
+    template<std::size_t N>
+    std::uint32_t wide_bvh<N>::collapse(const bvh_tree& tree, std::uint32_t index) {
+        const std::vector<bvh_node>& binary = tree.nodes();
+
+        // Open the interior child with the largest area until there are N children
+        std::uint32_t children[N] = { index + 1, binary[index].offset };
+        std::size_t size = 2;
+        while (size < N) {
+            std::size_t largest = N;
+            for (std::size_t i = 0; i < size; ++i)
+                if (!binary[children[i]].is_leaf() &&
+                    (largest == N || binary[children[i]].area() > binary[children[largest]].area()))
+                    largest = i;
+
+            if (largest == N) break;
+
+            const std::uint32_t opened = children[largest];
+            children[largest] = opened + 1;
+            children[size++] = binary[opened].offset;
+        }
+
+        // The node is value initialized, unused children are empty with a count of 0
+        const auto wide_index = static_cast<std::uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+
+        for (std::size_t lane = 0; lane < size; ++lane) {
+            const bvh_node& child = binary[children[lane]];
+            nodes_[wide_index].bounds.set(lane, child.bounding_box());
+
+            // The nodes can move while collapsing the child, so it's assigned afterwards
+            const std::uint32_t child_index = child.is_leaf() ? child.offset : collapse(tree, children[lane]);
+            nodes_[wide_index].child[lane] = child_index;
+            nodes_[wide_index].count[lane] = child.count;
+        }
+
+        return wide_index;
+    }
+
+    template<std::size_t N>
+    std::optional<bvh_hit> wide_bvh<N>::closest_hit(const bardrix::ray& ray) const {
+        if (nodes_.empty()) return std::nullopt;
+
+        // The ray is shortened to the closest hit so far, nodes and shapes beyond it are skipped
+        bardrix::ray query = ray;
+        bardrix::traversal_ray traversal(ray);
+        std::optional<bvh_hit> closest;
+
+        // Every node pops one entry and pushes at most N - 1 more, for every level of the tree
+        std::uint32_t stack[bvh_tree::max_depth * N];
+        double stack_distance[bvh_tree::max_depth * N];
+        std::size_t stack_size = 0;
+
+        stack[stack_size] = 0;
+        stack_distance[stack_size++] = traversal.t_min;
+
+        while (stack_size > 0) {
+            --stack_size;
+
+            // A closer hit may have been found since the node was pushed
+            if (stack_distance[stack_size] > traversal.t_max) continue;
+
+            const wide_bvh_node<N>& node = nodes_[stack[stack_size]];
+
+            double entry[N];
+            std::uint32_t mask = node.bounds.intersects(traversal, entry);
+
+            // Sort the children that were hit from near to far
+            std::size_t lanes[N];
+            std::size_t hits = 0;
+            for (; mask; mask &= mask - 1) {
+                std::size_t lane = 0;
+                while (!(mask >> lane & 1)) ++lane;
+
+                std::size_t i = hits++;
+                for (; i > 0 && entry[lanes[i - 1]] > entry[lane]; --i)
+                    lanes[i] = lanes[i - 1];
+                lanes[i] = lane;
+            }
+
+            // Leaves are tested right away, near to far, so the ray is as short as possible for the interior children
+            for (std::size_t i = 0; i < hits; ++i) {
+                const std::size_t lane = lanes[i];
+                if (node.count[lane] == 0 || entry[lane] > traversal.t_max) continue;
+
+                for (std::uint32_t j = 0; j < node.count[lane]; ++j) {
+                    const bardrix::shape* shape = primitives_[node.child[lane] + j].get();
+                    const double distance = shape->intersect_distance(query);
+                    if (distance == std::numeric_limits<double>::infinity()) continue;
+                    if (closest && distance >= closest->distance) continue;
+
+                    closest = bvh_hit{ shape, distance };
+                    query.set_length(distance);
+                    traversal.t_max = distance;
+                }
+            }
+
+            // Push the farthest interior child first, so the nearest one is visited first
+            for (std::size_t i = hits; i-- > 0;) {
+                const std::size_t lane = lanes[i];
+                if (node.count[lane] != 0 || entry[lane] > traversal.t_max) continue;
+
+                stack[stack_size] = node.child[lane];
+                stack_distance[stack_size++] = entry[lane];
+            }
+        }
+
+        return closest;
+    }
+
+    template<std::size_t N>
+    bool wide_bvh<N>::occluded(const bardrix::ray& ray) const {
+        if (nodes_.empty()) return false;
+
+        const bardrix::traversal_ray traversal(ray);
+
+        std::uint32_t stack[bvh_tree::max_depth * N];
+        std::size_t stack_size = 0;
+        stack[stack_size++] = 0;
+
+        while (stack_size > 0) {
+            const wide_bvh_node<N>& node = nodes_[stack[--stack_size]];
+
+            double entry[N];
+            for (std::uint32_t mask = node.bounds.intersects(traversal, entry); mask; mask &= mask - 1) {
+                std::size_t lane = 0;
+                while (!(mask >> lane & 1)) ++lane;
+
+                if (node.count[lane] == 0) {
+                    stack[stack_size++] = node.child[lane];
+                    continue;
+                }
+
+                // Any hit will do, there is no need to find the closest one
+                for (std::uint32_t j = 0; j < node.count[lane]; ++j)
+                    if (primitives_[node.child[lane] + j]->intersect_distance(ray) != std::numeric_limits<double>::infinity())
+                        return true;
+            }
+        }
+
+        return false;
+    }
+
+    template<std::size_t N>
+    const std::vector<wide_bvh_node<N>>& wide_bvh<N>::nodes() const noexcept { return nodes_; }
+
+    template<std::size_t N>
+    const std::vector<std::shared_ptr<bardrix::shape>>& wide_bvh<N>::primitives() const noexcept { return primitives_; }
+
+    template<std::size_t N>
+    bool wide_bvh<N>::is_empty() const noexcept { return nodes_.empty(); }
+
+    template<std::size_t N>
+    void wide_bvh<N>::clear() noexcept {
+        nodes_.clear();
+        primitives_.clear();
+    }
+
+    template class wide_bvh<4>;
+    template class wide_bvh<8>;
+
+    // bvh_instance
+
+    bvh_instance::bvh_instance(std::shared_ptr<const bvh_tree> tree, const bardrix::quaternion& rotation,
+                               const bardrix::vector3& translation) : tree(std::move(tree)),
+                                                                      rotation(rotation.normalized()),
+                                                                      translation(translation) {
+        // to_instance keeps distances along the ray, which only holds for a unit quaternion
+        if (!(rotation.length() > 0) || !std::isfinite(rotation.length()))
+            throw std::invalid_argument("Rotation of a BVH instance cannot be a zero quaternion");
+    }
+
+    bardrix::point3 bvh_instance::to_world(const bardrix::point3& point) const noexcept {
+        return rotation.rotate(point) + translation;
+    }
+
+    bardrix::vector3 bvh_instance::to_world(const bardrix::vector3& vector) const noexcept {
+        return rotation.rotate(vector);
+    }
+
+    bardrix::ray bvh_instance::to_instance(const bardrix::ray& ray) const noexcept {
+        // A rotation keeps the length of the direction, so distances along the ray stay the same
+        return { rotation.rotate_inverse(ray.position - translation), rotation.rotate_inverse(ray.get_direction()),
+                 ray.get_length() };
+    }
+
+    bardrix::bounding_box bvh_instance::bounding_box() const {
+        const bvh_node& root = tree->nodes().front();
+
+        // The bounding box around the 8 rotated corners
+        std::optional<bardrix::bounding_box> box;
+        for (int corner = 0; corner < 8; ++corner) {
+            const bardrix::point3 point = to_world(bardrix::point3(corner & 1 ? root.max[0] : root.min[0],
+                                                                   corner & 2 ? root.max[1] : root.min[1],
+                                                                   corner & 4 ? root.max[2] : root.min[2]));
+            if (box) box->merge({ point, point });
+            else box = bardrix::bounding_box(point, point);
+        }
+
+        return *box;
+    }
+
+    // instanced_bvh
+
+    instanced_bvh::instanced_bvh() = default;
+
+    void instanced_bvh::construct(std::vector<bvh_instance> instances, std::size_t threads) {
+        clear();
+        instances_ = std::move(instances);
+
+        std::vector<bvh_tree::build_primitive> primitives;
+        primitives.reserve(instances_.size());
+        for (std::size_t i = 0; i < instances_.size(); ++i) {
+            if (!instances_[i].tree || instances_[i].tree->is_empty()) continue;
+
+            bardrix::bounding_box box = instances_[i].bounding_box();
+            bardrix::point3 center = box.center();
+            primitives.push_back({ std::move(box), std::move(center), static_cast<std::uint32_t>(i) });
+        }
+        if (primitives.empty()) return;
+
+        bvh_tree::build_output output = bvh_tree::build_sah(primitives, bvh_tree::default_sah_bins,
+                                                            bvh_tree::thread_count(threads));
+        nodes_ = std::move(output.nodes);
+        indices_ = std::move(output.indices);
+    }
+
+    std::optional<instance_hit> instanced_bvh::closest_hit(const bardrix::ray& ray) const {
+        if (nodes_.empty()) return std::nullopt;
+
+        // The shape of the closest hit so far, a hit is only given to the traversal if it's closer
+        const bardrix::shape* closest_shape = nullptr;
+        double closest_distance = std::numeric_limits<double>::infinity();
+
+        // The ray is traced through the tree of the instance in instance space
+        const auto intersect = [&](std::uint32_t primitive, const bardrix::ray& query) {
+            const bvh_instance& instance = instances_[indices_[primitive]];
+            const std::optional<bvh_hit> hit = instance.tree->closest_hit(instance.to_instance(query));
+            if (!hit || hit->distance >= closest_distance) return std::numeric_limits<double>::infinity();
+
+            closest_shape = hit->shape;
+            closest_distance = hit->distance;
+            return hit->distance;
+        };
+
+        std::uint32_t primitive;
+        double distance;
+        if (!bvh_tree::closest_primitive(nodes_.data(), intersect, ray, primitive, distance)) return std::nullopt;
+
+        return instance_hit{ indices_[primitive], closest_shape, distance };
+    }
+
+    bool instanced_bvh::occluded(const bardrix::ray& ray) const {
+        if (nodes_.empty()) return false;
+
+        const auto intersects = [&](std::uint32_t primitive) {
+            const bvh_instance& instance = instances_[indices_[primitive]];
+            return instance.tree->occluded(instance.to_instance(ray));
+        };
+
+        return bvh_tree::any_primitive(nodes_.data(), intersects, ray);
+    }
+
+    const std::vector<bvh_node>& instanced_bvh::nodes() const noexcept { return nodes_; }
+
+    const std::vector<bvh_instance>& instanced_bvh::instances() const noexcept { return instances_; }
 
-        if (current->data.shape)
-            out_hits.push_back(current->data.shape.get());
+    bool instanced_bvh::is_empty() const noexcept { return nodes_.empty(); }
 
-        intersections(current->left, ray, out_hits);
-        intersections(current->right, ray, out_hits);
+    void instanced_bvh::clear() noexcept {
+        nodes_.clear();
+        instances_.clear();
+        indices_.clear();
     }
 
-} // namespace bardrix
\ No newline at end of file
+} // namespace bardrix
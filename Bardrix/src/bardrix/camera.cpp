@@ -3,6 +3,7 @@
 //
 
 #include <bardrix/camera.h>
+#include <bardrix/expression.h>
 
 namespace bardrix {
 
@@ -71,14 +72,24 @@ namespace bardrix {
         const double ratio_width = x / static_cast<double>(width_);
         const double ratio_height = y / static_cast<double>(height_);
 
-        // horizontal and vertical vectors
-        const vector3 horizontal = right_ * 2 * ratio_width;
-        const vector3 vertical = up_ * 2 * ratio_height;
+        // top left corner of the screen, plus the horizontal and vertical vectors
+        // evaluated in one pass, without a temporary for every operator
+        const point3 target = lazy(position) + direction_ - right_ + up_
+                              + lazy(right_) * 2 * ratio_width - lazy(up_) * 2 * ratio_height;
 
-        // top left corner of the screen
-        const point3 top_left = position + direction_ - right_ + up_;
+        return std::make_optional(ray{position, position.vector_to(target), distance});
+    }
+
+    void camera::shoot_rays(int x, int y, int width, int height, double distance,
+                            std::vector<bardrix::ray>& out_rays) const {
+        out_rays.clear();
 
-        return std::make_optional(ray{position, position.vector_to(top_left + horizontal - vertical), distance});
+        for (int j = y; j < y + height; ++j) {
+            for (int i = x; i < x + width; ++i) {
+                std::optional<ray> ray = shoot_ray(i, j, distance);
+                if (ray) out_rays.push_back(*ray);
+            }
+        }
     }
 
     void camera::look_at(const point3& point) noexcept {
@@ -24,4 +24,8 @@ namespace bardrix{
                 throw std::invalid_argument("Invalid axis");
         }
     }
+
+    double dimension4::operator[](axis axis) const {
+        return const_cast<dimension4&>(*this)[axis];
+    }
 }
\ No newline at end of file
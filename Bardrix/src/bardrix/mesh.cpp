@@ -0,0 +1,350 @@
+//
+// Created by Bardio on 16/10/2026.
+//
+
+#include <bardrix/mesh.h>
+
+namespace bardrix {
+
+    namespace {
+
+        /// \brief A ray prepared for the watertight ray-triangle test, the ray is sheared so it points along +z.
+        struct watertight_ray {
+            /// \brief The origin of the ray (x, y, z).
+            double origin[3];
+
+            /// \brief The axes of the direction, kz is the largest component, kx and ky keep the winding.
+            int kx, ky, kz;
+
+            /// \brief The shear constants.
+            double sx, sy, sz;
+
+            /// \brief The length of the ray, hits at or beyond it are ignored.
+            double length;
+
+            explicit watertight_ray(const bardrix::ray& ray) noexcept {
+                const bardrix::vector3& direction = ray.get_direction();
+                const double d[3] = { direction.x, direction.y, direction.z };
+
+                origin[0] = ray.position.x;
+                origin[1] = ray.position.y;
+                origin[2] = ray.position.z;
+
+                kz = 0;
+                if (std::abs(d[1]) > std::abs(d[kz])) kz = 1;
+                if (std::abs(d[2]) > std::abs(d[kz])) kz = 2;
+                kx = (kz + 1) % 3;
+                ky = (kx + 1) % 3;
+
+                // Keeps the winding of the triangles the same when the ray points along -z
+                if (d[kz] < 0) std::swap(kx, ky);
+
+                sx = d[kx] / d[kz];
+                sy = d[ky] / d[kz];
+                sz = 1.0 / d[kz];
+                length = ray.get_length();
+            }
+
+            /// \brief Intersects the ray with a triangle, both sides of the triangle are hit.
+            /// \param a, b, c The vertices of the triangle (x, y, z).
+            /// \return The distance to the hit, infinity if the triangle isn't hit within (0, length).
+            NODISCARD double intersect(const double* a, const double* b, const double* c) const noexcept {
+                const double ax = a[kx] - origin[kx], ay = a[ky] - origin[ky], az = a[kz] - origin[kz];
+                const double bx = b[kx] - origin[kx], by = b[ky] - origin[ky], bz = b[kz] - origin[kz];
+                const double cx = c[kx] - origin[kx], cy = c[ky] - origin[ky], cz = c[kz] - origin[kz];
+
+                // Shears the vertices, so the ray starts at the origin and points along +z
+                const double sax = ax - sx * az, say = ay - sy * az;
+                const double sbx = bx - sx * bz, sby = by - sy * bz;
+                const double scx = cx - sx * cz, scy = cy - sy * cz;
+
+                // The scaled barycentric coordinates
+                double u = scx * sby - scy * sbx;
+                double v = sax * scy - say * scx;
+                double w = sbx * say - sby * sax;
+
+                // On an edge the sign is decided with more precision, so the ray hits one of the two triangles
+                if (u == 0 || v == 0 || w == 0) {
+                    u = static_cast<double>(static_cast<long double>(scx) * sby - static_cast<long double>(scy) * sbx);
+                    v = static_cast<double>(static_cast<long double>(sax) * scy - static_cast<long double>(say) * scx);
+                    w = static_cast<double>(static_cast<long double>(sbx) * say - static_cast<long double>(sby) * sax);
+                }
+
+                const double miss = std::numeric_limits<double>::infinity();
+                if ((u < 0 || v < 0 || w < 0) && (u > 0 || v > 0 || w > 0)) return miss;
+
+                const double determinant = u + v + w;
+                if (determinant == 0) return miss;
+
+                const double distance = (u * sz * az + v * sz * bz + w * sz * cz) / determinant;
+                return distance > 0 && distance < length ? distance : miss;
+            }
+        };
+
+    } // namespace
+
+    // MESH BUFFERS
+
+    template<typename T>
+    mesh_buffers<T>::mesh_buffers(std::vector<T> vertices, std::vector<std::uint32_t> indices, std::size_t leaf_size,
+                                  std::size_t threads) : vertices_(std::move(vertices)), indices_(std::move(indices)) {
+        if (vertices_.size() % 3 != 0)
+            throw std::invalid_argument("The number of vertex coordinates must be a multiple of 3");
+        if (indices_.size() % 3 != 0)
+            throw std::invalid_argument("The number of indices must be a multiple of 3");
+        if (triangle_count() > std::numeric_limits<std::uint32_t>::max())
+            throw std::invalid_argument("A mesh can't contain more than 2^32 triangles");
+
+        const std::size_t count = vertex_count();
+        for (const std::uint32_t index: indices_)
+            if (index >= count)
+                throw std::invalid_argument("An index is not a vertex of the mesh");
+
+        if (indices_.empty()) return;
+
+        std::vector<bvh_tree::build_primitive> primitives;
+        primitives.reserve(triangle_count());
+        for (std::size_t i = 0; i < triangle_count(); ++i) {
+            const bardrix::point3 a = vertex(indices_[i * 3]);
+            const bardrix::point3 b = vertex(indices_[i * 3 + 1]);
+            const bardrix::point3 c = vertex(indices_[i * 3 + 2]);
+
+            bardrix::bounding_box box(a.min(b).min(c), a.max(b).max(c));
+            bardrix::point3 center = box.center();
+            primitives.push_back({ std::move(box), std::move(center), static_cast<std::uint32_t>(i) });
+        }
+
+        bvh_tree::build_output output = bvh_tree::build_sah(primitives, bvh_tree::default_sah_bins,
+                                                            bvh_tree::thread_count(threads));
+        bvh_tree::merge_leaves(output, std::max<std::size_t>(leaf_size, 1));
+
+        nodes_ = std::move(output.nodes);
+        triangles_ = std::move(output.indices);
+    }
+
+    template<typename T>
+    bardrix::point3 mesh_buffers<T>::vertex(std::size_t index) const noexcept {
+        return { static_cast<double>(vertices_[index * 3]), static_cast<double>(vertices_[index * 3 + 1]),
+                 static_cast<double>(vertices_[index * 3 + 2]) };
+    }
+
+    template<typename T>
+    std::size_t mesh_buffers<T>::vertex_count() const noexcept { return vertices_.size() / 3; }
+
+    template<typename T>
+    std::size_t mesh_buffers<T>::triangle_count() const noexcept { return indices_.size() / 3; }
+
+    template<typename T>
+    const std::vector<T>& mesh_buffers<T>::vertices() const noexcept { return vertices_; }
+
+    template<typename T>
+    const std::vector<std::uint32_t>& mesh_buffers<T>::indices() const noexcept { return indices_; }
+
+    template<typename T>
+    const std::vector<bvh_node>& mesh_buffers<T>::nodes() const noexcept { return nodes_; }
+
+    template<typename T>
+    bardrix::bounding_box mesh_buffers<T>::bounding_box() const noexcept {
+        if (nodes_.empty()) return { bardrix::point3(0, 0, 0), bardrix::point3(0, 0, 0) };
+
+        return nodes_.front().bounding_box();
+    }
+
+    template<typename T>
+    bardrix::vector3 mesh_buffers<T>::normal(std::size_t triangle) const {
+        const bardrix::point3 a = vertex(indices_[triangle * 3]);
+        return a.vector_to(vertex(indices_[triangle * 3 + 1]))
+                .cross(a.vector_to(vertex(indices_[triangle * 3 + 2])))
+                .normalized();
+    }
+
+    template<typename T>
+    std::optional<bardrix::hit> mesh_buffers<T>::closest_hit(const bardrix::ray& ray) const {
+        if (nodes_.empty()) return std::nullopt;
+
+        // The shear of the ray only depends on its direction, so it's computed once per ray
+        const watertight_ray prepared(ray);
+        const auto intersect = [this, &prepared](std::uint32_t primitive, const bardrix::ray& query) {
+            const std::uint32_t* triangle = &indices_[static_cast<std::size_t>(triangles_[primitive]) * 3];
+            double a[3], b[3], c[3];
+            for (int i = 0; i < 3; ++i) {
+                a[i] = static_cast<double>(vertices_[static_cast<std::size_t>(triangle[0]) * 3 + i]);
+                b[i] = static_cast<double>(vertices_[static_cast<std::size_t>(triangle[1]) * 3 + i]);
+                c[i] = static_cast<double>(vertices_[static_cast<std::size_t>(triangle[2]) * 3 + i]);
+            }
+
+            // The closest_primitive traversal shortens the query, hits beyond it don't matter
+            const double distance = prepared.intersect(a, b, c);
+            return distance < query.get_length() ? distance : std::numeric_limits<double>::infinity();
+        };
+
+        std::uint32_t primitive;
+        double distance;
+        if (!bvh_tree::closest_primitive(nodes_.data(), intersect, ray, primitive, distance)) return std::nullopt;
+
+        const std::uint32_t triangle = triangles_[primitive];
+        return bardrix::hit{ distance, ray.position + ray.get_direction() * distance, normal(triangle), triangle };
+    }
+
+    template<typename T>
+    bool mesh_buffers<T>::occluded(const bardrix::ray& ray) const {
+        if (nodes_.empty()) return false;
+
+        const watertight_ray prepared(ray);
+        const auto intersects = [this, &prepared](std::uint32_t primitive) {
+            const std::uint32_t* triangle = &indices_[static_cast<std::size_t>(triangles_[primitive]) * 3];
+            double a[3], b[3], c[3];
+            for (int i = 0; i < 3; ++i) {
+                a[i] = static_cast<double>(vertices_[static_cast<std::size_t>(triangle[0]) * 3 + i]);
+                b[i] = static_cast<double>(vertices_[static_cast<std::size_t>(triangle[1]) * 3 + i]);
+                c[i] = static_cast<double>(vertices_[static_cast<std::size_t>(triangle[2]) * 3 + i]);
+            }
+
+            return prepared.intersect(a, b, c) != std::numeric_limits<double>::infinity();
+        };
+
+        return bvh_tree::any_primitive(nodes_.data(), intersects, ray);
+    }
+
+    template<typename T>
+    bardrix::vector3 mesh_buffers<T>::normal_at(const bardrix::point3& point) const {
+        bardrix::vector3 closest_normal(0, 0, 0);
+        if (nodes_.empty()) return closest_normal;
+
+        const double p[3] = { point.x, point.y, point.z };
+        double closest_distance = bardrix::epsilon;
+
+        std::uint32_t stack[bvh_tree::max_depth];
+        std::size_t stack_size = 0;
+        stack[stack_size++] = 0;
+
+        while (stack_size > 0) {
+            const std::uint32_t index = stack[--stack_size];
+            const bvh_node& node = nodes_[index];
+
+            bool inside = true;
+            for (int axis = 0; axis < 3; ++axis)
+                inside = inside && p[axis] >= node.min[axis] - bardrix::epsilon &&
+                         p[axis] <= node.max[axis] + bardrix::epsilon;
+            if (!inside) continue;
+
+            if (!node.is_leaf()) {
+                stack[stack_size++] = node.offset;
+                stack[stack_size++] = index + 1;
+                continue;
+            }
+
+            for (std::uint32_t i = node.offset; i < node.offset + node.count; ++i) {
+                const std::size_t triangle = triangles_[i];
+                const bardrix::point3 a = vertex(indices_[triangle * 3]);
+                const bardrix::point3 b = vertex(indices_[triangle * 3 + 1]);
+                const bardrix::point3 c = vertex(indices_[triangle * 3 + 2]);
+
+                const bardrix::vector3 normal = a.vector_to(b).cross(a.vector_to(c)).normalized();
+                if (bardrix::nearly_equal(normal.length(), 0)) continue; // Degenerate triangle
+
+                const double distance = std::abs(normal.dot(a.vector_to(point)));
+                if (distance > closest_distance) continue;
+
+                // The point is inside when it's on the inner side of every edge, within epsilon
+                const bardrix::point3 projected = point - normal * normal.dot(a.vector_to(point));
+                const bardrix::point3* corners[3] = { &a, &b, &c };
+                bool on_triangle = true;
+                for (int edge = 0; edge < 3 && on_triangle; ++edge) {
+                    const bardrix::point3& from = *corners[edge];
+                    const bardrix::point3& to = *corners[(edge + 1) % 3];
+                    const bardrix::vector3 edge_vector = from.vector_to(to);
+                    const double edge_length = edge_vector.length();
+
+                    on_triangle = edge_vector.cross(from.vector_to(projected)).dot(normal) >=
+                                  -bardrix::epsilon * edge_length;
+                }
+
+                if (!on_triangle) continue;
+
+                closest_distance = distance;
+                closest_normal = normal;
+            }
+        }
+
+        return closest_normal;
+    }
+
+    // TRIANGLE MESH
+
+    template<typename T>
+    basic_triangle_mesh<T>::basic_triangle_mesh(std::shared_ptr<const mesh_buffers<T>> buffers,
+                                                const bardrix::point3& position, const bardrix::material& material)
+            : buffers_(std::move(buffers)), position_(position), material_(material) {
+        if (buffers_ == nullptr)
+            throw std::invalid_argument("The buffers of a triangle mesh can't be nullptr");
+    }
+
+    template<typename T>
+    basic_triangle_mesh<T>::basic_triangle_mesh(std::vector<T> vertices, std::vector<std::uint32_t> indices)
+            : basic_triangle_mesh(std::make_shared<const mesh_buffers<T>>(std::move(vertices), std::move(indices))) {}
+
+    template<typename T>
+    const std::shared_ptr<const mesh_buffers<T>>& basic_triangle_mesh<T>::buffers() const noexcept { return buffers_; }
+
+    template<typename T>
+    const bardrix::material& basic_triangle_mesh<T>::get_material() const { return material_; }
+
+    template<typename T>
+    const bardrix::point3& basic_triangle_mesh<T>::get_position() const { return position_; }
+
+    template<typename T>
+    void basic_triangle_mesh<T>::set_material(const bardrix::material& material) { material_ = material; }
+
+    template<typename T>
+    void basic_triangle_mesh<T>::set_position(const bardrix::point3& position) { position_ = position; }
+
+    template<typename T>
+    bardrix::vector3 basic_triangle_mesh<T>::normal_at(const bardrix::point3& intersection) const {
+        return buffers_->normal_at(intersection - bardrix::point3(0, 0, 0).vector_to(position_));
+    }
+
+    template<typename T>
+    std::optional<bardrix::point3> basic_triangle_mesh<T>::intersection(const bardrix::ray& ray) const {
+        const std::optional<bardrix::hit> hit = intersect(ray);
+        if (!hit.has_value()) return std::nullopt;
+
+        return hit->position;
+    }
+
+    template<typename T>
+    std::optional<bardrix::hit> basic_triangle_mesh<T>::intersect(const bardrix::ray& ray) const {
+        // The ray is moved into the space of the vertices, instead of moving every vertex
+        bardrix::ray local = ray;
+        local.position -= bardrix::point3(0, 0, 0).vector_to(position_);
+
+        std::optional<bardrix::hit> hit = buffers_->closest_hit(local);
+        if (!hit.has_value()) return std::nullopt;
+
+        hit->position = ray.position + ray.get_direction() * hit->t;
+        return hit;
+    }
+
+    template<typename T>
+    double basic_triangle_mesh<T>::intersect_distance(const bardrix::ray& ray) const {
+        bardrix::ray local = ray;
+        local.position -= bardrix::point3(0, 0, 0).vector_to(position_);
+
+        const std::optional<bardrix::hit> hit = buffers_->closest_hit(local);
+        return hit ? hit->t : std::numeric_limits<double>::infinity();
+    }
+
+    template<typename T>
+    bardrix::bounding_box basic_triangle_mesh<T>::bounding_box() const {
+        const bardrix::bounding_box box = buffers_->bounding_box();
+        const bardrix::vector3 offset = bardrix::point3(0, 0, 0).vector_to(position_);
+
+        return { box.get_min() + offset, box.get_max() + offset };
+    }
+
+    template class mesh_buffers<double>;
+    template class mesh_buffers<float>;
+    template class basic_triangle_mesh<double>;
+    template class basic_triangle_mesh<float>;
+
+} // namespace bardrix
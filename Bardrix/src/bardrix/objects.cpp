@@ -3,6 +3,7 @@
 //
 
 #include <bardrix/objects.h>
+#include <bardrix/expression.h>
 
 namespace bardrix {
 
@@ -105,6 +106,32 @@ namespace bardrix {
                greater_than_or_nearly_equal(ray.get_length(), tmin);
     }
 
+    bool bounding_box::intersects(const bardrix::traversal_ray& ray) const noexcept {
+        const bardrix::point3* bounds[2] = { &min_, &max_ };
+        const bardrix::point3& origin = ray.get_origin();
+        const bardrix::vector3& inverse_direction = ray.get_inverse_direction();
+
+        // The near plane of an axis is the max bound if the direction is negative
+        const double tx_min = (bounds[ray.get_sign(0)]->x - origin.x) * inverse_direction.x;
+        const double tx_max = (bounds[1 - ray.get_sign(0)]->x - origin.x) * inverse_direction.x;
+        const double ty_min = (bounds[ray.get_sign(1)]->y - origin.y) * inverse_direction.y;
+        const double ty_max = (bounds[1 - ray.get_sign(1)]->y - origin.y) * inverse_direction.y;
+        const double tz_min = (bounds[ray.get_sign(2)]->z - origin.z) * inverse_direction.z;
+        const double tz_max = (bounds[1 - ray.get_sign(2)]->z - origin.z) * inverse_direction.z;
+
+        // NaN (0 * infinity, the ray lies in the plane) fails the comparisons and leaves the interval as is
+        double t_min = ray.t_min;
+        double t_max = ray.t_max;
+        t_min = tx_min > t_min ? tx_min : t_min;
+        t_max = tx_max < t_max ? tx_max : t_max;
+        t_min = ty_min > t_min ? ty_min : t_min;
+        t_max = ty_max < t_max ? ty_max : t_max;
+        t_min = tz_min > t_min ? tz_min : t_min;
+        t_max = tz_max < t_max ? tz_max : t_max;
+
+        return t_min <= t_max;
+    }
+
     bounding_box bounding_box::merged(const bounding_box& box) const noexcept {
         bounding_box temp = *this;
         temp.merge(box);
@@ -264,6 +291,33 @@ namespace bardrix {
         return os;
     }
 
+    // SHAPE
+
+    std::optional<bardrix::hit> shape::intersect(const bardrix::ray& ray) const {
+        const std::optional<bardrix::point3> point = intersection(ray);
+        if (!point) return std::nullopt;
+
+        return bardrix::hit{ ray.position.distance(*point), *point, normal_at(*point), 0 };
+    }
+
+    double shape::intersect_distance(const bardrix::ray& ray) const {
+        const std::optional<bardrix::point3> point = intersection(ray);
+        return point ? ray.position.distance(*point) : std::numeric_limits<double>::infinity();
+    }
+
+    std::optional<bardrix::bounding_box> shape::clipped_bounding_box(const bardrix::bounding_box& bounds) const {
+        const bardrix::bounding_box box = bounding_box();
+        const bardrix::point3 min(std::max(box.get_min().x, bounds.get_min().x),
+                                  std::max(box.get_min().y, bounds.get_min().y),
+                                  std::max(box.get_min().z, bounds.get_min().z));
+        const bardrix::point3 max(std::min(box.get_max().x, bounds.get_max().x),
+                                  std::min(box.get_max().y, bounds.get_max().y),
+                                  std::min(box.get_max().z, bounds.get_max().z));
+
+        if (min.x > max.x || min.y > max.y || min.z > max.z) return std::nullopt;
+        return bardrix::bounding_box(min, max);
+    }
+
     // SPHERE
 
     sphere::sphere() : sphere(bardrix::point3(0, 0, 0), 1.0) {}
@@ -295,43 +349,63 @@ namespace bardrix {
     }
 
     std::optional<bardrix::point3> sphere::intersection(const bardrix::ray& ray) const {
-        // Get direction of the ray
-        bardrix::vector3 direction = ray.get_direction();
-
-        // Gets vector from points: ray origin and sphere center
-        bardrix::vector3 ray_to_sphere_vector = ray.position.vector_to(position_);
-
-        // Get dot product of origin-center-vector and normalized direction
-        const double dot = ray_to_sphere_vector.dot(direction);
+        const double distance = intersect_distance(position_, radius_, ray);
+        if (distance == std::numeric_limits<double>::infinity())
+            return std::nullopt;
 
-        // Turn unit vector direction into a vector direction
-        direction *= dot;
-
-        // Length from ray origin to sphere center
-        ray_to_sphere_vector = direction - ray_to_sphere_vector;
+        return ray.point_at(distance);
+    }
 
-        // vec.dot(vec) == |vec|^2
-        const double distance_squared = ray_to_sphere_vector.dot(ray_to_sphere_vector);
+    std::optional<bardrix::hit> sphere::intersect(const bardrix::ray& ray) const {
+        const double distance = intersect_distance(position_, radius_, ray);
+        if (distance == std::numeric_limits<double>::infinity())
+            return std::nullopt;
 
-        // Radius^2
-        const double radius_squared = radius_ * radius_;
+        const bardrix::point3 position = ray.point_at(distance);
 
-        if (distance_squared > radius_squared)
-            return std::nullopt; // A smart way to check if ray intersects before taking the sqrt
+        // The hit is on the sphere, so the vector from the center has the length of the radius
+        const bardrix::vector3 normal = bardrix::nearly_equal(radius_, 0) ? position_.vector_to(position).normalized()
+                                                                 : position_.vector_to(position) * (1 / radius_);
 
-        // Calculate distance to intersection
-        const double distance = dot - std::sqrt(radius_squared - distance_squared);
+        return bardrix::hit{ distance, position, normal, 0 };
+    }
 
-        // If we intersect sphere return the length
-        return (distance < ray.get_length() && distance > 0)
-               ? std::optional(ray.position + ray.get_direction() * distance)
-               : std::nullopt;
+    double sphere::intersect_distance(const bardrix::ray& ray) const {
+        return intersect_distance(position_, radius_, ray);
     }
 
     bardrix::bounding_box sphere::bounding_box() const {
         return { position_ - radius_, position_ + radius_ };
     }
 
+    std::optional<bardrix::bounding_box> sphere::clipped_bounding_box(const bardrix::bounding_box& bounds) const {
+        const double center[3] = { position_.x, position_.y, position_.z };
+        const double low[3] = { bounds.get_min().x, bounds.get_min().y, bounds.get_min().z };
+        const double high[3] = { bounds.get_max().x, bounds.get_max().y, bounds.get_max().z };
+
+        // The squared distance from the center to the bounds on every axis, 0 if the center is within the bounds
+        double distance[3];
+        for (int a = 0; a < 3; ++a) {
+            const double offset = std::max({ low[a] - center[a], center[a] - high[a], 0.0 });
+            distance[a] = offset * offset;
+        }
+
+        double min[3];
+        double max[3];
+        for (int a = 0; a < 3; ++a) {
+            // Points inside the bounds are at least this far from the center on the other two axes
+            const double squared_extent = radius_ * radius_ - distance[(a + 1) % 3] - distance[(a + 2) % 3];
+            if (squared_extent < 0) return std::nullopt;
+
+            const double extent = std::sqrt(squared_extent);
+            min[a] = std::max(center[a] - extent, low[a]);
+            max[a] = std::min(center[a] + extent, high[a]);
+            if (min[a] > max[a]) return std::nullopt;
+        }
+
+        return bardrix::bounding_box(bardrix::point3(min[0], min[1], min[2]), bardrix::point3(max[0], max[1], max[2]));
+    }
+
     bool sphere::operator==(const sphere& sphere) const noexcept {
         return position_ == sphere.position_ && material_ == sphere.material_ &&
                bardrix::nearly_equal(radius_, sphere.radius_);
@@ -46,7 +46,8 @@ namespace bardrix {
     }
 
     double quaternion::length() const noexcept {
-        return std::sqrt(x * x + y * y + z * z + w * w);
+        const lanes4 values = lanes();
+        return std::sqrt((values * values).sum4());
     }
 
     quaternion& quaternion::normalize() noexcept {
@@ -68,12 +69,31 @@ namespace bardrix {
     }
 
     quaternion quaternion::operator*(const quaternion& q) const noexcept {
-        return {
-            w * q.x + x * q.w + y * q.z - z * q.y, // i
-            w * q.y - x * q.z + y * q.w + z * q.x, // j
-            w * q.z + x * q.y - y * q.x + z * q.w, // k
-            w * q.w - x * q.x - y * q.y - z * q.z  // real
-        };
+        // Every lane is one component, the terms are added in the same order as:
+        // i    = w * q.x + x * q.w + y * q.z - z * q.y
+        // j    = w * q.y - x * q.z + y * q.w + z * q.x
+        // k    = w * q.z + x * q.y - y * q.x + z * q.w
+        // real = w * q.w - x * q.x - y * q.y - z * q.z
+        // Subtracting a product is the same as adding the product with a negated factor
+        const lanes4 terms = lanes4::broadcast(w) * q.lanes() +
+                             lanes4::broadcast(x) * lanes4::set(q.w, -q.z, q.y, -q.x) +
+                             lanes4::broadcast(y) * lanes4::set(q.z, q.w, -q.x, -q.y) +
+                             lanes4::broadcast(z) * lanes4::set(-q.y, q.x, q.w, -q.z);
+
+        quaternion result;
+        result.set_lanes(terms);
+        return result;
+    }
+
+    quaternion quaternion::rotation_radians(const vector3& rotation_vector, double theta) noexcept {
+        if (rotation_vector == 0) return identity();
+
+        const vector3 unit_vector = rotation_vector.normalized() * std::sin(theta / 2);
+        return {unit_vector.x, unit_vector.y, unit_vector.z, std::cos(theta / 2)};
+    }
+
+    quaternion quaternion::rotation_degrees(const vector3& rotation_vector, double theta) noexcept {
+        return rotation_radians(rotation_vector, degrees_to_radians(theta));
     }
 
     std::ostream& quaternion::print(std::ostream& os) const {
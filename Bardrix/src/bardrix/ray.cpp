@@ -3,6 +3,7 @@
 //
 
 #include <bardrix/ray.h>
+#include <bardrix/expression.h>
 
 namespace bardrix {
 
@@ -29,7 +30,7 @@ namespace bardrix {
     point3 ray::point_at(const double distance) const noexcept {
         return (distance < 0)
                ? position
-               : position + direction_ * distance;
+               : lazy(position) + direction_ * distance;
     }
 
     std::ostream& ray::print(std::ostream& os) const {
@@ -44,4 +45,19 @@ namespace bardrix {
 
     bool ray::operator!=(const ray& ray) const noexcept { return !(*this == ray); }
 
+    traversal_ray::traversal_ray(const ray& ray) noexcept: traversal_ray(ray, 0, ray.get_length()) {}
+
+    traversal_ray::traversal_ray(const ray& ray, double t_min, double t_max) noexcept
+            : t_min(t_min),
+              t_max(t_max),
+              origin_(ray.position),
+              inverse_direction_(1 / ray.get_direction().x, 1 / ray.get_direction().y, 1 / ray.get_direction().z),
+              sign_{ inverse_direction_.x < 0, inverse_direction_.y < 0, inverse_direction_.z < 0 } {}
+
+    const point3& traversal_ray::get_origin() const noexcept { return origin_; }
+
+    const vector3& traversal_ray::get_inverse_direction() const noexcept { return inverse_direction_; }
+
+    std::uint8_t traversal_ray::get_sign(std::size_t index) const noexcept { return sign_[index]; }
+
 } // namespace bardrix
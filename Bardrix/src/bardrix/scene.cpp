@@ -0,0 +1,135 @@
+//
+// Created by Bardio on 16/10/2026.
+//
+
+#include <bardrix/scene.h>
+
+namespace bardrix {
+
+    // scene_sphere
+
+    bardrix::point3 scene_sphere::position() const noexcept { return { center[0], center[1], center[2] }; }
+
+    bardrix::bounding_box scene_sphere::bounding_box() const noexcept {
+        const bardrix::point3 position = this->position();
+        return { position - radius, position + radius };
+    }
+
+    double scene_sphere::intersect(const bardrix::ray& ray) const noexcept {
+        return bardrix::sphere::intersect_distance(position(), radius, ray);
+    }
+
+    bardrix::vector3 scene_sphere::normal_at(const bardrix::point3& point) const {
+        return position().vector_to(point).normalized();
+    }
+
+    // scene
+
+    scene::scene() = default;
+
+    std::uint32_t scene::add_material(const bardrix::material& material) {
+        materials_.push_back(material);
+        return static_cast<std::uint32_t>(materials_.size() - 1);
+    }
+
+    std::uint32_t scene::add_sphere(const bardrix::point3& position, double radius, std::uint32_t material) {
+        if (material >= materials_.size())
+            throw std::invalid_argument("Material is not in the scene");
+
+        spheres_.push_back({ { position.x, position.y, position.z }, std::max(radius, 0.0), material });
+        return static_cast<std::uint32_t>(spheres_.size() - 1);
+    }
+
+    void scene::construct(std::size_t leaf_size, std::size_t bins, std::size_t threads) {
+        sphere_nodes_.clear();
+        sphere_leaves_.clear();
+        sphere_indices_.clear();
+        if (spheres_.empty()) return;
+
+        std::vector<bvh_tree::build_primitive> primitives;
+        primitives.reserve(spheres_.size());
+        for (std::size_t i = 0; i < spheres_.size(); ++i) {
+            bardrix::bounding_box box = spheres_[i].bounding_box();
+            bardrix::point3 center = box.center();
+            primitives.push_back({ std::move(box), std::move(center), static_cast<std::uint32_t>(i) });
+        }
+
+        bvh_tree::build_output output = bvh_tree::build_sah(primitives, bins, bvh_tree::thread_count(threads));
+        bvh_tree::merge_leaves(output, std::max<std::size_t>(leaf_size, 1));
+
+        sphere_nodes_ = std::move(output.nodes);
+        sphere_indices_ = std::move(output.indices);
+
+        sphere_leaves_.reserve(sphere_indices_.size());
+        for (const std::uint32_t index: sphere_indices_)
+            sphere_leaves_.push_back(spheres_[index]);
+    }
+
+    std::optional<bardrix::scene_hit> scene::closest_hit(const bardrix::ray& ray) const {
+        std::optional<bardrix::scene_hit> closest;
+
+        // A hit of one type shortens the ray for the next types
+        bardrix::ray query = ray;
+
+        if (!sphere_nodes_.empty()) {
+            // scene_sphere::intersect is not virtual, so it's inlined into the traversal
+            const auto intersect = [this](std::uint32_t primitive, const bardrix::ray& sphere_query) {
+                return sphere_leaves_[primitive].intersect(sphere_query);
+            };
+
+            std::uint32_t primitive;
+            double distance;
+            if (bvh_tree::closest_primitive(sphere_nodes_.data(), intersect, query, primitive, distance)) {
+                closest = scene_hit{ shape_type::sphere, sphere_indices_[primitive], distance };
+                query.set_length(distance);
+            }
+        }
+
+        return closest;
+    }
+
+    bool scene::occluded(const bardrix::ray& ray) const {
+        if (!sphere_nodes_.empty()) {
+            const auto intersects = [this, &ray](std::uint32_t primitive) {
+                return sphere_leaves_[primitive].intersect(ray) != std::numeric_limits<double>::infinity();
+            };
+
+            if (bvh_tree::any_primitive(sphere_nodes_.data(), intersects, ray)) return true;
+        }
+
+        return false;
+    }
+
+    bardrix::vector3 scene::normal_at(const bardrix::scene_hit& hit, const bardrix::point3& point) const {
+        switch (hit.type) {
+            case shape_type::sphere:
+                return spheres_[hit.index].normal_at(point);
+        }
+
+        throw std::invalid_argument("Unknown shape type");
+    }
+
+    const bardrix::material& scene::material_of(const bardrix::scene_hit& hit) const {
+        switch (hit.type) {
+            case shape_type::sphere:
+                return materials_[spheres_[hit.index].material];
+        }
+
+        throw std::invalid_argument("Unknown shape type");
+    }
+
+    const std::vector<bardrix::material>& scene::materials() const noexcept { return materials_; }
+
+    const std::vector<bardrix::scene_sphere>& scene::spheres() const noexcept { return spheres_; }
+
+    bool scene::is_empty() const noexcept { return spheres_.empty(); }
+
+    void scene::clear() noexcept {
+        materials_.clear();
+        spheres_.clear();
+        sphere_nodes_.clear();
+        sphere_leaves_.clear();
+        sphere_indices_.clear();
+    }
+
+} // namespace bardrix
@@ -0,0 +1,180 @@
+//
+// Created by Bardio on 16/10/2026.
+//
+
+#include <bardrix/simd.h>
+
+namespace bardrix {
+
+    // sphere_soa
+
+    sphere_soa::sphere_soa() = default;
+
+    void sphere_soa::push_back(const bardrix::point3& center, double radius) {
+        x_.push_back(center.x);
+        y_.push_back(center.y);
+        z_.push_back(center.z);
+        radius_.push_back(std::max(radius, 0.0));
+    }
+
+    void sphere_soa::reserve(std::size_t size) {
+        x_.reserve(size);
+        y_.reserve(size);
+        z_.reserve(size);
+        radius_.reserve(size);
+    }
+
+    bardrix::point3 sphere_soa::center(std::size_t index) const noexcept { return { x_[index], y_[index], z_[index] }; }
+
+    double sphere_soa::radius(std::size_t index) const noexcept { return radius_[index]; }
+
+    std::size_t sphere_soa::size() const noexcept { return radius_.size(); }
+
+    void sphere_soa::clear() noexcept {
+        x_.clear();
+        y_.clear();
+        z_.clear();
+        radius_.clear();
+    }
+
+    std::optional<batch_hit> sphere_soa::closest_hit(const bardrix::ray& ray) const noexcept {
+        return closest_hit(ray, 0, size());
+    }
+
+    std::optional<batch_hit> sphere_soa::closest_hit(const bardrix::ray& ray, std::size_t first,
+                                                     std::size_t last) const noexcept {
+#if defined(BARDRIX_SIMD_AVX) || defined(BARDRIX_SIMD_SSE2)
+        const bardrix::point3& origin = ray.position;
+        const bardrix::vector3& direction = ray.get_direction();
+#endif
+        const double length = ray.get_length();
+
+        double best_distance = std::numeric_limits<double>::infinity();
+        std::size_t best_index = last;
+        std::size_t i = first;
+
+        // The same steps as sphere::intersect_distance, every lane keeps the closest hit of its spheres
+#if defined(BARDRIX_SIMD_AVX)
+        const __m256d origin_x = _mm256_set1_pd(origin.x);
+        const __m256d origin_y = _mm256_set1_pd(origin.y);
+        const __m256d origin_z = _mm256_set1_pd(origin.z);
+        const __m256d direction_x = _mm256_set1_pd(direction.x);
+        const __m256d direction_y = _mm256_set1_pd(direction.y);
+        const __m256d direction_z = _mm256_set1_pd(direction.z);
+        const __m256d zero = _mm256_setzero_pd();
+        const __m256d four = _mm256_set1_pd(4);
+        __m256d lane_distance = _mm256_set1_pd(length);
+        __m256d lane_index = _mm256_set1_pd(-1);
+        __m256d index = _mm256_set_pd(static_cast<double>(i + 3), static_cast<double>(i + 2),
+                                      static_cast<double>(i + 1), static_cast<double>(i));
+
+        for (; i + 4 <= last; i += 4) {
+            const __m256d to_x = _mm256_sub_pd(_mm256_loadu_pd(x_.data() + i), origin_x);
+            const __m256d to_y = _mm256_sub_pd(_mm256_loadu_pd(y_.data() + i), origin_y);
+            const __m256d to_z = _mm256_sub_pd(_mm256_loadu_pd(z_.data() + i), origin_z);
+            const __m256d dot = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(to_x, direction_x),
+                                                            _mm256_mul_pd(to_y, direction_y)),
+                                              _mm256_mul_pd(to_z, direction_z));
+
+            const __m256d closest_x = _mm256_sub_pd(_mm256_mul_pd(direction_x, dot), to_x);
+            const __m256d closest_y = _mm256_sub_pd(_mm256_mul_pd(direction_y, dot), to_y);
+            const __m256d closest_z = _mm256_sub_pd(_mm256_mul_pd(direction_z, dot), to_z);
+            const __m256d distance_squared = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(closest_x, closest_x),
+                                                                         _mm256_mul_pd(closest_y, closest_y)),
+                                                           _mm256_mul_pd(closest_z, closest_z));
+
+            const __m256d radius = _mm256_loadu_pd(radius_.data() + i);
+            const __m256d radius_squared = _mm256_mul_pd(radius, radius);
+
+            // A miss takes the square root of a negative number, the NaN fails every comparison below
+            const __m256d distance = _mm256_sub_pd(dot, _mm256_sqrt_pd(_mm256_sub_pd(radius_squared, distance_squared)));
+            const __m256d hit = _mm256_and_pd(_mm256_cmp_pd(distance, zero, _CMP_GT_OQ),
+                                              _mm256_cmp_pd(distance, lane_distance, _CMP_LT_OQ));
+
+            lane_distance = _mm256_blendv_pd(lane_distance, distance, hit);
+            lane_index = _mm256_blendv_pd(lane_index, index, hit);
+            index = _mm256_add_pd(index, four);
+        }
+
+        alignas(32) double distances[4];
+        alignas(32) double indices[4];
+        _mm256_store_pd(distances, lane_distance);
+        _mm256_store_pd(indices, lane_index);
+        constexpr std::size_t lanes = 4;
+#elif defined(BARDRIX_SIMD_SSE2)
+        const __m128d origin_x = _mm_set1_pd(origin.x);
+        const __m128d origin_y = _mm_set1_pd(origin.y);
+        const __m128d origin_z = _mm_set1_pd(origin.z);
+        const __m128d direction_x = _mm_set1_pd(direction.x);
+        const __m128d direction_y = _mm_set1_pd(direction.y);
+        const __m128d direction_z = _mm_set1_pd(direction.z);
+        const __m128d zero = _mm_setzero_pd();
+        const __m128d two = _mm_set1_pd(2);
+        __m128d lane_distance = _mm_set1_pd(length);
+        __m128d lane_index = _mm_set1_pd(-1);
+        __m128d index = _mm_set_pd(static_cast<double>(i + 1), static_cast<double>(i));
+
+        for (; i + 2 <= last; i += 2) {
+            const __m128d to_x = _mm_sub_pd(_mm_loadu_pd(x_.data() + i), origin_x);
+            const __m128d to_y = _mm_sub_pd(_mm_loadu_pd(y_.data() + i), origin_y);
+            const __m128d to_z = _mm_sub_pd(_mm_loadu_pd(z_.data() + i), origin_z);
+            const __m128d dot = _mm_add_pd(_mm_add_pd(_mm_mul_pd(to_x, direction_x), _mm_mul_pd(to_y, direction_y)),
+                                           _mm_mul_pd(to_z, direction_z));
+
+            const __m128d closest_x = _mm_sub_pd(_mm_mul_pd(direction_x, dot), to_x);
+            const __m128d closest_y = _mm_sub_pd(_mm_mul_pd(direction_y, dot), to_y);
+            const __m128d closest_z = _mm_sub_pd(_mm_mul_pd(direction_z, dot), to_z);
+            const __m128d distance_squared = _mm_add_pd(_mm_add_pd(_mm_mul_pd(closest_x, closest_x),
+                                                                   _mm_mul_pd(closest_y, closest_y)),
+                                                        _mm_mul_pd(closest_z, closest_z));
+
+            const __m128d radius = _mm_loadu_pd(radius_.data() + i);
+            const __m128d radius_squared = _mm_mul_pd(radius, radius);
+
+            // A miss takes the square root of a negative number, the NaN fails every comparison below
+            const __m128d distance = _mm_sub_pd(dot, _mm_sqrt_pd(_mm_sub_pd(radius_squared, distance_squared)));
+            const __m128d hit = _mm_and_pd(_mm_cmpgt_pd(distance, zero), _mm_cmplt_pd(distance, lane_distance));
+
+            // SSE2 has no blend, select with and/andnot instead
+            lane_distance = _mm_or_pd(_mm_and_pd(hit, distance), _mm_andnot_pd(hit, lane_distance));
+            lane_index = _mm_or_pd(_mm_and_pd(hit, index), _mm_andnot_pd(hit, lane_index));
+            index = _mm_add_pd(index, two);
+        }
+
+        alignas(16) double distances[2];
+        alignas(16) double indices[2];
+        _mm_store_pd(distances, lane_distance);
+        _mm_store_pd(indices, lane_index);
+        constexpr std::size_t lanes = 2;
+#else
+        double distances[1] = { length };
+        double indices[1] = { -1 };
+        constexpr std::size_t lanes = 0;
+#endif
+
+        // The closest hit of the lanes, the lowest index wins a tie
+        for (std::size_t lane = 0; lane < lanes; ++lane) {
+            if (indices[lane] < 0) continue;
+
+            const auto lane_sphere = static_cast<std::size_t>(indices[lane]);
+            if (distances[lane] < best_distance || (distances[lane] == best_distance && lane_sphere < best_index)) {
+                best_distance = distances[lane];
+                best_index = lane_sphere;
+            }
+        }
+
+        // The spheres that don't fill a SIMD register, or all spheres without SIMD
+        for (; i < last; ++i) {
+            const double distance = bardrix::sphere::intersect_distance(center(i), radius_[i], ray);
+            if (distance < best_distance) {
+                best_distance = distance;
+                best_index = i;
+            }
+        }
+
+        if (best_index == last) return std::nullopt;
+
+        return batch_hit{ static_cast<std::uint32_t>(best_index), best_distance };
+    }
+
+} // namespace bardrix
@@ -0,0 +1,279 @@
+//
+// Created by Bardio on 16/10/2026.
+//
+
+#include <bardrix/soa.h>
+#include <bardrix/lanes.h>
+
+namespace bardrix {
+
+    namespace {
+
+        // The kernels are written once for double and lanes4, so every element is computed in the same order
+
+        template<typename L>
+        L load(const double* values) noexcept {
+            if constexpr (std::is_same_v<L, lanes4>) return lanes4::load4(values);
+            else return *values;
+        }
+
+        void store(double* values, double value) noexcept { *values = value; }
+
+        void store(double* values, const lanes4& value) noexcept { value.store4(values); }
+
+        template<typename L>
+        L broadcast(double value) noexcept {
+            if constexpr (std::is_same_v<L, lanes4>) return lanes4::broadcast(value);
+            else return value;
+        }
+
+        double square_root(double value) noexcept { return std::sqrt(value); }
+
+        lanes4 square_root(const lanes4& value) noexcept { return lanes4::sqrt(value); }
+
+        double select_less_equal(double a, double b, double if_true, double if_false) noexcept {
+            return a <= b ? if_true : if_false;
+        }
+
+        lanes4 select_less_equal(const lanes4& a, const lanes4& b, const lanes4& if_true,
+                                 const lanes4& if_false) noexcept {
+            return lanes4::select_less_equal(a, b, if_true, if_false);
+        }
+
+        /// \brief Calls kernel(L(), index) with lanes4 for every 4 elements, then with double for the last elements.
+        template<typename Kernel>
+        void for_each_element(std::size_t size, Kernel kernel) {
+            std::size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+                kernel(lanes4(), i);
+
+            for (; i < size; ++i)
+                kernel(0.0, i);
+        }
+
+        void check_size(std::size_t lhs, std::size_t rhs) {
+            if (lhs != rhs)
+                throw std::invalid_argument("The number of elements must be the same");
+        }
+
+    } // namespace
+
+    // basic_dimension3_soa
+
+    template<typename T>
+    basic_dimension3_soa<T>::basic_dimension3_soa() = default;
+
+    template<typename T>
+    basic_dimension3_soa<T>::basic_dimension3_soa(const std::vector<T>& values) {
+        reserve(values.size());
+        for (const T& value : values)
+            push_back(value);
+    }
+
+    template<typename T>
+    void basic_dimension3_soa<T>::push_back(const T& value) {
+        x_.push_back(value.x);
+        y_.push_back(value.y);
+        z_.push_back(value.z);
+    }
+
+    template<typename T>
+    void basic_dimension3_soa<T>::reserve(std::size_t size) {
+        x_.reserve(size);
+        y_.reserve(size);
+        z_.reserve(size);
+    }
+
+    template<typename T>
+    void basic_dimension3_soa<T>::resize(std::size_t size) {
+        x_.resize(size);
+        y_.resize(size);
+        z_.resize(size);
+    }
+
+    template<typename T>
+    T basic_dimension3_soa<T>::get(std::size_t index) const noexcept { return { x_[index], y_[index], z_[index] }; }
+
+    template<typename T>
+    void basic_dimension3_soa<T>::set(std::size_t index, const T& value) noexcept {
+        x_[index] = value.x;
+        y_[index] = value.y;
+        z_[index] = value.z;
+    }
+
+    template<typename T>
+    std::size_t basic_dimension3_soa<T>::size() const noexcept { return x_.size(); }
+
+    template<typename T>
+    void basic_dimension3_soa<T>::clear() noexcept {
+        x_.clear();
+        y_.clear();
+        z_.clear();
+    }
+
+    template<typename T>
+    double* basic_dimension3_soa<T>::data(axis axis) {
+        return const_cast<double*>(static_cast<const basic_dimension3_soa&>(*this).data(axis));
+    }
+
+    template<typename T>
+    const double* basic_dimension3_soa<T>::data(axis axis) const {
+        switch (axis) {
+            case axis::x:
+                return x_.data();
+            case axis::y:
+                return y_.data();
+            case axis::z:
+                return z_.data();
+            default:
+                throw std::invalid_argument("Invalid axis");
+        }
+    }
+
+    template<typename T>
+    void basic_dimension3_soa<T>::rotate(const quaternion& rotation) noexcept {
+        for_each_element(size(), [&](auto type, std::size_t i) {
+            using L = decltype(type);
+            const L qx = broadcast<L>(rotation.x), qy = broadcast<L>(rotation.y);
+            const L qz = broadcast<L>(rotation.z), qw = broadcast<L>(rotation.w);
+            const L zero = broadcast<L>(0);
+            const L px = load<L>(x_.data() + i), py = load<L>(y_.data() + i), pz = load<L>(z_.data() + i);
+
+            // The same Hamilton products as quaternion::rotate, (conjugated() * p) * rotation with p = (x, y, z, 0)
+            const L ax = broadcast<L>(-rotation.x), ay = broadcast<L>(-rotation.y), az = broadcast<L>(-rotation.z);
+            const L tx = qw * px + ax * zero + ay * pz - az * py;
+            const L ty = qw * py - ax * pz + ay * zero + az * px;
+            const L tz = qw * pz + ax * py - ay * px + az * zero;
+            const L tw = qw * zero - ax * px - ay * py - az * pz;
+
+            store(x_.data() + i, tw * qx + tx * qw + ty * qz - tz * qy);
+            store(y_.data() + i, tw * qy - tx * qz + ty * qw + tz * qx);
+            store(z_.data() + i, tw * qz + tx * qy - ty * qx + tz * qw);
+        });
+    }
+
+    template class basic_dimension3_soa<vector3>;
+    template class basic_dimension3_soa<point3>;
+
+    // vector3_soa
+
+    void vector3_soa::normalize() noexcept {
+        const double tolerance = bardrix::epsilon;
+
+        for_each_element(size(), [&](auto type, std::size_t i) {
+            using L = decltype(type);
+            const L x = load<L>(x_.data() + i), y = load<L>(y_.data() + i), z = load<L>(z_.data() + i);
+            const L length = square_root(x * x + y * y + z * z);
+
+            // nearly_equal(length, 0) keeps the vector, the length is never negative
+            const L limit = broadcast<L>(tolerance);
+            store(x_.data() + i, select_less_equal(length, limit, x, x / length));
+            store(y_.data() + i, select_less_equal(length, limit, y, y / length));
+            store(z_.data() + i, select_less_equal(length, limit, z, z / length));
+        });
+    }
+
+    void vector3_soa::length(std::vector<double>& out_lengths) const {
+        out_lengths.resize(size());
+
+        for_each_element(size(), [&](auto type, std::size_t i) {
+            using L = decltype(type);
+            const L x = load<L>(x_.data() + i), y = load<L>(y_.data() + i), z = load<L>(z_.data() + i);
+            store(out_lengths.data() + i, square_root(x * x + y * y + z * z));
+        });
+    }
+
+    void vector3_soa::dot(const vector3_soa& vectors, std::vector<double>& out_dots) const {
+        check_size(size(), vectors.size());
+        out_dots.resize(size());
+
+        for_each_element(size(), [&](auto type, std::size_t i) {
+            using L = decltype(type);
+            store(out_dots.data() + i, load<L>(x_.data() + i) * load<L>(vectors.x_.data() + i) +
+                                       load<L>(y_.data() + i) * load<L>(vectors.y_.data() + i) +
+                                       load<L>(z_.data() + i) * load<L>(vectors.z_.data() + i));
+        });
+    }
+
+    void vector3_soa::cross(const vector3_soa& vectors, vector3_soa& out_crosses) const {
+        check_size(size(), vectors.size());
+        out_crosses.resize(size());
+
+        for_each_element(size(), [&](auto type, std::size_t i) {
+            using L = decltype(type);
+            const L x = load<L>(x_.data() + i), y = load<L>(y_.data() + i), z = load<L>(z_.data() + i);
+            const L vx = load<L>(vectors.x_.data() + i), vy = load<L>(vectors.y_.data() + i);
+            const L vz = load<L>(vectors.z_.data() + i);
+
+            // Everything is loaded before the stores, so out_crosses may be this or vectors
+            store(out_crosses.x_.data() + i, y * vz - z * vy);
+            store(out_crosses.y_.data() + i, z * vx - x * vz);
+            store(out_crosses.z_.data() + i, x * vy - y * vx);
+        });
+    }
+
+    void vector3_soa::add(const vector3_soa& vectors) {
+        check_size(size(), vectors.size());
+
+        for_each_element(size(), [&](auto type, std::size_t i) {
+            using L = decltype(type);
+            store(x_.data() + i, load<L>(x_.data() + i) + load<L>(vectors.x_.data() + i));
+            store(y_.data() + i, load<L>(y_.data() + i) + load<L>(vectors.y_.data() + i));
+            store(z_.data() + i, load<L>(z_.data() + i) + load<L>(vectors.z_.data() + i));
+        });
+    }
+
+    void vector3_soa::scale(double n) noexcept {
+        for_each_element(size(), [&](auto type, std::size_t i) {
+            using L = decltype(type);
+            const L scalar = broadcast<L>(n);
+            store(x_.data() + i, load<L>(x_.data() + i) * scalar);
+            store(y_.data() + i, load<L>(y_.data() + i) * scalar);
+            store(z_.data() + i, load<L>(z_.data() + i) * scalar);
+        });
+    }
+
+    // point3_soa
+
+    void point3_soa::add(const vector3_soa& vectors, double scale) {
+        check_size(size(), vectors.size());
+
+        const double* vx = vectors.data(axis::x);
+        const double* vy = vectors.data(axis::y);
+        const double* vz = vectors.data(axis::z);
+
+        for_each_element(size(), [&](auto type, std::size_t i) {
+            using L = decltype(type);
+            const L scalar = broadcast<L>(scale);
+            store(x_.data() + i, load<L>(x_.data() + i) + load<L>(vx + i) * scalar);
+            store(y_.data() + i, load<L>(y_.data() + i) + load<L>(vy + i) * scalar);
+            store(z_.data() + i, load<L>(z_.data() + i) + load<L>(vz + i) * scalar);
+        });
+    }
+
+    void point3_soa::distance(const point3& point, std::vector<double>& out_distances) const {
+        out_distances.resize(size());
+
+        for_each_element(size(), [&](auto type, std::size_t i) {
+            using L = decltype(type);
+            const L dx = broadcast<L>(point.x) - load<L>(x_.data() + i);
+            const L dy = broadcast<L>(point.y) - load<L>(y_.data() + i);
+            const L dz = broadcast<L>(point.z) - load<L>(z_.data() + i);
+            store(out_distances.data() + i, square_root(dx * dx + dy * dy + dz * dz));
+        });
+    }
+
+    void point3_soa::distance(const point3_soa& points, std::vector<double>& out_distances) const {
+        check_size(size(), points.size());
+        out_distances.resize(size());
+
+        for_each_element(size(), [&](auto type, std::size_t i) {
+            using L = decltype(type);
+            const L dx = load<L>(points.x_.data() + i) - load<L>(x_.data() + i);
+            const L dy = load<L>(points.y_.data() + i) - load<L>(y_.data() + i);
+            const L dz = load<L>(points.z_.data() + i) - load<L>(z_.data() + i);
+            store(out_distances.data() + i, square_root(dx * dx + dy * dy + dz * dz));
+        });
+    }
+
+} // namespace bardrix
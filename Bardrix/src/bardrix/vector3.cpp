@@ -6,52 +6,9 @@
 
 namespace bardrix {
 
-    vector3::vector3(const double x, const double y, const double z) {
-        this->x = x;
-        this->y = y;
-        this->z = z;
-    }
-
-    double vector3::length() const noexcept {
-        return std::sqrt(length_squared());
-    }
-
-    double vector3::length_squared() const noexcept {
-        return x * x + y * y + z * z;
-    }
-
-    vector3 vector3::normalized() const noexcept {
-        const double mag = length();
-
-        if (nearly_equal(mag, 0))
-            return *this;
-
-        return { x / mag, y / mag, z / mag };
-    }
-
-    vector3& vector3::normalize() noexcept {
-        const double mag = length();
-
-        if (nearly_equal(mag, 0))
-            return *this;
-
-        x /= mag;
-        y /= mag;
-        z /= mag;
-
-        return *this;
-    }
-
-    double vector3::dot(const vector3& vec3) const noexcept {
-        return x * vec3.x + y * vec3.y + z * vec3.z;
-    }
-
-    vector3 vector3::cross(const vector3& vec3) const noexcept {
-        return { y * vec3.z - z * vec3.y, z * vec3.x - x * vec3.z, x * vec3.y - y * vec3.x };
-    }
-
-    double vector3::angle(const vector3& vec3) const {
-        const double length_product = length() * vec3.length();
+    template<typename V>
+    V basic_vector3<V>::angle(const basic_vector3& vec3) const {
+        const V length_product = length() * vec3.length();
 
         if (nearly_equal(length_product, 0))
             return 1;
@@ -59,13 +16,14 @@ namespace bardrix {
         return dot(vec3) / length_product;
     }
 
-    std::optional<vector3> vector3::reflection(const vector3& normal) const {
+    template<typename V>
+    std::optional<basic_vector3<V>> basic_vector3<V>::reflection(const basic_vector3& normal) const {
         // Cannot reflect a vector with length 0 or a normal with length 0
         if (*this == 0 || normal == 0)
             return std::nullopt;
 
-        const vector3 normalized_normal = normal.normalized();
-        const double dot = this->dot(normalized_normal);
+        const basic_vector3 normalized_normal = normal.normalized();
+        const V dot = this->dot(normalized_normal);
 
         // Dot < 0 means the vector is behind the normal
         // We're unable to reflect a vector that is behind the normal
@@ -75,11 +33,14 @@ namespace bardrix {
         return normalized_normal * 2 * dot - *this;
     }
 
-    std::optional<vector3> vector3::refraction(const vector3& normal, double refractive_ratio) const {
+    template<typename V>
+    std::optional<basic_vector3<V>> basic_vector3<V>::refraction(const basic_vector3& normal, V refractive_ratio) const {
         return refraction(normal, refractive_ratio, 1);
     }
 
-    std::optional<vector3> vector3::refraction(const vector3& normal, const double medium1, const double medium2) const {
+    template<typename V>
+    std::optional<basic_vector3<V>> basic_vector3<V>::refraction(const basic_vector3& normal, const V medium1,
+                                                                 const V medium2) const {
         if (*this == 0 || normal == 0)
             return std::nullopt;
 
@@ -87,28 +48,32 @@ namespace bardrix {
         if (nearly_equal(medium2, 0))
             return std::nullopt;
 
-        const double ratio = medium1 / medium2;
+        const V ratio = medium1 / medium2;
 
         // If the ratio is less than or equal to 0, it means the light is going from a denser medium to a less dense medium
         if (less_than_or_nearly_equal(ratio, 0))
             return std::nullopt;
 
-        const vector3 normalized_normal = normal.normalized();
-        const vector3 normalized_vector = this->normalized();
+        const basic_vector3 normalized_normal = normal.normalized();
+        const basic_vector3 normalized_vector = this->normalized();
 
-        const double cos_theta1 = -normalized_normal.dot(normalized_vector);
-        const double sin_theta2_squared = ratio * ratio * (1.0 - cos_theta1 * cos_theta1);
+        const V cos_theta1 = -normalized_normal.dot(normalized_vector);
+        const V sin_theta2_squared = ratio * ratio * (V(1) - cos_theta1 * cos_theta1);
 
         // Internal reflection occurs when sin_theta2_squared > 1
-        if (sin_theta2_squared > 1.0)
+        if (sin_theta2_squared > 1)
             return std::nullopt;
 
         return (normalized_vector * ratio + normalized_normal *
-                                            (ratio * cos_theta1 - std::sqrt(1.0 - sin_theta2_squared)));
+                                            (ratio * cos_theta1 - std::sqrt(V(1) - sin_theta2_squared)));
     }
 
-    std::ostream& vector3::print(std::ostream& os) const {
-        return os << "(" << x << ", " << y << ", " << z << ")";
+    template<typename V>
+    std::ostream& basic_vector3<V>::print(std::ostream& os) const {
+        return os << "(" << this->x << ", " << this->y << ", " << this->z << ")";
     }
 
+    template class basic_vector3<float>;
+    template class basic_vector3<double>;
+
 } // namespace bardrix
@@ -4,6 +4,9 @@
 
 #include <bardrix/algorithm.h>
 #include <bardrix/point3.h>
+#include <bardrix/camera.h>
+#include <cstdio>
+#include <fstream>
 
 bool int_predicate(int a, int b) {
     return a < b;
@@ -1201,3 +1204,979 @@ TEST(bvh_tree, intersect_edge_cases) {
     EXPECT_EQ(hits.size(), 2);
     EXPECT_TRUE(includes_all_shapes(hits, std::vector<const bardrix::shape*>({ shapes[0].get(), shapes[1].get() })));
 }
+
+/// \brief Test the construction of a BVH tree using the surface area heuristic
+TEST(bvh_tree, construct_sah) {
+    bardrix::bvh_tree bvh;
+
+    std::vector<std::shared_ptr<bardrix::shape>> shapes{
+            std::make_shared<bardrix::sphere>(bardrix::point3(-7, 5, -2), 2),            // 0
+            std::make_shared<bardrix::sphere>(bardrix::point3(-7.39, -6.33, 7.38), 0.2), // 1
+            std::make_shared<bardrix::sphere>(bardrix::point3(-3.3, -8.96, -4), 0.8),    // 2
+            std::make_shared<bardrix::sphere>(bardrix::point3(8.66, -8.60, 0), 1),       // 3
+            std::make_shared<bardrix::sphere>(bardrix::point3(4.39, 6.26, 0), 1.2),      // 4
+            std::make_shared<bardrix::sphere>(bardrix::point3(8.48, 3.98, 2.15), 0.4),   // 5
+            std::make_shared<bardrix::sphere>(bardrix::point3(9.30, -6.54, 3), 1.2),     // 6
+            std::make_shared<bardrix::sphere>(bardrix::point3(-3.60, 7.66, 0), 0.5),     // 7
+            std::make_shared<bardrix::sphere>(bardrix::point3(-5.52, -8.01, 0), 1.6),    // 8
+            std::make_shared<bardrix::sphere>(bardrix::point3(-2.64, -12.15, 7.37), 4),  // 9
+            std::make_shared<bardrix::sphere>(bardrix::point3(1.30, 0.01, 0), 1)         // 10
+    };
+
+    bvh.construct_sah(shapes.begin(), shapes.end());
+    std::vector<const bardrix::shape*> hits;
+
+    bvh.intersections(bardrix::ray(bardrix::point3(26.03874, 31.6748, 2.25401), bardrix::point3(-14.64, -18.48, -1.6)),
+                      hits);
+    EXPECT_EQ(hits.size(), 3);
+    EXPECT_TRUE(includes_all_shapes(hits, std::vector<const bardrix::shape*>({ shapes[4].get(), shapes[8].get(), shapes[10].get() })));
+
+    hits.clear();
+    bvh.intersections(bardrix::ray(bardrix::point3(-1.69, -29.97, 13.43), bardrix::point3(-11.82, 11.13, 2.95)), hits);
+    EXPECT_EQ(hits.size(), 2);
+    EXPECT_TRUE(includes_all_shapes(hits, std::vector<const bardrix::shape*>({ shapes[1].get(), shapes[9].get() })));
+
+    // Every bin count should give the same hits
+    for (std::size_t bins: { 0, 1, 2, 3, 64 }) {
+        bvh.construct_sah(shapes.data(), shapes.size(), bins);
+
+        hits.clear();
+        bvh.intersections(bardrix::ray(bardrix::point3(-1.69, -29.97, 13.43), bardrix::point3(-7.26, 6.29, -2.91)), hits);
+        EXPECT_EQ(hits.size(), 2);
+        EXPECT_TRUE(includes_all_shapes(hits, std::vector<const bardrix::shape*>({ shapes[0].get(), shapes[9].get() })));
+    }
+
+    bvh.construct_sah(shapes.begin(), shapes.begin() - 1);
+    EXPECT_DOUBLE_EQ(bvh.sah_cost(), 0);
+    bvh.construct_sah(shapes.data(), 0);
+    EXPECT_DOUBLE_EQ(bvh.sah_cost(), 0);
+}
+
+/// \brief Test the construction of a BVH tree using the surface area heuristic with edge cases
+TEST(bvh_tree, construct_sah_edge_cases) {
+    bardrix::bvh_tree bvh;
+
+    // Shapes with the same center cannot be separated by their centroids
+    std::vector<std::shared_ptr<bardrix::sphere>> spheres{
+            std::make_shared<bardrix::sphere>(bardrix::point3{ 0, 0, 0 }, 1),
+            std::make_shared<bardrix::sphere>(bardrix::point3{ 0, 0, 0 }, 2),
+            std::make_shared<bardrix::sphere>(bardrix::point3{ 0, 0, 0 }, 3)
+    };
+
+    bvh.construct_sah(spheres.begin(), spheres.end());
+    std::vector<const bardrix::shape*> hits;
+    bvh.intersections(bardrix::ray{ bardrix::point3{ 2.5, 0, -10 }, bardrix::vector3{ 0, 0, 1 }, 20 }, hits);
+    EXPECT_EQ(hits.size(), 1);
+    EXPECT_EQ(hits[0], spheres[2].get());
+
+    // A single shape
+    bvh.construct_sah(spheres.data(), 1);
+    EXPECT_DOUBLE_EQ(bvh.sah_cost(), 1);
+    EXPECT_DOUBLE_EQ(bvh.sah_cost(1, 3), 3);
+}
+
+/// \brief Test the expected cost of a BVH tree
+TEST(bvh_tree, sah_cost) {
+    bardrix::bvh_tree bvh;
+    EXPECT_DOUBLE_EQ(bvh.sah_cost(), 0);
+
+    // Two clusters along the x-axis, with a far outlier on the y-axis
+    std::vector<std::shared_ptr<bardrix::shape>> shapes;
+    for (int i = 0; i < 8; ++i) {
+        shapes.push_back(std::make_shared<bardrix::sphere>(bardrix::point3(i * 0.1, 0, 0), 0.05));
+        shapes.push_back(std::make_shared<bardrix::sphere>(bardrix::point3(100 + i * 0.1, 0, 0), 0.05));
+    }
+    shapes.push_back(std::make_shared<bardrix::sphere>(bardrix::point3(50, 40, 0), 0.05));
+
+    bvh.construct_longest_axis(shapes.begin(), shapes.end());
+    const double longest_axis_cost = bvh.sah_cost();
+
+    bvh.construct_sah(shapes.begin(), shapes.end());
+    const double sah_cost = bvh.sah_cost();
+
+    // The root is always visited
+    EXPECT_GT(sah_cost, 1);
+    EXPECT_LT(sah_cost, longest_axis_cost);
+
+    // Point shapes have no area, every node is counted
+    std::shared_ptr<bardrix::shape> points[]{
+            std::make_shared<bardrix::sphere>(bardrix::point3{ 0, 0, 0 }, 0),
+            std::make_shared<bardrix::sphere>(bardrix::point3{ 0, 0, 0 }, 0),
+    };
+    bvh.construct_sah(points, 2);
+    EXPECT_DOUBLE_EQ(bvh.sah_cost(), 3);
+    EXPECT_DOUBLE_EQ(bvh.sah_cost(2, 1), 4);
+}
+
+std::size_t bvh_depth(const std::vector<bardrix::bvh_node>& nodes, std::size_t index) {
+    if (nodes[index].is_leaf()) return 1;
+    return 1 + std::max(bvh_depth(nodes, index + 1), bvh_depth(nodes, nodes[index].offset));
+}
+
+/// \brief Test the flattened layout of a BVH tree
+TEST(bvh_tree, flat_layout) {
+    bardrix::bvh_tree bvh;
+    EXPECT_TRUE(bvh.is_empty());
+    EXPECT_TRUE(bvh.nodes().empty());
+    EXPECT_TRUE(bvh.primitives().empty());
+
+    std::vector<std::shared_ptr<bardrix::shape>> shapes;
+    for (int i = 0; i < 5; ++i)
+        shapes.push_back(std::make_shared<bardrix::sphere>(bardrix::point3(i * 3, 0, 0), 1));
+
+    bvh.construct_longest_axis(shapes.begin(), shapes.end());
+    EXPECT_FALSE(bvh.is_empty());
+
+    // A binary tree with one shape per leaf has 2N - 1 nodes
+    const std::vector<bardrix::bvh_node>& nodes = bvh.nodes();
+    ASSERT_EQ(nodes.size(), 9);
+    ASSERT_EQ(bvh.primitives().size(), 5);
+
+    // The root encloses all the shapes
+    EXPECT_EQ(nodes[0].bounding_box(), bardrix::bounding_box(bardrix::point3(-1, -1, -1), bardrix::point3(13, 1, 1)));
+    EXPECT_DOUBLE_EQ(nodes[0].area(), nodes[0].bounding_box().area());
+    EXPECT_FALSE(nodes[0].is_leaf());
+
+    // Every shape is referenced exactly once, the left child is the next node and the right child is at the offset
+    std::size_t referenced = 0;
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].is_leaf()) {
+            EXPECT_LT(nodes[i].offset + nodes[i].count, bvh.primitives().size() + 1);
+            EXPECT_EQ(nodes[i].bounding_box(), bvh.primitives()[nodes[i].offset]->bounding_box());
+            referenced += nodes[i].count;
+            continue;
+        }
+
+        ASSERT_GT(nodes[i].offset, i + 1);
+        ASSERT_LT(nodes[i].offset, nodes.size());
+        EXPECT_TRUE(nodes[i].bounding_box().inside(nodes[i + 1].bounding_box()));
+        EXPECT_TRUE(nodes[i].bounding_box().inside(nodes[nodes[i].offset].bounding_box()));
+    }
+    EXPECT_EQ(referenced, shapes.size());
+
+    // The shapes are stored in the order of the leaves, sorted on the x-axis
+    for (std::size_t i = 0; i < shapes.size(); ++i)
+        EXPECT_EQ(bvh.primitives()[i], shapes[i]);
+
+    bvh.clear();
+    EXPECT_TRUE(bvh.is_empty());
+    EXPECT_TRUE(bvh.primitives().empty());
+}
+
+/// \brief Test that the depth of a BVH tree stays within the maximum depth
+TEST(bvh_tree, max_depth) {
+    bardrix::bvh_tree bvh;
+
+    // Exponentially spaced shapes make the surface area heuristic split off one shape at a time
+    std::vector<std::shared_ptr<bardrix::shape>> shapes;
+    for (int i = 0; i < 100; ++i)
+        shapes.push_back(std::make_shared<bardrix::sphere>(bardrix::point3(std::pow(2, i), 0, 0), 0.1));
+
+    bvh.construct_sah(shapes.begin(), shapes.end());
+    EXPECT_LE(bvh_depth(bvh.nodes(), 0), bardrix::bvh_tree::max_depth);
+    EXPECT_EQ(bvh.primitives().size(), shapes.size());
+
+    std::vector<const bardrix::shape*> hits;
+    bvh.intersections(bardrix::ray(bardrix::point3(1, 0, -10), bardrix::vector3(0, 0, 1), 20), hits);
+    EXPECT_EQ(hits.size(), 1);
+    EXPECT_EQ(hits[0], shapes[0].get());
+
+    bvh.construct_longest_axis(shapes.begin(), shapes.end());
+    EXPECT_LE(bvh_depth(bvh.nodes(), 0), bardrix::bvh_tree::max_depth);
+}
+
+/// \brief Test the closest hit of a BVH tree
+TEST(bvh_tree, closest_hit) {
+    bardrix::bvh_tree bvh;
+    EXPECT_FALSE(bvh.closest_hit(bardrix::ray(bardrix::point3(0, 0, 0), bardrix::vector3(1, 0, 0), 100)));
+
+    // A row of spheres along the x-axis
+    std::vector<std::shared_ptr<bardrix::shape>> shapes;
+    for (int i = 0; i < 10; ++i)
+        shapes.push_back(std::make_shared<bardrix::sphere>(bardrix::point3(10 + i * 3, 0, 0), 1));
+
+    for (int builder = 0; builder < 2; ++builder) {
+        if (builder == 0) bvh.construct_longest_axis(shapes.begin(), shapes.end());
+        else bvh.construct_sah(shapes.begin(), shapes.end());
+
+        // From the left the first sphere is the closest
+        std::optional<bardrix::bvh_hit> hit = bvh.closest_hit(
+                bardrix::ray(bardrix::point3(0, 0, 0), bardrix::vector3(1, 0, 0), 100));
+        ASSERT_TRUE(hit);
+        EXPECT_EQ(hit->shape, shapes[0].get());
+        EXPECT_NEAR(hit->distance, 9, 1e-9);
+
+        // From the right the last sphere is the closest
+        hit = bvh.closest_hit(bardrix::ray(bardrix::point3(100, 0, 0), bardrix::vector3(-1, 0, 0), 100));
+        ASSERT_TRUE(hit);
+        EXPECT_EQ(hit->shape, shapes[9].get());
+        EXPECT_NEAR(hit->distance, 62, 1e-9);
+
+        // The ray is too short to reach any sphere
+        EXPECT_FALSE(bvh.closest_hit(bardrix::ray(bardrix::point3(0, 0, 0), bardrix::vector3(1, 0, 0), 8)));
+
+        // The ray misses all spheres
+        EXPECT_FALSE(bvh.closest_hit(bardrix::ray(bardrix::point3(0, 5, 0), bardrix::vector3(1, 0, 0), 100)));
+
+        // Starting in between spheres, only the spheres in front count
+        hit = bvh.closest_hit(bardrix::ray(bardrix::point3(20.5, 0, 0), bardrix::vector3(1, 0, 0), 100));
+        ASSERT_TRUE(hit);
+        EXPECT_EQ(hit->shape, shapes[4].get());
+        EXPECT_NEAR(hit->distance, 0.5, 1e-9);
+    }
+}
+
+/// \brief Test the Morton code (linear BVH) builder
+TEST(bvh_tree, construct_morton) {
+    bardrix::bvh_tree bvh;
+
+    std::vector<std::shared_ptr<bardrix::shape>> shapes;
+    for (int i = 0; i < 500; ++i)
+        shapes.push_back(std::make_shared<bardrix::sphere>(
+                bardrix::point3(std::fmod(i * 7.31, 40) - 20, std::fmod(i * 3.77, 40) - 20, std::fmod(i * 5.13, 40) - 20),
+                0.5 + std::fmod(i * 0.37, 1.5)));
+
+    // Empty ranges give an empty tree
+    bvh.construct_morton(shapes.begin(), shapes.begin());
+    EXPECT_TRUE(bvh.is_empty());
+
+    for (const std::size_t bits: { std::size_t(30), std::size_t(63) }) {
+        bvh.construct_morton(shapes.data(), shapes.size(), bits);
+        ASSERT_EQ(bvh.nodes().size(), 2 * shapes.size() - 1);
+        ASSERT_EQ(bvh.primitives().size(), shapes.size());
+        EXPECT_LE(bvh_depth(bvh.nodes(), 0), bardrix::bvh_tree::max_depth);
+
+        // Every node contains its children
+        for (std::size_t i = 0; i < bvh.nodes().size(); ++i) {
+            const bardrix::bvh_node& node = bvh.nodes()[i];
+            if (node.is_leaf()) {
+                EXPECT_EQ(node.bounding_box(), bvh.primitives()[node.offset]->bounding_box());
+                continue;
+            }
+
+            bardrix::bounding_box box = bvh.nodes()[i + 1].bounding_box();
+            box.merge(bvh.nodes()[node.offset].bounding_box());
+            EXPECT_EQ(node.bounding_box(), box);
+        }
+
+        // The tree gives the same closest hits as a tree built with the surface area heuristic
+        bardrix::bvh_tree sah;
+        sah.construct_sah(shapes.begin(), shapes.end());
+        for (int i = 0; i < 100; ++i) {
+            const bardrix::ray ray(bardrix::point3(-30, std::fmod(i * 1.9, 30) - 15, std::fmod(i * 2.3, 30) - 15),
+                                   bardrix::vector3(1, std::fmod(i * 0.13, 0.6) - 0.3, std::fmod(i * 0.07, 0.6) - 0.3), 100);
+
+            std::optional<bardrix::bvh_hit> expected = sah.closest_hit(ray);
+            std::optional<bardrix::bvh_hit> hit = bvh.closest_hit(ray);
+            ASSERT_EQ(hit.has_value(), expected.has_value());
+            if (!hit) continue;
+
+            EXPECT_EQ(hit->shape, expected->shape);
+            EXPECT_DOUBLE_EQ(hit->distance, expected->distance);
+        }
+    }
+
+    // Shapes with the same center have the same code, they are split by count
+    std::vector<std::shared_ptr<bardrix::shape>> same;
+    for (int i = 0; i < 1000; ++i)
+        same.push_back(std::make_shared<bardrix::sphere>(bardrix::point3(1, 2, 3), 1));
+
+    bvh.construct_morton(same.begin(), same.end(), 63);
+    ASSERT_EQ(bvh.primitives().size(), same.size());
+    EXPECT_LE(bvh_depth(bvh.nodes(), 0), 11);
+}
+
+/// \brief Test the spatial split (SBVH) builder
+TEST(bvh_tree, construct_sbvh) {
+    bardrix::bvh_tree bvh;
+
+    // A few large background spheres between many small spheres
+    std::vector<std::shared_ptr<bardrix::shape>> shapes;
+    for (int i = 0; i < 4; ++i)
+        shapes.push_back(std::make_shared<bardrix::sphere>(bardrix::point3(i * 10 - 15, 0, 0), 12));
+    for (int i = 0; i < 400; ++i)
+        shapes.push_back(std::make_shared<bardrix::sphere>(
+                bardrix::point3(std::fmod(i * 7.31, 40) - 20, std::fmod(i * 3.77, 40) - 20, std::fmod(i * 5.13, 40) - 20),
+                0.1 + std::fmod(i * 0.37, 0.4)));
+
+    // Empty ranges give an empty tree
+    bvh.construct_sbvh(shapes.begin(), shapes.begin());
+    EXPECT_TRUE(bvh.is_empty());
+
+    // Without a budget there are no spatial splits
+    bvh.construct_sbvh(shapes.data(), shapes.size(), 0);
+    EXPECT_EQ(bvh.primitives().size(), shapes.size());
+
+    bardrix::bvh_tree sah;
+    sah.construct_sah(shapes.begin(), shapes.end());
+
+    bvh.construct_sbvh(shapes.begin(), shapes.end(), 0.5);
+    EXPECT_GT(bvh.primitives().size(), shapes.size());
+    EXPECT_LE(bvh.primitives().size(), shapes.size() + shapes.size() / 2);
+    EXPECT_EQ(bvh.nodes().size(), 2 * bvh.primitives().size() - 1);
+    EXPECT_LE(bvh_depth(bvh.nodes(), 0), bardrix::bvh_tree::max_depth);
+
+    // The leaves of a shape are clipped parts of its bounding box
+    for (const bardrix::bvh_node& node: bvh.nodes())
+        if (node.is_leaf())
+            EXPECT_TRUE(bvh.primitives()[node.offset]->bounding_box().inside(node.bounding_box()));
+
+    // Every shape is in the tree
+    std::vector<const bardrix::shape*> primitives;
+    for (const auto& shape: bvh.primitives())
+        primitives.push_back(shape.get());
+    std::sort(primitives.begin(), primitives.end());
+    EXPECT_EQ(std::unique(primitives.begin(), primitives.end()) - primitives.begin(), shapes.size());
+
+    for (int i = 0; i < 100; ++i) {
+        const bardrix::ray ray(bardrix::point3(-30, std::fmod(i * 1.9, 30) - 15, std::fmod(i * 2.3, 30) - 15),
+                               bardrix::vector3(1, std::fmod(i * 0.13, 0.6) - 0.3, std::fmod(i * 0.07, 0.6) - 0.3), 100);
+
+        // The closest hits are the same as without spatial splits
+        std::optional<bardrix::bvh_hit> expected = sah.closest_hit(ray);
+        std::optional<bardrix::bvh_hit> hit = bvh.closest_hit(ray);
+        ASSERT_EQ(hit.has_value(), expected.has_value());
+        if (hit) {
+            EXPECT_EQ(hit->shape, expected->shape);
+            EXPECT_DOUBLE_EQ(hit->distance, expected->distance);
+        }
+
+        // A shape in more than one leaf is only added once, every shape the ray hits is included
+        std::vector<const bardrix::shape*> hits;
+        bvh.intersections(ray, hits);
+        std::vector<const bardrix::shape*> expected_hits;
+        for (const auto& shape: shapes)
+            if (shape->intersection(ray)) expected_hits.push_back(shape.get());
+        std::sort(hits.begin(), hits.end());
+        EXPECT_EQ(std::unique(hits.begin(), hits.end()), hits.end());
+        EXPECT_TRUE(includes_all_shapes(hits, expected_hits));
+    }
+
+    // The clipped leaves cost less than the unclipped ones a refit gives, which don't count as degraded
+    EXPECT_LT(bvh.degradation(), 1);
+    const std::optional<bardrix::bvh_hit> before = bvh.closest_hit(
+            bardrix::ray(bardrix::point3(-30, 0.5, 0.5), bardrix::vector3(1, 0, 0), 100));
+    bvh.refit();
+    EXPECT_NEAR(bvh.degradation(), 1, 1e-9);
+    for (const bardrix::bvh_node& node: bvh.nodes())
+        if (node.is_leaf())
+            EXPECT_TRUE(node.bounding_box().inside(bvh.primitives()[node.offset]->bounding_box()));
+
+    const std::optional<bardrix::bvh_hit> after = bvh.closest_hit(
+            bardrix::ray(bardrix::point3(-30, 0.5, 0.5), bardrix::vector3(1, 0, 0), 100));
+    ASSERT_EQ(after.has_value(), before.has_value());
+    if (after) EXPECT_EQ(after->shape, before->shape);
+}
+
+/// \brief Test that the closest hit of a BVH tree matches testing every shape
+TEST(bvh_tree, closest_hit_brute_force) {
+    bardrix::bvh_tree bvh;
+
+    std::vector<std::shared_ptr<bardrix::shape>> shapes;
+    for (int i = 0; i < 200; ++i)
+        shapes.push_back(std::make_shared<bardrix::sphere>(
+                bardrix::point3(std::fmod(i * 7.31, 40) - 20, std::fmod(i * 3.77, 40) - 20, std::fmod(i * 5.13, 40) - 20),
+                0.5 + std::fmod(i * 0.37, 1.5)));
+
+    bvh.construct_sah(shapes.begin(), shapes.end());
+
+    for (int i = 0; i < 100; ++i) {
+        const bardrix::ray ray(bardrix::point3(-30, std::fmod(i * 1.9, 30) - 15, std::fmod(i * 2.3, 30) - 15),
+                               bardrix::vector3(1, std::fmod(i * 0.13, 0.6) - 0.3, std::fmod(i * 0.07, 0.6) - 0.3), 100);
+
+        std::optional<bardrix::bvh_hit> expected;
+        for (const auto& shape: shapes) {
+            std::optional<bardrix::point3> intersection = shape->intersection(ray);
+            if (!intersection) continue;
+
+            const double distance = ray.position.distance(*intersection);
+            if (!expected || distance < expected->distance) expected = bardrix::bvh_hit{ shape.get(), distance };
+        }
+
+        std::optional<bardrix::bvh_hit> hit = bvh.closest_hit(ray);
+        ASSERT_EQ(hit.has_value(), expected.has_value());
+        if (!hit) continue;
+
+        EXPECT_EQ(hit->shape, expected->shape);
+        EXPECT_DOUBLE_EQ(hit->distance, expected->distance);
+    }
+}
+
+/// \brief Test the packet traversal of a BVH tree against closest_hit
+TEST(bvh_tree, closest_hits) {
+    bardrix::bvh_tree bvh;
+
+    std::vector<std::shared_ptr<bardrix::shape>> shapes;
+    for (int i = 0; i < 200; ++i)
+        shapes.push_back(std::make_shared<bardrix::sphere>(
+                bardrix::point3(std::fmod(i * 7.31, 40) - 20, std::fmod(i * 3.77, 40) - 20, std::fmod(i * 5.13, 40) + 20),
+                0.5 + std::fmod(i * 0.37, 1.5)));
+
+    // An empty tree has no hits
+    bardrix::camera camera(bardrix::point3(0, 0, 0), bardrix::vector3(0, 0, 1), 64, 64, 90);
+    std::vector<bardrix::ray> rays;
+    camera.shoot_rays(0, 0, 4, 4, 100, rays);
+
+    std::optional<bardrix::bvh_hit> hits[bardrix::bvh_tree::max_packet_size];
+    bvh.closest_hits(rays.data(), rays.size(), hits);
+    for (std::size_t i = 0; i < rays.size(); ++i)
+        EXPECT_FALSE(hits[i].has_value());
+
+    bvh.construct_sah(shapes.begin(), shapes.end());
+
+    // 4x4 and 8x8 packets, and a block of 100 rays which is split into two packets
+    for (const int size: { 4, 8, 10 }) {
+        for (int y = 0; y < 64; y += size) {
+            for (int x = 0; x < 64; x += size) {
+                camera.shoot_rays(x, y, size, size, 100, rays);
+
+                std::vector<std::optional<bardrix::bvh_hit>> packet_hits(rays.size());
+                bvh.closest_hits(rays.data(), rays.size(), packet_hits.data());
+
+                for (std::size_t i = 0; i < rays.size(); ++i) {
+                    std::optional<bardrix::bvh_hit> expected = bvh.closest_hit(rays[i]);
+                    ASSERT_EQ(packet_hits[i].has_value(), expected.has_value());
+                    if (!expected) continue;
+
+                    EXPECT_EQ(packet_hits[i]->shape, expected->shape);
+                    EXPECT_DOUBLE_EQ(packet_hits[i]->distance, expected->distance);
+                }
+            }
+        }
+    }
+}
+
+/// \brief Test the occlusion query of a BVH tree
+TEST(bvh_tree, occluded) {
+    bardrix::bvh_tree bvh;
+    EXPECT_FALSE(bvh.occluded(bardrix::ray(bardrix::point3(0, 0, 0), bardrix::vector3(1, 0, 0), 100)));
+
+    std::vector<std::shared_ptr<bardrix::shape>> shapes;
+    for (int i = 0; i < 10; ++i)
+        shapes.push_back(std::make_shared<bardrix::sphere>(bardrix::point3(10 + i * 3, 0, 0), 1));
+
+    bvh.construct_sah(shapes.begin(), shapes.end());
+
+    // A shadow ray towards a light behind the spheres is blocked
+    EXPECT_TRUE(bvh.occluded(bardrix::ray(bardrix::point3(0, 0, 0), bardrix::point3(100, 0, 0))));
+
+    // A shadow ray towards a light in front of the spheres is not blocked
+    EXPECT_FALSE(bvh.occluded(bardrix::ray(bardrix::point3(0, 0, 0), bardrix::point3(8.5, 0, 0))));
+
+    // A shadow ray between two spheres is not blocked
+    EXPECT_FALSE(bvh.occluded(bardrix::ray(bardrix::point3(11.2, 0, 0), bardrix::point3(11.8, 0, 0))));
+
+    // A shadow ray next to the spheres is not blocked
+    EXPECT_FALSE(bvh.occluded(bardrix::ray(bardrix::point3(0, 5, 0), bardrix::point3(100, 5, 0))));
+
+    // occluded agrees with closest_hit
+    for (int i = 0; i < 50; ++i) {
+        const bardrix::ray ray(bardrix::point3(0, std::fmod(i * 0.37, 4) - 2, 0),
+                               bardrix::vector3(1, 0, std::fmod(i * 0.013, 0.1) - 0.05), i * 1.0);
+        EXPECT_EQ(bvh.occluded(ray), bvh.closest_hit(ray).has_value());
+    }
+}
+
+/// \brief Test the construction of a BVH tree on multiple threads
+TEST(bvh_tree, construct_parallel) {
+    // Enough shapes to divide the work over the threads
+    std::vector<std::shared_ptr<bardrix::shape>> shapes;
+    for (int i = 0; i < 20000; ++i)
+        shapes.push_back(std::make_shared<bardrix::sphere>(
+                bardrix::point3(std::fmod(i * 7.31, 400) - 200, std::fmod(i * 3.77, 400) - 200,
+                                std::fmod(i * 5.13, 400) - 200), 0.5 + std::fmod(i * 0.37, 1.5)));
+
+    bardrix::bvh_tree serial;
+    bardrix::bvh_tree parallel;
+
+    for (int builder = 0; builder < 3; ++builder) {
+        if (builder == 0) {
+            serial.construct_longest_axis(shapes.begin(), shapes.end());
+            parallel.construct_longest_axis(shapes.begin(), shapes.end(), 4);
+        } else if (builder == 1) {
+            serial.construct_sah(shapes.begin(), shapes.end());
+            parallel.construct_sah(shapes.begin(), shapes.end(), bardrix::bvh_tree::default_sah_bins, 4);
+        } else {
+            serial.construct_morton(shapes.begin(), shapes.end());
+            parallel.construct_morton(shapes.begin(), shapes.end(), bardrix::bvh_tree::default_morton_bits, 4);
+        }
+
+        ASSERT_EQ(parallel.nodes().size(), 2 * shapes.size() - 1);
+        ASSERT_EQ(parallel.primitives().size(), shapes.size());
+        EXPECT_EQ(parallel.nodes().front().bounding_box(), serial.nodes().front().bounding_box());
+        EXPECT_NEAR(parallel.sah_cost(), serial.sah_cost(), serial.sah_cost() * 0.01);
+        EXPECT_LE(bvh_depth(parallel.nodes(), 0), bardrix::bvh_tree::max_depth);
+
+        // Every shape is in the tree exactly once
+        std::vector<const bardrix::shape*> primitives;
+        for (const auto& shape: parallel.primitives())
+            primitives.push_back(shape.get());
+        std::sort(primitives.begin(), primitives.end());
+        EXPECT_EQ(std::unique(primitives.begin(), primitives.end()), primitives.end());
+
+        // Both trees give the same closest hits
+        for (int i = 0; i < 100; ++i) {
+            const bardrix::ray ray(bardrix::point3(-300, std::fmod(i * 19.1, 300) - 150, std::fmod(i * 23.3, 300) - 150),
+                                   bardrix::vector3(1, std::fmod(i * 0.13, 0.6) - 0.3, std::fmod(i * 0.07, 0.6) - 0.3), 1000);
+
+            std::optional<bardrix::bvh_hit> expected = serial.closest_hit(ray);
+            std::optional<bardrix::bvh_hit> hit = parallel.closest_hit(ray);
+            ASSERT_EQ(hit.has_value(), expected.has_value());
+            if (hit) EXPECT_EQ(hit->shape, expected->shape);
+        }
+    }
+
+    // 0 threads uses all hardware threads
+    parallel.construct_sah(shapes.data(), shapes.size(), bardrix::bvh_tree::default_sah_bins, 0);
+    EXPECT_EQ(parallel.primitives().size(), shapes.size());
+    parallel.construct_longest_axis(shapes.data(), 3, 0);
+    EXPECT_EQ(parallel.primitives().size(), 3);
+}
+
+/// \brief Test the refitting of a BVH tree after moving shapes
+TEST(bvh_tree, refit) {
+    bardrix::bvh_tree bvh;
+    bvh.refit();
+    EXPECT_DOUBLE_EQ(bvh.degradation(), 1);
+
+    std::vector<std::shared_ptr<bardrix::sphere>> spheres;
+    for (int i = 0; i < 16; ++i)
+        spheres.push_back(std::make_shared<bardrix::sphere>(bardrix::point3(i * 3, 0, 0), 1));
+
+    bvh.construct_sah(spheres.begin(), spheres.end());
+    const std::vector<bardrix::bvh_node> nodes = bvh.nodes();
+    EXPECT_DOUBLE_EQ(bvh.degradation(), 1);
+
+    // Nothing moved, nothing changes
+    bvh.refit();
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+        EXPECT_EQ(bvh.nodes()[i].bounding_box(), nodes[i].bounding_box());
+
+    // Move every sphere up, the structure stays the same
+    for (const auto& sphere: spheres)
+        sphere->set_position(sphere->get_position() + bardrix::vector3(0, 10, 0));
+    bvh.refit();
+
+    ASSERT_EQ(bvh.nodes().size(), nodes.size());
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        EXPECT_EQ(bvh.nodes()[i].offset, nodes[i].offset);
+        EXPECT_EQ(bvh.nodes()[i].count, nodes[i].count);
+        EXPECT_EQ(bvh.nodes()[i].bounding_box(), nodes[i].bounding_box() + bardrix::vector3(0, 10, 0));
+    }
+    EXPECT_NEAR(bvh.degradation(), 1, 1e-9);
+
+    std::optional<bardrix::bvh_hit> hit = bvh.closest_hit(
+            bardrix::ray(bardrix::point3(-10, 10, 0), bardrix::vector3(1, 0, 0), 100));
+    ASSERT_TRUE(hit);
+    EXPECT_EQ(hit->shape, spheres[0].get());
+    EXPECT_FALSE(bvh.occluded(bardrix::ray(bardrix::point3(-10, 0, 0), bardrix::vector3(1, 0, 0), 100)));
+
+    // Swap the first and the last sphere, the tree is still correct but worse
+    spheres.front()->set_position(bardrix::point3(45, 10, 0));
+    spheres.back()->set_position(bardrix::point3(0, 10, 0));
+    bvh.refit();
+    EXPECT_GT(bvh.degradation(), 1);
+
+    hit = bvh.closest_hit(bardrix::ray(bardrix::point3(-10, 10, 0), bardrix::vector3(1, 0, 0), 100));
+    ASSERT_TRUE(hit);
+    EXPECT_EQ(hit->shape, spheres.back().get());
+
+    // A rebuild restores the quality
+    bvh.construct_sah(spheres.begin(), spheres.end());
+    EXPECT_DOUBLE_EQ(bvh.degradation(), 1);
+}
+
+/// \brief Test saving a BVH tree to a file and loading it again
+TEST(bvh_tree, save_load) {
+    const std::string path = ::testing::TempDir() + "bardrix_bvh_tree_save_load.bvh";
+
+    std::vector<std::shared_ptr<bardrix::shape>> shapes;
+    for (int i = 0; i < 200; ++i)
+        shapes.push_back(std::make_shared<bardrix::sphere>(
+                bardrix::point3(std::fmod(i * 7.31, 40) - 20, std::fmod(i * 3.77, 40) - 20, std::fmod(i * 5.13, 40) - 20),
+                0.5 + std::fmod(i * 0.37, 1.5)));
+
+    // An empty tree stays empty
+    bardrix::bvh_tree bvh;
+    bvh.save(path, shapes);
+
+    bardrix::bvh_tree loaded;
+    loaded.load(path, shapes);
+    EXPECT_TRUE(loaded.is_empty());
+
+    // The SBVH references shapes more than once
+    for (const int builder: { 0, 1 }) {
+        if (builder == 0) bvh.construct_sah(shapes.begin(), shapes.end());
+        else bvh.construct_sbvh(shapes.begin(), shapes.end());
+
+        bvh.save(path, shapes);
+        loaded.load(path, shapes);
+
+        ASSERT_EQ(loaded.nodes().size(), bvh.nodes().size());
+        for (std::size_t i = 0; i < bvh.nodes().size(); ++i) {
+            EXPECT_EQ(loaded.nodes()[i].bounding_box(), bvh.nodes()[i].bounding_box());
+            EXPECT_EQ(loaded.nodes()[i].offset, bvh.nodes()[i].offset);
+            EXPECT_EQ(loaded.nodes()[i].count, bvh.nodes()[i].count);
+        }
+        EXPECT_EQ(loaded.primitives(), bvh.primitives());
+        EXPECT_DOUBLE_EQ(loaded.degradation(), 1);
+
+        for (int i = 0; i < 100; ++i) {
+            const bardrix::ray ray(bardrix::point3(-30, std::fmod(i * 1.9, 30) - 15, std::fmod(i * 2.3, 30) - 15),
+                                   bardrix::vector3(1, std::fmod(i * 0.13, 0.6) - 0.3, std::fmod(i * 0.07, 0.6) - 0.3), 100);
+
+            std::vector<const bardrix::shape*> expected, hits;
+            bvh.intersections(ray, expected);
+            loaded.intersections(ray, hits);
+            EXPECT_EQ(hits, expected);
+        }
+    }
+
+    // The SBVH keeps its duplicate references apart when it's loaded against more shapes than it was built from,
+    // a large background sphere is split over many leaves
+    std::vector<std::shared_ptr<bardrix::shape>> superset = shapes;
+    superset.push_back(std::make_shared<bardrix::sphere>(bardrix::point3(0, 0, 0), 15));
+    bvh.construct_sbvh(superset.begin(), superset.end(), 0.5);
+    ASSERT_GT(bvh.primitives().size(), superset.size());
+
+    for (int i = 0; i < 300; ++i)
+        superset.push_back(std::make_shared<bardrix::sphere>(bardrix::point3(1000 + i, 0, 0), 0.5));
+    bvh.save(path, superset);
+    loaded.load(path, superset);
+
+    for (int i = 0; i < 100; ++i) {
+        const bardrix::ray ray(bardrix::point3(-30, std::fmod(i * 1.9, 30) - 15, std::fmod(i * 2.3, 30) - 15),
+                               bardrix::vector3(1, std::fmod(i * 0.13, 0.6) - 0.3, std::fmod(i * 0.07, 0.6) - 0.3), 100);
+
+        std::vector<const bardrix::shape*> expected, hits;
+        bvh.intersections(ray, expected);
+        loaded.intersections(ray, hits);
+        EXPECT_EQ(hits, expected);
+    }
+
+    // A shape which is not in the given shapes cannot be saved
+    std::vector<std::shared_ptr<bardrix::shape>> missing(shapes.begin() + 1, shapes.end());
+    EXPECT_THROW(bvh.save(path, missing), std::invalid_argument);
+
+    // A file which references more shapes than given cannot be loaded, the tree is left as is
+    EXPECT_THROW(loaded.load(path, missing), std::runtime_error);
+    EXPECT_EQ(loaded.primitives(), bvh.primitives());
+
+    // A missing file and a file which is not a BVH file cannot be loaded
+    std::remove(path.c_str());
+    EXPECT_THROW(loaded.load(path, shapes), std::runtime_error);
+
+    std::ofstream(path, std::ios::binary) << "not a BVH file, but long enough to contain a header of sixty four bytes";
+    EXPECT_THROW(loaded.load(path, shapes), std::runtime_error);
+
+    // A file with a child or leaf outside of the tree cannot be loaded
+    bvh.construct_sah(shapes.begin(), shapes.end());
+    for (const std::size_t node: { std::size_t{ 0 }, bvh.nodes().size() - 1 }) {
+        bvh.save(path, shapes);
+        {
+            std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(static_cast<std::streamoff>(64 + node * sizeof(bardrix::bvh_node) + offsetof(bardrix::bvh_node, offset)));
+            const std::uint32_t offset = 100000;
+            file.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+        }
+        EXPECT_THROW(loaded.load(path, shapes), std::runtime_error);
+        EXPECT_THROW(bardrix::mapped_bvh{ path }, std::runtime_error);
+    }
+
+    std::remove(path.c_str());
+}
+
+/// \brief Test the traversal of a memory mapped BVH tree against the BVH tree it was saved from
+TEST(mapped_bvh, closest_hit) {
+    const std::string path = ::testing::TempDir() + "bardrix_mapped_bvh_closest_hit.bvh";
+
+    std::vector<std::shared_ptr<bardrix::shape>> shapes;
+    for (int i = 0; i < 200; ++i)
+        shapes.push_back(std::make_shared<bardrix::sphere>(
+                bardrix::point3(std::fmod(i * 7.31, 40) - 20, std::fmod(i * 3.77, 40) - 20, std::fmod(i * 5.13, 40) - 20),
+                0.5 + std::fmod(i * 0.37, 1.5)));
+
+    bardrix::mapped_bvh mapped;
+    EXPECT_FALSE(mapped.is_open());
+    EXPECT_FALSE(mapped.closest_hit(bardrix::ray(bardrix::point3(0, 0, 0), bardrix::vector3(1, 0, 0), 100), shapes));
+
+    bardrix::bvh_tree bvh;
+    bvh.construct_sah(shapes.begin(), shapes.end());
+    bvh.save(path, shapes);
+
+    mapped.open(path);
+    ASSERT_TRUE(mapped.is_open());
+    ASSERT_EQ(mapped.node_count(), bvh.nodes().size());
+    ASSERT_EQ(mapped.primitive_count(), bvh.primitives().size());
+    for (std::size_t i = 0; i < mapped.primitive_count(); ++i)
+        EXPECT_EQ(shapes[mapped.indices()[i]], bvh.primitives()[i]);
+
+    // Moving keeps the mapping
+    bardrix::mapped_bvh moved(std::move(mapped));
+    EXPECT_FALSE(mapped.is_open());
+    ASSERT_TRUE(moved.is_open());
+
+    for (int i = 0; i < 100; ++i) {
+        const bardrix::ray ray(bardrix::point3(-30, std::fmod(i * 1.9, 30) - 15, std::fmod(i * 2.3, 30) - 15),
+                               bardrix::vector3(1, std::fmod(i * 0.13, 0.6) - 0.3, std::fmod(i * 0.07, 0.6) - 0.3),
+                               std::fmod(i * 1.7, 100));
+
+        const std::optional<bardrix::bvh_hit> expected = bvh.closest_hit(ray);
+        const std::optional<bardrix::bvh_hit> hit = moved.closest_hit(ray, shapes);
+        ASSERT_EQ(hit.has_value(), expected.has_value());
+        EXPECT_EQ(moved.occluded(ray, shapes), bvh.occluded(ray));
+        if (!hit) continue;
+
+        EXPECT_EQ(hit->shape, expected->shape);
+        EXPECT_DOUBLE_EQ(hit->distance, expected->distance);
+    }
+
+    // Every shape index in the file has to be in the given shapes
+    const std::vector<std::shared_ptr<bardrix::shape>> missing(shapes.begin(), shapes.end() - 1);
+    const bardrix::ray ray(bardrix::point3(-30, 0, 0), bardrix::vector3(1, 0, 0), 100);
+    EXPECT_THROW((void)moved.closest_hit(ray, missing), std::invalid_argument);
+    EXPECT_THROW((void)moved.occluded(ray, missing), std::invalid_argument);
+
+    moved.close();
+    EXPECT_FALSE(moved.is_open());
+    EXPECT_EQ(moved.nodes(), nullptr);
+
+    // A file of another version cannot be opened
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(8);
+        const std::uint32_t version = bardrix::bvh_tree::file_version + 1;
+        file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    }
+    EXPECT_THROW(moved.open(path), std::runtime_error);
+    EXPECT_FALSE(moved.is_open());
+
+    // A truncated file cannot be opened
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << "BARDBVH";
+    EXPECT_THROW(bardrix::mapped_bvh{ path }, std::runtime_error);
+
+    std::remove(path.c_str());
+    EXPECT_THROW(bardrix::mapped_bvh{ path }, std::runtime_error);
+}
+
+/// \brief Test the construction and traversal of a BVH which owns its shapes
+TEST(indexed_bvh, construct) {
+    bardrix::indexed_bvh<bardrix::sphere> bvh;
+    EXPECT_TRUE(bvh.is_empty());
+    EXPECT_FALSE(bvh.closest_hit(bardrix::ray(bardrix::point3(0, 0, 0), bardrix::vector3(1, 0, 0), 100)).has_value());
+
+    // Enough shapes to divide the work over the threads
+    std::vector<bardrix::sphere> spheres;
+    for (int i = 0; i < 5000; ++i)
+        spheres.emplace_back(bardrix::point3(std::fmod(i * 7.31, 80) - 40, std::fmod(i * 3.77, 80) - 40,
+                                             std::fmod(i * 5.13, 80) - 40),
+                             0.2 + std::fmod(i * 0.37, 0.5));
+
+    for (const std::size_t leaf_size: { std::size_t(1), bardrix::indexed_bvh<bardrix::sphere>::default_leaf_size }) {
+        bvh.construct(spheres, leaf_size, bardrix::bvh_tree::default_sah_bins, 4);
+        ASSERT_EQ(bvh.shapes().size(), spheres.size());
+        ASSERT_EQ(bvh.indices().size(), spheres.size());
+
+        // Every shape is in exactly one leaf, inside the bounding box of the leaf
+        std::vector<bool> seen(spheres.size(), false);
+        std::size_t leaves = 0;
+        for (const bardrix::bvh_node& node: bvh.nodes()) {
+            if (!node.is_leaf()) continue;
+            ++leaves;
+            EXPECT_LE(node.count, leaf_size);
+
+            for (std::uint32_t i = node.offset; i < node.offset + node.count; ++i) {
+                const std::uint32_t index = bvh.indices()[i];
+                EXPECT_FALSE(seen[index]);
+                seen[index] = true;
+                EXPECT_EQ(bvh.shapes()[i].get_position(), spheres[index].get_position());
+                EXPECT_TRUE(node.bounding_box().inside(bvh.shapes()[i].bounding_box()));
+            }
+        }
+        EXPECT_EQ(std::count(seen.begin(), seen.end(), true), static_cast<std::ptrdiff_t>(spheres.size()));
+        EXPECT_EQ(bvh.nodes().size(), 2 * leaves - 1);
+        if (leaf_size > 1) EXPECT_LT(leaves, spheres.size());
+
+        for (int i = 0; i < 100; ++i) {
+            const bardrix::ray ray(bardrix::point3(-50, std::fmod(i * 1.9, 60) - 30, std::fmod(i * 2.3, 60) - 30),
+                                   bardrix::vector3(1, std::fmod(i * 0.13, 0.6) - 0.3, std::fmod(i * 0.07, 0.6) - 0.3),
+                                   std::fmod(i * 3.7, 150));
+
+            std::optional<double> expected;
+            std::uint32_t expected_index = 0;
+            for (std::uint32_t j = 0; j < spheres.size(); ++j) {
+                std::optional<bardrix::point3> intersection = spheres[j].intersection(ray);
+                if (!intersection) continue;
+
+                const double distance = ray.position.distance(*intersection);
+                if (!expected || distance < *expected) {
+                    expected = distance;
+                    expected_index = j;
+                }
+            }
+
+            std::optional<bardrix::bvh_hit> hit = bvh.closest_hit(ray);
+            ASSERT_EQ(hit.has_value(), expected.has_value());
+            EXPECT_EQ(bvh.occluded(ray), expected.has_value());
+            if (!hit) continue;
+
+            EXPECT_EQ(bvh.index_of(hit->shape), expected_index);
+            EXPECT_DOUBLE_EQ(hit->distance, *expected);
+        }
+    }
+
+    bvh.clear();
+    EXPECT_TRUE(bvh.is_empty());
+    EXPECT_TRUE(bvh.shapes().empty());
+
+    bvh.construct({});
+    EXPECT_TRUE(bvh.is_empty());
+}
+
+/// \brief Test the collapse of a BVH tree into a wide BVH
+TEST(wide_bvh, collapse) {
+    bardrix::bvh_tree tree;
+    bardrix::bvh4 wide4;
+    bardrix::bvh8 wide8;
+
+    // An empty tree
+    wide4.collapse(tree);
+    EXPECT_TRUE(wide4.is_empty());
+    EXPECT_FALSE(wide4.closest_hit(bardrix::ray(bardrix::vector3(1, 0, 0))));
+    EXPECT_FALSE(wide4.occluded(bardrix::ray(bardrix::vector3(1, 0, 0))));
+
+    // A single shape
+    std::vector<std::shared_ptr<bardrix::shape>> shapes{ std::make_shared<bardrix::sphere>(bardrix::point3(5, 0, 0), 1) };
+    tree.construct_sah(shapes.begin(), shapes.end());
+    wide4.collapse(tree);
+    ASSERT_EQ(wide4.nodes().size(), 1);
+    EXPECT_EQ(wide4.nodes()[0].count[0], 1);
+    EXPECT_TRUE(wide4.nodes()[0].bounds.is_empty(1));
+    std::optional<bardrix::bvh_hit> hit = wide4.closest_hit(bardrix::ray(bardrix::point3(0, 0, 0), bardrix::vector3(1, 0, 0), 10));
+    ASSERT_TRUE(hit);
+    EXPECT_EQ(hit->shape, shapes[0].get());
+    EXPECT_NEAR(hit->distance, 4, 1e-9);
+
+    // Many shapes
+    shapes.clear();
+    for (int i = 0; i < 1000; ++i)
+        shapes.push_back(std::make_shared<bardrix::sphere>(
+                bardrix::point3(std::fmod(i * 7.31, 40) - 20, std::fmod(i * 3.77, 40) - 20, std::fmod(i * 5.13, 40) - 20),
+                0.2 + std::fmod(i * 0.37, 0.8)));
+    tree.construct_sah(shapes.begin(), shapes.end());
+    wide4.collapse(tree);
+    wide8.collapse(tree);
+
+    EXPECT_EQ(wide4.primitives(), tree.primitives());
+    EXPECT_LT(wide4.nodes().size(), tree.nodes().size() / 4);
+    EXPECT_LT(wide8.nodes().size(), tree.nodes().size() / 4);
+
+    // Every shape is referenced exactly once
+    std::size_t referenced = 0;
+    for (const auto& node: wide8.nodes())
+        for (std::size_t lane = 0; lane < 8; ++lane)
+            if (!node.bounds.is_empty(lane)) referenced += node.count[lane];
+    EXPECT_EQ(referenced, shapes.size());
+
+    // The wide BVHs give the same answers as the binary BVH tree
+    for (int i = 0; i < 200; ++i) {
+        const bardrix::ray ray(bardrix::point3(-30, std::fmod(i * 1.9, 30) - 15, std::fmod(i * 2.3, 30) - 15),
+                               bardrix::vector3(1, std::fmod(i * 0.13, 0.6) - 0.3, std::fmod(i * 0.07, 0.6) - 0.3),
+                               5 + std::fmod(i * 0.7, 60));
+
+        const std::optional<bardrix::bvh_hit> expected = tree.closest_hit(ray);
+        for (const std::optional<bardrix::bvh_hit>& actual: { wide4.closest_hit(ray), wide8.closest_hit(ray) }) {
+            ASSERT_EQ(actual.has_value(), expected.has_value());
+            if (!actual) continue;
+            EXPECT_EQ(actual->shape, expected->shape);
+            EXPECT_DOUBLE_EQ(actual->distance, expected->distance);
+        }
+
+        EXPECT_EQ(wide4.occluded(ray), tree.occluded(ray));
+        EXPECT_EQ(wide8.occluded(ray), tree.occluded(ray));
+    }
+
+    wide8.clear();
+    EXPECT_TRUE(wide8.is_empty());
+    EXPECT_TRUE(wide8.primitives().empty());
+}
+
+/// \brief Test a two level BVH against one flat BVH tree with a copy of every shape
+TEST(instanced_bvh, closest_hit) {
+    bardrix::instanced_bvh scene;
+    EXPECT_TRUE(scene.is_empty());
+    EXPECT_FALSE(scene.closest_hit(bardrix::ray(bardrix::point3(0, 0, 0), bardrix::vector3(1, 0, 0), 100)).has_value());
+
+    // One sub-assembly of spheres, shared by every instance
+    std::vector<std::shared_ptr<bardrix::sphere>> spheres;
+    for (int i = 0; i < 30; ++i)
+        spheres.push_back(std::make_shared<bardrix::sphere>(
+                bardrix::point3(std::fmod(i * 7.31, 6) - 3, std::fmod(i * 3.77, 6) - 3, std::fmod(i * 5.13, 6) - 3),
+                0.2 + std::fmod(i * 0.37, 0.5)));
+
+    auto tree = std::make_shared<bardrix::bvh_tree>();
+    tree->construct_sah(spheres.begin(), spheres.end());
+
+    std::vector<bardrix::bvh_instance> instances;
+    std::vector<std::shared_ptr<bardrix::shape>> copies;
+    for (int i = 0; i < 40; ++i) {
+        const bardrix::quaternion rotation = bardrix::quaternion::rotation_degrees(
+                bardrix::vector3(std::fmod(i * 0.7, 1) - 0.5, 1, std::fmod(i * 0.3, 1)), i * 37);
+        const bardrix::vector3 translation(std::fmod(i * 13.1, 60) - 30, std::fmod(i * 7.7, 60) - 30, std::fmod(i * 3.3, 60));
+        instances.emplace_back(tree, rotation, translation);
+
+        for (const auto& sphere: spheres)
+            copies.push_back(std::make_shared<bardrix::sphere>(instances.back().to_world(sphere->get_position()),
+                                                               sphere->get_radius()));
+    }
+
+    // An instance of an empty tree is ignored
+    instances.emplace_back(std::make_shared<bardrix::bvh_tree>());
+
+    bardrix::bvh_tree flat;
+    flat.construct_sah(copies.begin(), copies.end());
+
+    scene.construct(instances);
+    ASSERT_EQ(scene.instances().size(), instances.size());
+    EXPECT_EQ(scene.nodes().size(), 2 * (instances.size() - 1) - 1);
+
+    // The bounding box of an instance contains its shapes
+    for (std::size_t i = 0; i + 1 < instances.size(); ++i)
+        for (std::size_t j = 0; j < spheres.size(); ++j)
+            EXPECT_TRUE(instances[i].bounding_box().inside(copies[i * spheres.size() + j]->bounding_box()));
+
+    int hits = 0;
+    for (int i = 0; i < 200; ++i) {
+        const bardrix::ray ray(bardrix::point3(-50, std::fmod(i * 1.9, 60) - 30, std::fmod(i * 2.3, 60)),
+                               bardrix::vector3(1, std::fmod(i * 0.13, 0.6) - 0.3, std::fmod(i * 0.07, 0.6) - 0.3),
+                               20 + std::fmod(i * 0.7, 100));
+
+        const std::optional<bardrix::bvh_hit> expected = flat.closest_hit(ray);
+        const std::optional<bardrix::instance_hit> hit = scene.closest_hit(ray);
+        ASSERT_EQ(hit.has_value(), expected.has_value());
+        EXPECT_EQ(scene.occluded(ray), flat.occluded(ray));
+        if (!hit) continue;
+        ++hits;
+
+        // The copy of the hit shape is the expected shape
+        const auto shape = std::find_if(spheres.begin(), spheres.end(), [&hit](const auto& sphere) {
+            return sphere.get() == hit->shape;
+        });
+        ASSERT_NE(shape, spheres.end());
+        EXPECT_EQ(copies[hit->instance * spheres.size() + (shape - spheres.begin())].get(), expected->shape);
+        EXPECT_NEAR(hit->distance, expected->distance, 1e-9);
+    }
+    EXPECT_GT(hits, 10);
+
+    // The rotation is normalized, a zero quaternion can't be
+    const bardrix::bvh_instance scaled(tree, bardrix::quaternion(0, 0, 0, 2), bardrix::vector3(1, 2, 3));
+    EXPECT_DOUBLE_EQ(scaled.rotation.length(), 1);
+    const bardrix::ray moved = scaled.to_instance(bardrix::ray(bardrix::point3(1, 2, 3), bardrix::vector3(0, 0, 1), 10));
+    EXPECT_EQ(moved.position, bardrix::point3(0, 0, 0));
+    EXPECT_DOUBLE_EQ(moved.get_length(), 10);
+    EXPECT_THROW(bardrix::bvh_instance(tree, bardrix::quaternion(0, 0, 0, 0)), std::invalid_argument);
+
+    scene.clear();
+    EXPECT_TRUE(scene.is_empty());
+    EXPECT_TRUE(scene.instances().empty());
+}
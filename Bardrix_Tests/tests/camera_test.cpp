@@ -224,6 +224,26 @@ TEST(camera, shoot_ray_degenerate) {
     EXPECT_FALSE(ray.has_value());
 }
 
+/// \brief Test the shoot_rays method
+TEST(camera, shoot_rays) {
+    bardrix::camera camera = bardrix::camera(bardrix::point3{0, 0, 0}, bardrix::vector3{0, 0, 1}, 800, 600, 90);
+
+    std::vector<bardrix::ray> rays;
+    camera.shoot_rays(8, 16, 4, 4, 10, rays);
+    ASSERT_EQ(rays.size(), 16);
+
+    // The rays are stored row by row
+    for (int y = 0; y < 4; ++y)
+        for (int x = 0; x < 4; ++x)
+            EXPECT_EQ(rays[y * 4 + x], camera.shoot_ray(8 + x, 16 + y, 10).value());
+
+    // Pixels outside the screen are skipped, the vector is cleared first
+    camera.shoot_rays(796, 596, 8, 8, 10, rays);
+    ASSERT_EQ(rays.size(), 16);
+    EXPECT_EQ(rays.front(), camera.shoot_ray(796, 596, 10).value());
+    EXPECT_EQ(rays.back(), camera.shoot_ray(799, 599, 10).value());
+}
+
 /// \brief Test the look_at method
 TEST(camera, look_at) {
     bardrix::camera camera = bardrix::camera(bardrix::point3{0, 0, 0}, bardrix::vector3{0, 0, 0});
@@ -217,6 +217,32 @@ TEST(dimension3, divide_degenerate) {
     ASSERT_EQ(dim3_result, dim3_test(-0.25, -0.5, -0.75));
 }
 
+/// \brief Test the division without checks for 0, which follows IEEE
+TEST(dimension3, divide_unchecked) {
+    dim3_test dim3{1, -2, 0};
+    double scalar = 2;
+
+    // The same results as the / operator
+    ASSERT_EQ(divide_unchecked(dim3, scalar), dim3 / scalar);
+    ASSERT_EQ(divide_unchecked(scalar, dim3_test(1, 2, 4)), scalar / dim3_test(1, 2, 4));
+    dim3_test dim3_copy = dim3;
+    divide_assign_unchecked(dim3_copy, scalar);
+    ASSERT_EQ(dim3_copy, dim3_test(0.5, -1, 0));
+
+    // Dividing by 0 gives infinity or NaN instead of throwing
+    dim3_test dim3_result = divide_unchecked(dim3, 0.0);
+    EXPECT_EQ(dim3_result.x, std::numeric_limits<double>::infinity());
+    EXPECT_EQ(dim3_result.y, -std::numeric_limits<double>::infinity());
+    EXPECT_TRUE(std::isnan(dim3_result.z));
+
+    dim3_result = divide_unchecked(scalar, dim3);
+    EXPECT_EQ(dim3_result.x, 2);
+    EXPECT_EQ(dim3_result.z, std::numeric_limits<double>::infinity());
+
+    static_assert(noexcept(divide_unchecked(dim3, scalar)));
+    static_assert(noexcept(divide_assign_unchecked(dim3_copy, scalar)));
+}
+
 /// \brief Test the modulo of a dimension3 by a scalar, using the % operator
 TEST(dimension3, modulo) {
     dim3_test dim3{1, 2, 3};
@@ -450,4 +476,13 @@ TEST(dimension3, operator_brackets) {
     ASSERT_EQ(dim3[bardrix::axis::x], 1);
     ASSERT_EQ(dim3[bardrix::axis::y], 2);
     ASSERT_EQ(dim3[bardrix::axis::z], 3);
-}
\ No newline at end of file
+}
+/// \brief Test the const operator[] of dimension3
+TEST(dimension3, operator_brackets_const) {
+    const dim3_test dim3{1, 2, 3};
+
+    ASSERT_EQ(dim3[bardrix::axis::x], 1);
+    ASSERT_EQ(dim3[bardrix::axis::y], 2);
+    ASSERT_EQ(dim3[bardrix::axis::z], 3);
+    ASSERT_THROW(static_cast<void>(dim3[bardrix::axis::w]), std::invalid_argument);
+}
@@ -244,4 +244,14 @@ TEST(dimension4, operator_brackets) {
     ASSERT_EQ(dim4[bardrix::axis::y], 2);
     ASSERT_EQ(dim4[bardrix::axis::z], 3);
     ASSERT_EQ(dim4[bardrix::axis::w], 4);
-}
\ No newline at end of file
+}
+/// \brief Test the const operator[] of dimension4
+TEST(dimension4, operator_brackets_const) {
+    const dimension4_test dim4{1, 2, 3, 4};
+
+    ASSERT_EQ(dim4[bardrix::axis::x], 1);
+    ASSERT_EQ(dim4[bardrix::axis::y], 2);
+    ASSERT_EQ(dim4[bardrix::axis::z], 3);
+    ASSERT_EQ(dim4[bardrix::axis::w], 4);
+    ASSERT_THROW(static_cast<void>(dim4[bardrix::axis::none]), std::invalid_argument);
+}
@@ -0,0 +1,59 @@
+//
+// Created by Bardio on 16/10/2026.
+//
+
+#include <bardrix/expression.h>
+
+/// \brief Test that an expression gives the same bits as the operators of dimension3
+TEST(expression, bit_identical) {
+    for (int i = 0; i < 100; ++i) {
+        const bardrix::point3 position(i * 0.37, -i / 7.0, 1e-3 * i * i);
+        const bardrix::vector3 a(std::sin(i * 1.3), 1.0 / (i + 3), -i * 0.11);
+        const bardrix::vector3 b(i / 3.0, std::cos(i * 0.7), 0.1 * i);
+        const double n = 0.1 + i / 9.0;
+
+        const bardrix::point3 expected = position + a - b + a * 2 * n - b / n;
+        const bardrix::point3 actual = bardrix::lazy(position) + a - b + bardrix::lazy(a) * 2 * n - bardrix::lazy(b) / n;
+        EXPECT_EQ(actual.x, expected.x);
+        EXPECT_EQ(actual.y, expected.y);
+        EXPECT_EQ(actual.z, expected.z);
+
+        const bardrix::vector3 expected_vector = n * (a - b) * n;
+        const bardrix::vector3 actual_vector = n * (bardrix::lazy(a) - b) * n;
+        EXPECT_EQ(actual_vector.x, expected_vector.x);
+        EXPECT_EQ(actual_vector.y, expected_vector.y);
+        EXPECT_EQ(actual_vector.z, expected_vector.z);
+    }
+}
+
+/// \brief Test the result types of an expression
+TEST(expression, types) {
+    const bardrix::point3 position(1, 2, 3);
+    const bardrix::vector3 direction(0, 0, 1);
+
+    // point3 + vector3 and point3 - vector3 give a point3
+    static_assert(std::is_same_v<decltype((bardrix::lazy(position) + direction).eval()), bardrix::point3>);
+    static_assert(std::is_same_v<decltype((bardrix::lazy(position) - direction * 2).eval()), bardrix::point3>);
+    static_assert(std::is_same_v<decltype((bardrix::lazy(direction) * 2).eval()), bardrix::vector3>);
+
+    // Without an expression the normal operators are used
+    static_assert(std::is_same_v<decltype(position + direction), bardrix::point3>);
+    static_assert(!bardrix::is_dimension3<double>::value);
+    static_assert(bardrix::is_dimension3<bardrix::vector3_f>::value);
+
+    EXPECT_EQ((bardrix::lazy(position) + direction * 2).eval(), bardrix::point3(1, 2, 5));
+
+    // Float precision
+    const bardrix::vector3_f a(1.5f, 2, 3);
+    const bardrix::vector3_f b = bardrix::lazy(a) * 2.f + a;
+    EXPECT_EQ(b, bardrix::vector3_f(4.5f, 6, 9));
+}
+
+/// \brief Test that dividing an expression by 0 throws, the same as the operator / of dimension3
+TEST(expression, division_by_zero) {
+    const bardrix::vector3 a(1, 2, 3);
+
+    EXPECT_THROW((void) (bardrix::lazy(a) / 0), std::invalid_argument);
+    EXPECT_THROW((void) (a / 0), std::invalid_argument);
+    EXPECT_EQ(bardrix::vector3(bardrix::lazy(a) / 2), bardrix::vector3(0.5, 1, 1.5));
+}
@@ -0,0 +1,91 @@
+//
+// Created by Bardio on 16/10/2026.
+//
+
+#include <bardrix/lanes.h>
+#include <bardrix/vector3.h>
+#include <bardrix/quaternion.h>
+
+/// \brief Test the loads, stores and arithmetic of lanes4
+TEST(lanes4, arithmetic) {
+    const double a[4] = { 1, 2, 3, 4 };
+    const double b[4] = { 0.5, -2, 8, 4 };
+    double out[4] = { 9, 9, 9, 9 };
+
+    // store3 doesn't write the 4th value, load3 sets the 4th lane to 0
+    (bardrix::lanes4::load3(a) + bardrix::lanes4::load3(b)).store3(out);
+    EXPECT_EQ(out[0], 1.5);
+    EXPECT_EQ(out[1], 0);
+    EXPECT_EQ(out[2], 11);
+    EXPECT_EQ(out[3], 9);
+    EXPECT_EQ(bardrix::lanes4::load3(a).sum4(), 6);
+
+    (bardrix::lanes4::load4(a) - bardrix::lanes4::load4(b)).store4(out);
+    EXPECT_EQ(out[0], 0.5);
+    EXPECT_EQ(out[3], 0);
+
+    (bardrix::lanes4::load4(a) * bardrix::lanes4::broadcast(2)).store4(out);
+    EXPECT_EQ(out[3], 8);
+
+    // Division follows IEEE, without checks for 0
+    (bardrix::lanes4::load4(a) / bardrix::lanes4::set(2, 0, -0.0, 4)).store4(out);
+    EXPECT_EQ(out[0], 0.5);
+    EXPECT_EQ(out[1], std::numeric_limits<double>::infinity());
+    EXPECT_EQ(out[2], -std::numeric_limits<double>::infinity());
+    EXPECT_EQ(out[3], 1);
+
+    bardrix::lanes4::min(bardrix::lanes4::load4(a), bardrix::lanes4::load4(b)).store4(out);
+    EXPECT_EQ(out[0], 0.5);
+    EXPECT_EQ(out[1], -2);
+    EXPECT_EQ(out[2], 3);
+    bardrix::lanes4::max(bardrix::lanes4::load4(a), bardrix::lanes4::load4(b)).store4(out);
+    EXPECT_EQ(out[0], 1);
+    EXPECT_EQ(out[2], 8);
+
+    EXPECT_EQ(bardrix::lanes4::set(1, 2, 3, 4).sum3(), 6);
+    EXPECT_EQ(bardrix::lanes4::set(1, 2, 3, 4).sum4(), 10);
+
+    // Separate values are written one by one
+    double x = 0, y = 0, z = 0, w = 0;
+    bardrix::lanes4::set(1, 2, 3, 4).store3(x, y, z);
+    EXPECT_EQ(x, 1);
+    EXPECT_EQ(y, 2);
+    EXPECT_EQ(z, 3);
+    bardrix::lanes4::set(5, 6, 7, 8).store4(x, y, z, w);
+    EXPECT_EQ(x, 5);
+    EXPECT_EQ(z, 7);
+    EXPECT_EQ(w, 8);
+}
+
+/// \brief Test that the SIMD arithmetic of dimension3 and dimension4 is bit-identical to the scalar formulas
+TEST(lanes4, bit_identical) {
+    for (int i = 1; i < 200; ++i) {
+        const bardrix::vector3 a(std::sin(i) * 1e3, std::cos(i * 0.7) / 3, std::tan(i * 0.3));
+        const bardrix::vector3 b(std::cos(i) / 7, std::sin(i * 1.3) * 1e-3, i * 0.1);
+        const double n = std::sin(i * 0.9) + 2;
+
+        const bardrix::vector3 sum = a + b, difference = a - b, scaled = a * n, divided = a / n;
+        EXPECT_EQ(sum.x, a.x + b.x);
+        EXPECT_EQ(difference.y, a.y - b.y);
+        EXPECT_EQ(scaled.z, a.z * n);
+        EXPECT_EQ(divided.x, a.x / n);
+        EXPECT_EQ(a.dot(b), a.x * b.x + a.y * b.y + a.z * b.z);
+        EXPECT_EQ(a.length_squared(), a.x * a.x + a.y * a.y + a.z * a.z);
+
+        const bardrix::vector3 cross = a.cross(b);
+        EXPECT_EQ(cross.x, a.y * b.z - a.z * b.y);
+        EXPECT_EQ(cross.y, a.z * b.x - a.x * b.z);
+        EXPECT_EQ(cross.z, a.x * b.y - a.y * b.x);
+
+        EXPECT_EQ(a.min(b).y, std::min(a.y, b.y));
+        EXPECT_EQ(a.max(b).z, std::max(a.z, b.z));
+
+        const bardrix::quaternion p(a.x, a.y, a.z, n), q(b.x, b.y, b.z, -n);
+        const bardrix::quaternion product = p * q;
+        EXPECT_EQ(product.x, p.w * q.x + p.x * q.w + p.y * q.z - p.z * q.y);
+        EXPECT_EQ(product.y, p.w * q.y - p.x * q.z + p.y * q.w + p.z * q.x);
+        EXPECT_EQ(product.z, p.w * q.z + p.x * q.y - p.y * q.x + p.z * q.w);
+        EXPECT_EQ(product.w, p.w * q.w - p.x * q.x - p.y * q.y - p.z * q.z);
+        EXPECT_EQ(p.length(), std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z + p.w * p.w));
+    }
+}
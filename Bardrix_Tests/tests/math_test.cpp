@@ -61,4 +61,22 @@ TEST(math, nearly_equal) {
     EXPECT_FALSE(bardrix::nearly_equal(523.0002, 523));
     EXPECT_FALSE(bardrix::nearly_equal(523, 523.0002));
     EXPECT_FALSE(bardrix::nearly_equal(537458938.0002, 537458938));
-}
\ No newline at end of file
+}
+/// \brief Test the math functions at compile time
+TEST(math, constexpr_evaluation) {
+    static_assert(bardrix::degrees_to_radians(180) == bardrix::pi);
+    static_assert(bardrix::radians_to_degrees(bardrix::pi) == 180);
+    static_assert(bardrix::nearly_equal(0.1 + 0.2, 0.3, 1e-12));
+    static_assert(!bardrix::nearly_equal(1, 1.001, 1e-4));
+    static_assert(bardrix::nearly_equal(1, 1.00001)); // default_epsilon at compile time
+    static_assert(bardrix::less_than_or_nearly_equal(1, 1.00001));
+    static_assert(bardrix::greater_than_or_nearly_equal(1.00001, 1));
+
+    // The epsilon value is still used at run time
+    const double epsilon = bardrix::epsilon;
+    bardrix::epsilon = 0.1;
+    EXPECT_TRUE(bardrix::nearly_equal(1, 1.05));
+    bardrix::epsilon = epsilon;
+    EXPECT_FALSE(bardrix::nearly_equal(1, 1.05));
+    EXPECT_FALSE(bardrix::nearly_equal(std::nan(""), std::nan("")));
+}
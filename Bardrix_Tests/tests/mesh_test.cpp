@@ -0,0 +1,194 @@
+//
+// Created by Bardio on 16/10/2026.
+//
+
+#include <bardrix/mesh.h>
+
+namespace {
+
+    /// \brief Creates a wavy height field of size x size quads in the xz-plane, every quad is two triangles.
+    template<typename T>
+    void height_field(int size, std::vector<T>& vertices, std::vector<std::uint32_t>& indices) {
+        for (int z = 0; z <= size; ++z)
+            for (int x = 0; x <= size; ++x) {
+                vertices.push_back(static_cast<T>(x));
+                vertices.push_back(static_cast<T>(std::sin(x * 0.7) + std::cos(z * 0.3)));
+                vertices.push_back(static_cast<T>(z));
+            }
+
+        const auto vertex = [size](int x, int z) { return static_cast<std::uint32_t>(z * (size + 1) + x); };
+        for (int z = 0; z < size; ++z)
+            for (int x = 0; x < size; ++x) {
+                indices.insert(indices.end(), { vertex(x, z), vertex(x + 1, z), vertex(x + 1, z + 1) });
+                indices.insert(indices.end(), { vertex(x, z), vertex(x + 1, z + 1), vertex(x, z + 1) });
+            }
+    }
+
+} // namespace
+
+/// \brief Test the validation and the accessors of mesh buffers
+TEST(mesh_buffers, construct) {
+    // The vertex coordinates and indices must come in threes, and every index must be a vertex
+    EXPECT_THROW(bardrix::mesh_buffers<double>({ 0, 0, 0, 1 }, {}), std::invalid_argument);
+    EXPECT_THROW(bardrix::mesh_buffers<double>({ 0, 0, 0 }, { 0, 0 }), std::invalid_argument);
+    EXPECT_THROW(bardrix::mesh_buffers<double>({ 0, 0, 0, 1, 0, 0 }, { 0, 1, 2 }), std::invalid_argument);
+
+    // An empty mesh is hit by nothing
+    const bardrix::mesh_buffers<float> empty({}, {});
+    EXPECT_EQ(empty.triangle_count(), 0);
+    EXPECT_TRUE(empty.nodes().empty());
+    EXPECT_FALSE(empty.closest_hit(bardrix::ray(bardrix::point3(0, 0, 0), bardrix::vector3(0, 0, 1), 100)));
+
+    std::vector<float> vertices;
+    std::vector<std::uint32_t> indices;
+    height_field(16, vertices, indices);
+
+    const bardrix::mesh_buffers<float> buffers(vertices, indices);
+    EXPECT_EQ(buffers.vertex_count(), 17 * 17);
+    EXPECT_EQ(buffers.triangle_count(), 16 * 16 * 2);
+    EXPECT_EQ(buffers.vertices(), vertices);
+    EXPECT_EQ(buffers.indices(), indices);
+    EXPECT_EQ(buffers.vertex(18), bardrix::point3(1, vertices[18 * 3 + 1], 1));
+
+    // Every vertex is inside the bounding box
+    const bardrix::bounding_box box = buffers.bounding_box();
+    for (std::size_t i = 0; i < buffers.vertex_count(); ++i)
+        EXPECT_TRUE(box.inside(buffers.vertex(i)));
+
+    // The triangles are grouped in leaves of at most default_leaf_size triangles
+    std::size_t triangles = 0;
+    for (const bardrix::bvh_node& node: buffers.nodes()) {
+        EXPECT_LE(node.count, bardrix::mesh_buffers<float>::default_leaf_size);
+        triangles += node.count;
+    }
+    EXPECT_EQ(triangles, buffers.triangle_count());
+}
+
+/// \brief Test the closest hit of a triangle mesh against every triangle on its own
+TEST(triangle_mesh, intersect) {
+    std::vector<double> vertices;
+    std::vector<std::uint32_t> indices;
+    height_field(12, vertices, indices);
+
+    const bardrix::point3 position(-6, -10, -6);
+    const bardrix::triangle_mesh mesh(std::make_shared<const bardrix::mesh_buffers<double>>(vertices, indices),
+                                      position);
+
+    // Every triangle as a mesh on its own
+    std::vector<bardrix::triangle_mesh> triangles;
+    for (std::size_t i = 0; i < indices.size(); i += 3) {
+        std::vector<double> triangle;
+        for (std::size_t j = i; j < i + 3; ++j)
+            triangle.insert(triangle.end(), vertices.begin() + indices[j] * 3, vertices.begin() + indices[j] * 3 + 3);
+        triangles.emplace_back(std::make_shared<const bardrix::mesh_buffers<double>>(triangle,
+                                                                                     std::vector<std::uint32_t>{ 0, 1, 2 }),
+                               position);
+    }
+
+    for (int i = 0; i < 200; ++i) {
+        const bardrix::ray ray(bardrix::point3(std::fmod(i * 0.37, 10) - 5, 0, std::fmod(i * 0.71, 10) - 5),
+                               bardrix::vector3(std::fmod(i * 0.13, 1) - 0.5, -1, std::fmod(i * 0.29, 1) - 0.5), 100);
+
+        std::optional<bardrix::hit> expected;
+        for (std::size_t j = 0; j < triangles.size(); ++j) {
+            std::optional<bardrix::hit> hit = triangles[j].intersect(ray);
+            if (hit && (!expected || hit->t < expected->t)) {
+                expected = hit;
+                expected->primitive = static_cast<std::uint32_t>(j);
+            }
+        }
+
+        const std::optional<bardrix::hit> hit = mesh.intersect(ray);
+        ASSERT_EQ(hit.has_value(), expected.has_value());
+        EXPECT_EQ(mesh.intersect_distance(ray), hit ? hit->t : std::numeric_limits<double>::infinity());
+        if (!hit) continue;
+
+        EXPECT_DOUBLE_EQ(hit->t, expected->t);
+        EXPECT_EQ(hit->primitive, expected->primitive);
+        EXPECT_EQ(hit->position, ray.point_at(hit->t));
+        EXPECT_EQ(hit->normal, expected->normal);
+        EXPECT_EQ(mesh.intersection(ray), hit->position);
+        EXPECT_EQ(mesh.normal_at(hit->position), hit->normal);
+    }
+
+    // A ray which is too short, and a ray which misses the mesh
+    EXPECT_FALSE(mesh.intersect(bardrix::ray(bardrix::point3(0, 0, 0), bardrix::vector3(0, -1, 0), 5)));
+    EXPECT_FALSE(mesh.intersect(bardrix::ray(bardrix::point3(0, 0, 0), bardrix::vector3(0, 1, 0), 100)));
+    EXPECT_EQ(mesh.normal_at(bardrix::point3(0, 0, 0)), bardrix::vector3(0, 0, 0));
+}
+
+/// \brief Test that rays through the shared edges and vertices of triangles never slip through the mesh
+TEST(triangle_mesh, watertight) {
+    // A flat grid, the diagonals and the vertices are shared by several triangles
+    std::vector<double> vertices;
+    std::vector<std::uint32_t> indices;
+    for (int z = 0; z <= 4; ++z)
+        for (int x = 0; x <= 4; ++x)
+            vertices.insert(vertices.end(), { x * 0.1, 0, z * 0.1 });
+    for (std::uint32_t z = 0; z < 4; ++z)
+        for (std::uint32_t x = 0; x < 4; ++x) {
+            const std::uint32_t v = z * 5 + x;
+            indices.insert(indices.end(), { v, v + 1, v + 6, v, v + 6, v + 5 });
+        }
+
+    const bardrix::triangle_mesh mesh(vertices, indices);
+    for (int i = 0; i < 400; ++i) {
+        // A point on a diagonal, on an edge between two quads or on a vertex inside the grid
+        const double t = 0.1 + (i % 20) * 0.01;
+        const bardrix::point3 targets[3] = { bardrix::point3(t, 0, t), bardrix::point3(0.2, 0, t),
+                                             bardrix::point3(0.1 + (i % 3) * 0.1, 0, 0.1 + (i / 3 % 3) * 0.1) };
+
+        // Rays from many directions, exactly through the target
+        const bardrix::vector3 direction(0.05 * (i % 9) - 0.2, -1, 0.05 * (i / 9 % 9) - 0.2);
+        for (const bardrix::point3& target: targets) {
+            const bardrix::ray ray(target - direction * 3, direction, 100);
+
+            EXPECT_TRUE(mesh.intersect(ray));
+            EXPECT_TRUE(mesh.buffers()->occluded(ray));
+        }
+    }
+}
+
+/// \brief Test that float and double buffers give the same hits, and that buffers are shared between meshes
+TEST(triangle_mesh, shared_buffers) {
+    std::vector<double> vertices;
+    std::vector<std::uint32_t> indices;
+    height_field(8, vertices, indices);
+
+    auto buffers = std::make_shared<const bardrix::mesh_buffers<double>>(vertices, indices);
+    auto buffers_f = std::make_shared<const bardrix::mesh_buffers<float>>(
+            std::vector<float>(vertices.begin(), vertices.end()), indices);
+
+    // Two copies of the mesh next to each other, with one set of buffers
+    std::vector<std::shared_ptr<bardrix::shape>> shapes;
+    shapes.push_back(std::make_shared<bardrix::triangle_mesh>(buffers, bardrix::point3(0, 0, 0)));
+    shapes.push_back(std::make_shared<bardrix::triangle_mesh>(buffers, bardrix::point3(10, 0, 0)));
+    shapes.push_back(std::make_shared<bardrix::triangle_mesh_f>(buffers_f, bardrix::point3(0, 0, 10)));
+    EXPECT_EQ(buffers.use_count(), 3);
+    EXPECT_EQ(shapes[1]->bounding_box().get_min().x, buffers->bounding_box().get_min().x + 10);
+
+    bardrix::bvh_tree bvh;
+    bvh.construct_sah(shapes.begin(), shapes.end());
+
+    for (int i = 0; i < 100; ++i) {
+        const double x = std::fmod(i * 0.37, 6) + 1, z = std::fmod(i * 0.71, 6);
+        const bardrix::vector3 down(0.1, -1, 0.2);
+
+        // Both copies are hit at the same distance
+        const std::optional<bardrix::bvh_hit> left = bvh.closest_hit(bardrix::ray(bardrix::point3(x, 5, z), down, 100));
+        const std::optional<bardrix::bvh_hit> right = bvh.closest_hit(
+                bardrix::ray(bardrix::point3(x + 10, 5, z), down, 100));
+        const std::optional<bardrix::bvh_hit> single = bvh.closest_hit(
+                bardrix::ray(bardrix::point3(x, 5, z + 10), down, 100));
+        ASSERT_TRUE(left && right && single);
+        EXPECT_EQ(left->shape, shapes[0].get());
+        EXPECT_EQ(right->shape, shapes[1].get());
+        EXPECT_EQ(single->shape, shapes[2].get());
+        EXPECT_DOUBLE_EQ(left->distance, right->distance);
+
+        // Float vertices are close to the double vertices
+        EXPECT_NEAR(left->distance, single->distance, 1e-5);
+    }
+
+    EXPECT_THROW(bardrix::triangle_mesh(std::shared_ptr<const bardrix::mesh_buffers<double>>()), std::invalid_argument);
+}
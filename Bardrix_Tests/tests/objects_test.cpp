@@ -732,6 +732,55 @@ TEST(bounding_box, intersects_ray_edge_cases) {
     EXPECT_FALSE(box.intersects(ray));
 }
 
+/// \brief Test the bounding_box intersects method with a traversal_ray, it should agree with a normal ray
+TEST(bounding_box, intersects_traversal_ray) {
+    bardrix::point3 min = bardrix::point3(-5.04, 3.4, 0);
+    bardrix::point3 max = bardrix::point3(4, 12.44, 6.84);
+    bardrix::bounding_box box = bardrix::bounding_box(min, max);
+    double distance = 100;
+
+    std::vector<bardrix::ray> rays = {
+            bardrix::ray(bardrix::point3(0, 0, 0), bardrix::vector3(-1, 2, 2), distance),
+            bardrix::ray(bardrix::point3(0, 0, 0), bardrix::vector3(-1.78419, 2.6324, 2), distance),
+            bardrix::ray(bardrix::point3(0, 0, 0), bardrix::vector3(1.39641, 1.79423, 3.62911), distance),
+            bardrix::ray(bardrix::point3(-12, 4, 6), bardrix::vector3(0.10442, 1.016, 2), distance),
+            bardrix::ray(bardrix::point3(2, 23, -4), bardrix::vector3(-1, -2, 0.7), distance),
+            bardrix::ray(bardrix::point3(0, 20, 4), bardrix::vector3(-1, -2, -2), distance),
+            bardrix::ray(bardrix::point3(2, 23, -2), bardrix::vector3(-28.86337, -12.71138, 23.94488), distance),
+            bardrix::ray(bardrix::point3(0, 0, 0), bardrix::vector3(-1, 2, 2), 0.5),
+            bardrix::ray(box.center(), bardrix::vector3(1.78419, 2.6324, 2), distance),
+    };
+
+    for (const bardrix::ray& ray: rays)
+        EXPECT_EQ(box.intersects(bardrix::traversal_ray(ray)), box.intersects(ray)) << ray;
+
+    // Axis aligned rays, the direction is 0 on the other axes
+    EXPECT_TRUE(bardrix::bounding_box({ 1, 2, 3 }, { 3, 4, 5 }).intersects(
+            bardrix::traversal_ray(bardrix::ray(bardrix::point3(2, 3, 1), bardrix::vector3(0, 0, 1), distance))));
+    EXPECT_FALSE(bardrix::bounding_box({ 1, 2, 3 }, { 3, 4, 5 }).intersects(
+            bardrix::traversal_ray(bardrix::ray(bardrix::point3(0, 5.5, 4), bardrix::vector3(1, 0, 0), distance))));
+
+    // The ray lies in the plane of a face
+    EXPECT_TRUE(bardrix::bounding_box({ 1, 2, 3 }, { 3, 4, 5 }).intersects(
+            bardrix::traversal_ray(bardrix::ray(bardrix::point3(0, 2, 4), bardrix::vector3(1, 0, 0), distance))));
+
+    // The interval along the ray is taken into account
+    bardrix::traversal_ray ray(bardrix::ray(bardrix::point3(0, 0, 0), bardrix::vector3(0, 1, 0), distance));
+    box = bardrix::bounding_box({ -1, 10, -1 }, { 1, 20, 1 });
+    EXPECT_TRUE(box.intersects(ray));
+    ray.t_max = 9;
+    EXPECT_FALSE(box.intersects(ray));
+    ray.t_max = 10;
+    EXPECT_TRUE(box.intersects(ray));
+    ray.t_min = 20.5;
+    ray.t_max = distance;
+    EXPECT_FALSE(box.intersects(ray));
+
+    // A flat box
+    box = bardrix::bounding_box({ -1, 10, -1 }, { 1, 10, 1 });
+    EXPECT_TRUE(box.intersects(bardrix::traversal_ray(bardrix::ray(bardrix::point3(0, 0, 0), bardrix::vector3(0, 1, 0), distance))));
+}
+
 ///\brief Test the operator+ with a vector3
 TEST(bounding_box, operator_plus_vector3) {
     bardrix::point3 min = bardrix::point3(-1, -1, -1);
@@ -1076,6 +1125,71 @@ TEST(sphere, intersects_ray_inside) {
     EXPECT_FALSE(sphere.intersection(ray).has_value());
 }
 
+/// \brief Test the intersect method of sphere against intersection and normal_at
+TEST(sphere, intersect) {
+    bardrix::sphere sphere = bardrix::sphere(bardrix::point3(-12.72, 8.14, 0), 5);
+
+    bardrix::ray ray = bardrix::ray(bardrix::point3(5, 6, 7), bardrix::point3(-20.1, 10.55, 3));
+    std::optional<bardrix::hit> hit = sphere.intersect(ray);
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(hit->position, bardrix::point3(-10.664, 8.83949, 4.50374));
+    EXPECT_EQ(hit->normal, sphere.normal_at(hit->position));
+    EXPECT_EQ(hit->primitive, 0);
+
+    // A miss and a ray from inside the sphere
+    EXPECT_FALSE(sphere.intersect(bardrix::ray(bardrix::point3(5, 6, 7), bardrix::point3(-19.87738, 5.04547, 3.67166))));
+    EXPECT_FALSE(sphere.intersect(bardrix::ray(bardrix::point3(-12.72, 8.14, 0), bardrix::point3(10, 20, 30))));
+
+    // The same hits as intersection and normal_at, which is also the default of shape
+    for (int i = 0; i < 100; ++i) {
+        ray = bardrix::ray(bardrix::point3(std::fmod(i * 0.37, 12) - 18, std::fmod(i * 0.71, 12) + 2, -20),
+                           bardrix::vector3(std::fmod(i * 0.013, 0.2) - 0.1, 0, 1), std::fmod(i * 0.41, 30));
+
+        const std::optional<bardrix::point3> intersection = sphere.intersection(ray);
+        hit = sphere.intersect(ray);
+        const std::optional<bardrix::hit> expected = sphere.shape::intersect(ray);
+        ASSERT_EQ(hit.has_value(), intersection.has_value());
+        ASSERT_EQ(expected.has_value(), intersection.has_value());
+        if (!hit) continue;
+
+        EXPECT_EQ(hit->position, *intersection);
+        EXPECT_NEAR(hit->t, expected->t, 1e-9);
+        EXPECT_EQ(hit->position, expected->position);
+        EXPECT_EQ(hit->normal, expected->normal);
+        EXPECT_NEAR(hit->normal.length(), 1, 1e-12);
+    }
+}
+
+/// \brief Test the intersect_distance method of sphere
+TEST(sphere, intersect_distance) {
+    const bardrix::sphere sphere = bardrix::sphere(bardrix::point3(-12.72, 8.14, 0), 5);
+
+    // A miss and a ray from inside the sphere
+    EXPECT_EQ(bardrix::sphere::intersect_distance(sphere.get_position(), sphere.get_radius(),
+                                                  bardrix::ray(bardrix::point3(5, 6, 7), bardrix::point3(-19.87738, 5.04547, 3.67166))),
+              std::numeric_limits<double>::infinity());
+    EXPECT_EQ(bardrix::sphere::intersect_distance(sphere.get_position(), sphere.get_radius(),
+                                                  bardrix::ray(bardrix::point3(-12.72, 8.14, 0), bardrix::point3(10, 20, 30))),
+              std::numeric_limits<double>::infinity());
+
+    // The same distance as intersect
+    for (int i = 0; i < 100; ++i) {
+        const bardrix::ray ray(bardrix::point3(std::fmod(i * 0.37, 12) - 18, std::fmod(i * 0.71, 12) + 2, -20),
+                               bardrix::vector3(std::fmod(i * 0.013, 0.2) - 0.1, 0, 1), std::fmod(i * 0.41, 30));
+
+        const std::optional<bardrix::hit> hit = sphere.intersect(ray);
+        const double distance = bardrix::sphere::intersect_distance(sphere.get_position(), sphere.get_radius(), ray);
+        ASSERT_EQ(hit.has_value(), distance != std::numeric_limits<double>::infinity());
+        EXPECT_EQ(sphere.intersect_distance(ray), distance);
+        if (!hit) continue;
+
+        // The default of shape turns the intersection point back into a distance
+        EXPECT_EQ(hit->t, distance);
+        EXPECT_NEAR(sphere.shape::intersect_distance(ray), distance, 1e-9);
+        EXPECT_EQ(*sphere.intersection(ray), ray.point_at(distance));
+    }
+}
+
 /// \brief Test the normal_at method of sphere
 TEST(sphere, normal_at) {
     bardrix::sphere sphere = bardrix::sphere(bardrix::point3(0, 0, 0), 5);
@@ -1122,6 +1236,35 @@ TEST(sphere, bounding_box_edge_cases) {
     EXPECT_EQ(box.get_max(), bardrix::point3(0, 0, 0));
 }
 
+/// \brief Test the clipped_bounding_box method of sphere
+TEST(sphere, clipped_bounding_box) {
+    bardrix::sphere sphere = bardrix::sphere(bardrix::point3(0, 0, 0), 5);
+
+    // Bounds around the sphere give the bounding box
+    std::optional<bardrix::bounding_box> box = sphere.clipped_bounding_box(
+            bardrix::bounding_box(bardrix::point3(-10, -10, -10), bardrix::point3(10, 10, 10)));
+    ASSERT_TRUE(box.has_value());
+    EXPECT_EQ(*box, sphere.bounding_box());
+
+    // A slab at x = 3 cuts a circle with radius 4
+    box = sphere.clipped_bounding_box(bardrix::bounding_box(bardrix::point3(3, -10, -10), bardrix::point3(10, 10, 10)));
+    ASSERT_TRUE(box.has_value());
+    EXPECT_EQ(box->get_min(), bardrix::point3(3, -4, -4));
+    EXPECT_EQ(box->get_max(), bardrix::point3(5, 4, 4));
+
+    // Two slabs limit every axis
+    box = sphere.clipped_bounding_box(bardrix::bounding_box(bardrix::point3(3, 3, -10), bardrix::point3(10, 10, 10)));
+    ASSERT_TRUE(box.has_value());
+    EXPECT_EQ(box->get_min(), bardrix::point3(3, 3, -std::sqrt(7)));
+    EXPECT_EQ(box->get_max(), bardrix::point3(4, 4, std::sqrt(7)));
+
+    // Bounds outside the sphere, also in the corner of its bounding box
+    EXPECT_FALSE(sphere.clipped_bounding_box(
+            bardrix::bounding_box(bardrix::point3(6, -10, -10), bardrix::point3(10, 10, 10))).has_value());
+    EXPECT_FALSE(sphere.clipped_bounding_box(
+            bardrix::bounding_box(bardrix::point3(4, 4, 4), bardrix::point3(10, 10, 10))).has_value());
+}
+
 /// \brief Test the operator== with two equal spheres
 TEST(sphere, operator_equal_equal) {
     bardrix::sphere sphere1 = bardrix::sphere(bardrix::point3(1, 2, 3), 4);
@@ -149,3 +149,35 @@ TEST(point3, print) {
     p.print(ss);
     EXPECT_EQ(ss.str(), "(1, 2, 3)");
 }
+
+/// \brief Test the float point3 and the conversions between float and double
+TEST(point3, float_precision) {
+    static_assert(std::is_same_v<bardrix::point3, bardrix::basic_point3<double>>);
+    static_assert(std::is_same_v<decltype(bardrix::point3_f().vector_to(bardrix::point3_f())), bardrix::vector3_f>);
+    static_assert(!std::is_convertible_v<bardrix::point3_f, bardrix::point3>, "the conversion must be explicit");
+
+    const bardrix::point3_f p(1, 2, 3);
+    EXPECT_FLOAT_EQ(p.distance(bardrix::point3_f(4, 6, 3)), 5);
+    EXPECT_EQ(p.midpoint(bardrix::point3_f(3, 4, 5)), bardrix::point3_f(2, 3, 4));
+    EXPECT_EQ(p + bardrix::vector3_f(1, 1, 1), bardrix::point3_f(2, 3, 4));
+    EXPECT_EQ(p.min(bardrix::point3_f(0, 5, 0)), bardrix::point3_f(0, 2, 0));
+    EXPECT_FLOAT_EQ(p[bardrix::axis::y], 2);
+
+    const bardrix::point3 precise(1.5, -2.25, 1e10);
+    EXPECT_EQ(bardrix::point3(bardrix::point3_f(precise)), precise);
+    EXPECT_EQ(bardrix::point3_f(precise).z, 1e10f);
+}
+
+/// \brief Test the point3 operations at compile time
+TEST(point3, constexpr_evaluation) {
+    constexpr bardrix::point3 origin(1, 2, 3);
+    constexpr bardrix::point3 target = origin + bardrix::vector3(0, 0, 1) * 4;
+
+    static_assert(target == bardrix::point3(1, 2, 7));
+    static_assert(origin.vector_to(target) == bardrix::vector3(0, 0, 4));
+    static_assert(origin.distance_squared(target) == 16);
+    static_assert(origin.midpoint(target) == bardrix::point3(1, 2, 5));
+    static_assert((target - bardrix::vector3(1, 1, 1))[bardrix::axis::x] == 0);
+
+    EXPECT_EQ(origin.distance(target), 4);
+}
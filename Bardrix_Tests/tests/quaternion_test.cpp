@@ -238,6 +238,26 @@ TEST(quaternion, rotation_degenerate_test2) {
     ASSERT_EQ(result, vector);
 }
 
+/// \brief Test the rotation quaternions and rotating with them
+TEST(quaternion, rotation_quaternion) {
+    bardrix::vector3 rotation_vector = {1, 2, 3};
+    bardrix::point3 point = {4, 5, 6};
+
+    bardrix::quaternion q = bardrix::quaternion::rotation_degrees(rotation_vector, 90);
+    EXPECT_DOUBLE_EQ(q.length(), 1);
+    ASSERT_EQ(q.rotate(point), bardrix::quaternion::rotate_degrees(point, rotation_vector, 90));
+    ASSERT_EQ(q.rotate(bardrix::vector3(4, 5, 6)), bardrix::vector3(3.0875, 2.9678, 7.6589));
+    ASSERT_EQ(q.rotate_inverse(q.rotate(point)), point);
+
+    q = bardrix::quaternion::rotation_radians(bardrix::vector3(1, 0, 0), bardrix::pi);
+    ASSERT_EQ(q.rotate(bardrix::point3(1, 2, 3)), bardrix::point3(1, -2, -3));
+
+    // Without a rotation vector there is no rotation
+    q = bardrix::quaternion::rotation_degrees(bardrix::vector3(0, 0, 0), 90);
+    ASSERT_EQ(q, bardrix::quaternion::identity());
+    ASSERT_EQ(q.rotate(point), point);
+}
+
 /// \brief Test the mirror of a quaternion
 TEST(quaternion, mirror) {
     bardrix::vector3 rotation_vector = {1, 2, 3};
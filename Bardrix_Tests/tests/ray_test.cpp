@@ -151,4 +151,23 @@ TEST(ray, operator_stream) {
     std::stringstream ss;
     ss << r;
     EXPECT_EQ(ss.str(), "Position: (0, 0, 0), Direction: (0, 0, 1), Length: 1");
-}
\ No newline at end of file
+}
+/// \brief Test the traversal_ray constructors and getters
+TEST(traversal_ray, constructor) {
+    bardrix::ray r = bardrix::ray(bardrix::point3(1, 2, 3), bardrix::vector3(2, -4, 0), 10);
+    bardrix::traversal_ray t(r);
+
+    EXPECT_EQ(t.get_origin(), bardrix::point3(1, 2, 3));
+    EXPECT_DOUBLE_EQ(t.get_inverse_direction().x, 1 / r.get_direction().x);
+    EXPECT_DOUBLE_EQ(t.get_inverse_direction().y, 1 / r.get_direction().y);
+    EXPECT_EQ(t.get_inverse_direction().z, std::numeric_limits<double>::infinity());
+    EXPECT_EQ(t.get_sign(0), 0);
+    EXPECT_EQ(t.get_sign(1), 1);
+    EXPECT_EQ(t.get_sign(2), 0);
+    EXPECT_DOUBLE_EQ(t.t_min, 0);
+    EXPECT_DOUBLE_EQ(t.t_max, 10);
+
+    t = bardrix::traversal_ray(r, 2, 5);
+    EXPECT_DOUBLE_EQ(t.t_min, 2);
+    EXPECT_DOUBLE_EQ(t.t_max, 5);
+}
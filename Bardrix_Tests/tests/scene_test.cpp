@@ -0,0 +1,125 @@
+//
+// Created by Bardio on 16/10/2026.
+//
+
+#include <bardrix/scene.h>
+
+/// \brief Test the intersection of a scene sphere against a sphere
+TEST(scene_sphere, intersect) {
+    const bardrix::scene_sphere sphere{ { 0, 0, 10 }, 2, 0 };
+    const bardrix::sphere reference(bardrix::point3(0, 0, 10), 2);
+
+    EXPECT_EQ(sphere.position(), reference.get_position());
+    EXPECT_EQ(sphere.bounding_box(), reference.bounding_box());
+
+    // A hit in front of the ray
+    const bardrix::ray ray(bardrix::point3(0, 0, 0), bardrix::vector3(0, 0, 1), 100);
+    EXPECT_DOUBLE_EQ(sphere.intersect(ray), 8);
+    EXPECT_EQ(sphere.normal_at(ray.point_at(8)), reference.normal_at(ray.point_at(8)));
+
+    // A ray which is too short, a ray which misses and a ray from inside the sphere
+    EXPECT_EQ(sphere.intersect(bardrix::ray(bardrix::point3(0, 0, 0), bardrix::vector3(0, 0, 1), 7)),
+              std::numeric_limits<double>::infinity());
+    EXPECT_EQ(sphere.intersect(bardrix::ray(bardrix::point3(0, 3, 0), bardrix::vector3(0, 0, 1), 100)),
+              std::numeric_limits<double>::infinity());
+    EXPECT_EQ(sphere.intersect(bardrix::ray(bardrix::point3(0, 0, 10), bardrix::vector3(0, 0, 1), 100)),
+              std::numeric_limits<double>::infinity());
+
+    // The same hits as sphere::intersection
+    for (int i = 0; i < 100; ++i) {
+        const bardrix::ray test(bardrix::point3(std::fmod(i * 0.37, 6) - 3, std::fmod(i * 0.71, 6) - 3, 0),
+                                bardrix::vector3(std::fmod(i * 0.013, 0.2) - 0.1, 0, 1), 100);
+
+        const std::optional<bardrix::point3> intersection = reference.intersection(test);
+        const double distance = sphere.intersect(test);
+        ASSERT_EQ(intersection.has_value(), distance != std::numeric_limits<double>::infinity());
+        if (intersection) EXPECT_NEAR(distance, test.position.distance(*intersection), 1e-9);
+    }
+}
+
+/// \brief Test the materials and spheres of a scene
+TEST(scene, add) {
+    bardrix::scene scene;
+    EXPECT_TRUE(scene.is_empty());
+
+    // A sphere needs a material of the scene
+    EXPECT_THROW(scene.add_sphere(bardrix::point3(0, 0, 0), 1, 0), std::invalid_argument);
+
+    const std::uint32_t red = scene.add_material(bardrix::material(0.1, 0.9, 0, 1, bardrix::color::red()));
+    const std::uint32_t blue = scene.add_material(bardrix::material(0.1, 0.9, 0, 1, bardrix::color::blue()));
+    EXPECT_EQ(red, 0);
+    EXPECT_EQ(blue, 1);
+    EXPECT_EQ(scene.materials().size(), 2);
+
+    EXPECT_EQ(scene.add_sphere(bardrix::point3(0, 0, 10), 1, red), 0);
+    EXPECT_EQ(scene.add_sphere(bardrix::point3(0, 0, 20), -1, blue), 1);
+    EXPECT_THROW(scene.add_sphere(bardrix::point3(0, 0, 0), 1, 2), std::invalid_argument);
+    EXPECT_FALSE(scene.is_empty());
+
+    ASSERT_EQ(scene.spheres().size(), 2);
+    EXPECT_EQ(scene.spheres()[1].material, blue);
+
+    // A negative radius is set to 0
+    EXPECT_EQ(scene.spheres()[1].radius, 0);
+
+    // The spheres are not hit before construct
+    const bardrix::ray ray(bardrix::point3(0, 0, 0), bardrix::vector3(0, 0, 1), 100);
+    EXPECT_FALSE(scene.closest_hit(ray).has_value());
+
+    scene.construct();
+    std::optional<bardrix::scene_hit> hit = scene.closest_hit(ray);
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(hit->type, bardrix::shape_type::sphere);
+    EXPECT_EQ(hit->index, 0);
+    EXPECT_DOUBLE_EQ(hit->distance, 9);
+    EXPECT_EQ(scene.material_of(*hit).color, bardrix::color::red());
+    EXPECT_EQ(scene.normal_at(*hit, ray.point_at(hit->distance)), bardrix::vector3(0, 0, -1));
+
+    scene.clear();
+    EXPECT_TRUE(scene.is_empty());
+    EXPECT_TRUE(scene.materials().empty());
+    EXPECT_FALSE(scene.closest_hit(ray).has_value());
+    EXPECT_FALSE(scene.occluded(ray));
+}
+
+/// \brief Test the traversal of a scene against a bvh_tree of the same spheres
+TEST(scene, closest_hit) {
+    bardrix::scene scene;
+    std::vector<std::shared_ptr<bardrix::shape>> shapes;
+
+    for (int i = 0; i < 8; ++i)
+        scene.add_material(bardrix::material(0.1, 0.1 * i, 0, 1));
+
+    for (int i = 0; i < 2000; ++i) {
+        const bardrix::point3 position(std::fmod(i * 7.31, 60) - 30, std::fmod(i * 3.77, 60) - 30,
+                                       std::fmod(i * 5.13, 60) - 30);
+        const double radius = 0.2 + std::fmod(i * 0.37, 0.8);
+        scene.add_sphere(position, radius, i % 8);
+        shapes.push_back(std::make_shared<bardrix::sphere>(position, scene.materials()[i % 8], radius));
+    }
+
+    bardrix::bvh_tree bvh;
+    bvh.construct_sah(shapes.begin(), shapes.end());
+    scene.construct(bardrix::scene::default_leaf_size, bardrix::bvh_tree::default_sah_bins, 2);
+
+    int hits = 0;
+    for (int i = 0; i < 200; ++i) {
+        const bardrix::ray ray(bardrix::point3(-40, std::fmod(i * 1.9, 60) - 30, std::fmod(i * 2.3, 60) - 30),
+                               bardrix::vector3(1, std::fmod(i * 0.13, 0.6) - 0.3, std::fmod(i * 0.07, 0.6) - 0.3),
+                               std::fmod(i * 3.7, 100));
+
+        const std::optional<bardrix::bvh_hit> expected = bvh.closest_hit(ray);
+        const std::optional<bardrix::scene_hit> hit = scene.closest_hit(ray);
+        ASSERT_EQ(hit.has_value(), expected.has_value());
+        EXPECT_EQ(scene.occluded(ray), bvh.occluded(ray));
+        if (!hit) continue;
+        ++hits;
+
+        const auto* sphere = static_cast<const bardrix::sphere*>(expected->shape);
+        EXPECT_EQ(shapes[hit->index].get(), expected->shape);
+        EXPECT_NEAR(hit->distance, expected->distance, 1e-9);
+        EXPECT_EQ(scene.material_of(*hit), sphere->get_material());
+        EXPECT_EQ(scene.normal_at(*hit, ray.point_at(hit->distance)), sphere->normal_at(ray.point_at(hit->distance)));
+    }
+    EXPECT_GT(hits, 50);
+}
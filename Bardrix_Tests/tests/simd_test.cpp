@@ -0,0 +1,175 @@
+//
+// Created by Bardio on 16/10/2026.
+//
+
+#include <bardrix/simd.h>
+
+/// \brief Test the construction of a bounding box pack, every lane is empty
+TEST(bounding_box_pack, constructor) {
+    bardrix::bounding_box8 pack;
+    for (std::size_t lane = 0; lane < pack.size; ++lane)
+        EXPECT_TRUE(pack.is_empty(lane));
+
+    double entry[8];
+    EXPECT_EQ(pack.intersects(bardrix::traversal_ray(bardrix::ray(bardrix::vector3(1, 1, 1))), entry), 0);
+    for (double distance: entry)
+        EXPECT_EQ(distance, std::numeric_limits<double>::infinity());
+}
+
+/// \brief Test the set and clear methods of a bounding box pack
+TEST(bounding_box_pack, set_clear) {
+    bardrix::bounding_box4 pack;
+    pack.set(2, bardrix::bounding_box({ 1, 2, 3 }, { 4, 5, 6 }));
+    EXPECT_FALSE(pack.is_empty(2));
+    EXPECT_DOUBLE_EQ(pack.min_x[2], 1);
+    EXPECT_DOUBLE_EQ(pack.min_y[2], 2);
+    EXPECT_DOUBLE_EQ(pack.min_z[2], 3);
+    EXPECT_DOUBLE_EQ(pack.max_x[2], 4);
+    EXPECT_DOUBLE_EQ(pack.max_y[2], 5);
+    EXPECT_DOUBLE_EQ(pack.max_z[2], 6);
+
+    pack.clear(2);
+    EXPECT_TRUE(pack.is_empty(2));
+
+    // A flat bounding box is not empty
+    pack.set(1, bardrix::bounding_box({ 1, 1, 1 }, { 1, 1, 1 }));
+    EXPECT_FALSE(pack.is_empty(1));
+}
+
+/// \brief Test the intersects method of a bounding box pack
+TEST(bounding_box_pack, intersects) {
+    bardrix::bounding_box4 pack;
+    pack.set(0, bardrix::bounding_box({ 2, -1, -1 }, { 3, 1, 1 }));     // in front
+    pack.set(1, bardrix::bounding_box({ -3, -1, -1 }, { -2, 1, 1 }));   // behind
+    pack.set(2, bardrix::bounding_box({ 5, 5, 5 }, { 6, 6, 6 }));       // next to the ray
+    pack.set(3, bardrix::bounding_box({ -1, -1, -1 }, { 1, 1, 1 }));    // around the origin
+
+    double entry[4];
+    bardrix::traversal_ray ray(bardrix::ray(bardrix::point3(0, 0, 0), bardrix::vector3(1, 0, 0), 10));
+    EXPECT_EQ(pack.intersects(ray, entry), 0b1001);
+    EXPECT_DOUBLE_EQ(entry[0], 2);
+    EXPECT_EQ(entry[1], std::numeric_limits<double>::infinity());
+    EXPECT_EQ(entry[2], std::numeric_limits<double>::infinity());
+    EXPECT_DOUBLE_EQ(entry[3], 0);
+
+    // The other way around
+    ray = bardrix::traversal_ray(bardrix::ray(bardrix::point3(0, 0, 0), bardrix::vector3(-1, 0, 0), 10));
+    EXPECT_EQ(pack.intersects(ray, entry), 0b1010);
+    EXPECT_DOUBLE_EQ(entry[1], 2);
+
+    // The interval along the ray is taken into account
+    ray = bardrix::traversal_ray(bardrix::ray(bardrix::point3(0, 0, 0), bardrix::vector3(1, 0, 0), 10), 1.5, 1.8);
+    EXPECT_EQ(pack.intersects(ray, entry), 0);
+}
+
+/// \brief Test that the intersects method of a bounding box pack agrees with bounding_box::intersects(traversal_ray)
+TEST(bounding_box_pack, intersects_matches_bounding_box) {
+    std::vector<bardrix::bounding_box> boxes;
+    for (int i = 0; i < 64; ++i) {
+        const bardrix::point3 min(std::fmod(i * 7.31, 20) - 10, std::fmod(i * 3.77, 20) - 10, std::fmod(i * 5.13, 20) - 10);
+        boxes.emplace_back(min, min + bardrix::vector3(std::fmod(i * 0.37, 3), std::fmod(i * 0.53, 3), std::fmod(i * 0.71, 3)));
+    }
+
+    for (int r = 0; r < 50; ++r) {
+        // Some rays have a direction of 0 on an axis
+        const bardrix::ray ray(bardrix::point3(std::fmod(r * 1.9, 10) - 5, std::fmod(r * 2.3, 10) - 5, -15),
+                               bardrix::vector3(r % 3 == 0 ? 0 : std::fmod(r * 0.13, 0.6) - 0.3,
+                                                r % 5 == 0 ? 0 : std::fmod(r * 0.07, 0.6) - 0.3, 1), 30);
+        const bardrix::traversal_ray traversal(ray);
+
+        for (std::size_t first = 0; first < boxes.size(); first += 8) {
+            bardrix::bounding_box8 pack;
+            for (std::size_t lane = 0; lane < 8; ++lane)
+                pack.set(lane, boxes[first + lane]);
+
+            double entry[8];
+            const std::uint32_t mask = pack.intersects(traversal, entry);
+            for (std::size_t lane = 0; lane < 8; ++lane) {
+                const bool hit = boxes[first + lane].intersects(traversal);
+                EXPECT_EQ((mask >> lane & 1) != 0, hit);
+                if (hit) EXPECT_GE(entry[lane], traversal.t_min);
+                else EXPECT_EQ(entry[lane], std::numeric_limits<double>::infinity());
+            }
+        }
+    }
+}
+
+/// \brief Test the storage of a sphere soa
+TEST(sphere_soa, push_back) {
+    bardrix::sphere_soa spheres;
+    EXPECT_EQ(spheres.size(), 0);
+    EXPECT_FALSE(spheres.closest_hit(bardrix::ray(bardrix::point3(0, 0, 0), bardrix::vector3(0, 0, 1), 100)));
+
+    spheres.reserve(2);
+    spheres.push_back(bardrix::point3(1, 2, 3), 4);
+    spheres.push_back(bardrix::point3(5, 6, 7), -1);
+    ASSERT_EQ(spheres.size(), 2);
+    EXPECT_EQ(spheres.center(0), bardrix::point3(1, 2, 3));
+    EXPECT_EQ(spheres.radius(0), 4);
+    EXPECT_EQ(spheres.center(1), bardrix::point3(5, 6, 7));
+
+    // A negative radius is set to 0
+    EXPECT_EQ(spheres.radius(1), 0);
+
+    spheres.clear();
+    EXPECT_EQ(spheres.size(), 0);
+}
+
+/// \brief Test the closest hit of a sphere soa against intersecting every sphere on its own
+TEST(sphere_soa, closest_hit) {
+    // A count which doesn't fill the last SIMD register
+    bardrix::sphere_soa spheres;
+    std::vector<bardrix::sphere> reference;
+    for (int i = 0; i < 1003; ++i) {
+        const bardrix::point3 center(std::fmod(i * 7.31, 40) - 20, std::fmod(i * 3.77, 40) - 20,
+                                     std::fmod(i * 5.13, 40) + 5);
+        const double radius = 0.2 + std::fmod(i * 0.37, 1.2);
+        spheres.push_back(center, radius);
+        reference.emplace_back(center, radius);
+    }
+
+    int hits = 0;
+    for (int i = 0; i < 300; ++i) {
+        const bardrix::ray ray(bardrix::point3(std::fmod(i * 1.3, 40) - 20, std::fmod(i * 2.9, 40) - 20, 0),
+                               bardrix::vector3(std::fmod(i * 0.013, 0.2) - 0.1, std::fmod(i * 0.007, 0.2) - 0.1, 1),
+                               std::fmod(i * 0.37, 60));
+
+        // The whole batch and a range that doesn't start at a SIMD boundary
+        for (const auto& [first, last]: { std::pair<std::size_t, std::size_t>(0, spheres.size()),
+                                          std::pair<std::size_t, std::size_t>(17, 530) }) {
+            std::optional<double> expected;
+            std::uint32_t expected_index = 0;
+            for (std::size_t j = first; j < last; ++j) {
+                std::optional<bardrix::point3> intersection = reference[j].intersection(ray);
+                if (!intersection) continue;
+
+                const double distance = ray.position.distance(*intersection);
+                if (!expected || distance < *expected) {
+                    expected = distance;
+                    expected_index = static_cast<std::uint32_t>(j);
+                }
+            }
+
+            const std::optional<bardrix::batch_hit> hit = first == 0 ? spheres.closest_hit(ray)
+                                                                     : spheres.closest_hit(ray, first, last);
+            ASSERT_EQ(hit.has_value(), expected.has_value());
+            if (!hit) continue;
+            ++hits;
+
+            EXPECT_EQ(hit->index, expected_index);
+            EXPECT_NEAR(hit->distance, *expected, 1e-9);
+        }
+    }
+    EXPECT_GT(hits, 50);
+
+    // Two equal spheres hit at the same distance give the lowest index
+    bardrix::sphere_soa equal;
+    for (int i = 0; i < 8; ++i)
+        equal.push_back(bardrix::point3(0, 0, i == 3 || i == 6 ? 10 : -10), 1);
+
+    const std::optional<bardrix::batch_hit> hit = equal.closest_hit(
+            bardrix::ray(bardrix::point3(0, 0, 0), bardrix::vector3(0, 0, 1), 100));
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(hit->index, 3);
+    EXPECT_DOUBLE_EQ(hit->distance, 9);
+}
@@ -0,0 +1,140 @@
+//
+// Created by Bardio on 16/10/2026.
+//
+
+#include <bardrix/soa.h>
+
+namespace {
+
+    /// \brief Vectors with different lengths, the count isn't a multiple of 4 so the scalar loop is tested too
+    std::vector<bardrix::vector3> test_vectors(std::size_t count, double seed) {
+        std::vector<bardrix::vector3> vectors;
+        for (std::size_t i = 0; i < count; ++i) {
+            const double t = static_cast<double>(i) * seed;
+            vectors.emplace_back(std::sin(t) * (t + 1), std::cos(t * 1.3) * 3, 0.1 * t - 2);
+        }
+        return vectors;
+    }
+
+    /// \brief Checks that every component has the same bits
+    template<typename T>
+    void expect_identical(const T& actual, const T& expected) {
+        EXPECT_EQ(actual.x, expected.x);
+        EXPECT_EQ(actual.y, expected.y);
+        EXPECT_EQ(actual.z, expected.z);
+    }
+
+} // namespace
+
+/// \brief Test the construction, get, set and data of the arrays
+TEST(vector3_soa, construct) {
+    const std::vector<bardrix::vector3> vectors = test_vectors(7, 0.4);
+    bardrix::vector3_soa soa(vectors);
+
+    ASSERT_EQ(soa.size(), 7);
+    expect_identical(soa.get(5), vectors[5]);
+    EXPECT_EQ(soa.data(bardrix::axis::y)[2], vectors[2].y);
+    EXPECT_THROW((void) soa.data(bardrix::axis::w), std::invalid_argument);
+
+    soa.set(1, bardrix::vector3(1, 2, 3));
+    soa.data(bardrix::axis::z)[1] = 4;
+    EXPECT_EQ(soa.get(1), bardrix::vector3(1, 2, 4));
+
+    soa.push_back(bardrix::vector3(0, 0, 1));
+    soa.resize(10);
+    EXPECT_EQ(soa.get(7), bardrix::vector3(0, 0, 1));
+    EXPECT_EQ(soa.get(9), bardrix::vector3(0, 0, 0));
+
+    soa.clear();
+    EXPECT_EQ(soa.size(), 0);
+}
+
+/// \brief Test that the batch operations of vector3_soa give the same bits as the vector3 methods
+TEST(vector3_soa, batch_operations) {
+    std::vector<bardrix::vector3> vectors = test_vectors(23, 0.37);
+    const std::vector<bardrix::vector3> others = test_vectors(23, 1.91);
+    vectors[3] = bardrix::vector3(0, 0, 0); // stays the same when normalized
+
+    const bardrix::vector3_soa soa(vectors);
+    const bardrix::vector3_soa other_soa(others);
+
+    std::vector<double> lengths, dots;
+    soa.length(lengths);
+    soa.dot(other_soa, dots);
+    bardrix::vector3_soa crosses;
+    soa.cross(other_soa, crosses);
+
+    bardrix::vector3_soa normalized = soa;
+    normalized.normalize();
+
+    bardrix::vector3_soa moved = soa;
+    moved.add(other_soa);
+    moved.scale(0.3);
+
+    ASSERT_EQ(lengths.size(), vectors.size());
+    ASSERT_EQ(crosses.size(), vectors.size());
+    for (std::size_t i = 0; i < vectors.size(); ++i) {
+        EXPECT_EQ(lengths[i], vectors[i].length());
+        EXPECT_EQ(dots[i], vectors[i].dot(others[i]));
+        expect_identical(crosses.get(i), vectors[i].cross(others[i]));
+        expect_identical(normalized.get(i), vectors[i].normalized());
+        expect_identical(moved.get(i), (vectors[i] + others[i]) * 0.3);
+    }
+
+    // The output may be the input
+    bardrix::vector3_soa in_place = soa;
+    in_place.cross(other_soa, in_place);
+    expect_identical(in_place.get(10), vectors[10].cross(others[10]));
+
+    const bardrix::vector3_soa smaller(test_vectors(3, 1));
+    EXPECT_THROW(soa.dot(smaller, dots), std::invalid_argument);
+    EXPECT_THROW(soa.cross(smaller, crosses), std::invalid_argument);
+    EXPECT_THROW(moved.add(smaller), std::invalid_argument);
+}
+
+/// \brief Test that rotating the arrays gives the same bits as quaternion::rotate
+TEST(vector3_soa, rotate) {
+    const std::vector<bardrix::vector3> vectors = test_vectors(13, 0.71);
+    const bardrix::quaternion rotation = bardrix::quaternion::rotation_degrees(bardrix::vector3(1, 2, -0.5), 73);
+
+    bardrix::vector3_soa soa(vectors);
+    soa.rotate(rotation);
+
+    for (std::size_t i = 0; i < vectors.size(); ++i)
+        expect_identical(soa.get(i), rotation.rotate(vectors[i]));
+
+    bardrix::vector3_soa half_turn(std::vector<bardrix::vector3>{ bardrix::vector3(1, 2, 3) });
+    half_turn.rotate(bardrix::quaternion::rotation_degrees(bardrix::vector3(1, 0, 0), 180));
+    EXPECT_EQ(half_turn.get(0), bardrix::vector3(1, -2, -3));
+}
+
+/// \brief Test that the batch operations of point3_soa give the same bits as the point3 methods
+TEST(point3_soa, batch_operations) {
+    std::vector<bardrix::point3> points;
+    for (const bardrix::vector3& vector : test_vectors(18, 0.53))
+        points.emplace_back(vector.x, vector.y, vector.z);
+    const std::vector<bardrix::vector3> velocities = test_vectors(18, 2.3);
+    const bardrix::point3 target(1, -2, 0.5);
+
+    bardrix::point3_soa soa(points);
+    std::vector<double> distances;
+    soa.distance(target, distances);
+    for (std::size_t i = 0; i < points.size(); ++i)
+        EXPECT_EQ(distances[i], points[i].distance(target));
+
+    const bardrix::point3_soa original = soa;
+    soa.add(bardrix::vector3_soa(velocities), 0.016);
+    for (std::size_t i = 0; i < points.size(); ++i)
+        expect_identical(soa.get(i), points[i] + velocities[i] * 0.016);
+
+    soa.distance(original, distances);
+    for (std::size_t i = 0; i < points.size(); ++i)
+        EXPECT_EQ(distances[i], soa.get(i).distance(points[i]));
+
+    const bardrix::quaternion rotation = bardrix::quaternion::rotation_radians(bardrix::vector3(0, 1, 1), 1.2);
+    soa.rotate(rotation);
+    expect_identical(soa.get(17), rotation.rotate(points[17] + velocities[17] * 0.016));
+
+    EXPECT_THROW(soa.add(bardrix::vector3_soa(test_vectors(2, 1))), std::invalid_argument);
+    EXPECT_THROW(soa.distance(bardrix::point3_soa(), distances), std::invalid_argument);
+}
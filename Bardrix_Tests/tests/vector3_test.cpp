@@ -51,6 +51,21 @@ TEST(vector3, normalize_degenerate) {
     EXPECT_EQ(v, bardrix::vector3(0, 0, 0));
 }
 
+/// \brief Test the normalization without checking the length, which follows IEEE
+TEST(vector3, normalize_unchecked) {
+    bardrix::vector3 v(1, 2, 3);
+    const bardrix::vector3 normalized = v.normalized();
+
+    EXPECT_EQ(v.normalized_unchecked().x, normalized.x);
+    EXPECT_EQ(v.normalized_unchecked().z, normalized.z);
+    EXPECT_EQ(v.normalize_unchecked().y, normalized.y);
+    EXPECT_EQ(v.x, normalized.x);
+    EXPECT_NEAR(bardrix::vector3_f(4, 0, 3).normalized_unchecked().x, 0.8f, 1e-6);
+
+    // A vector with length 0 becomes NaN
+    EXPECT_TRUE(std::isnan(bardrix::vector3(0, 0, 0).normalized_unchecked().x));
+}
+
 /// \brief Test the dot product of two vectors
 TEST(vector3, dot) {
     bardrix::vector3 v1(1, 2, 3);
@@ -294,4 +309,57 @@ TEST(vector3, print) {
     std::stringstream ss;
     ss << v;
     EXPECT_EQ(ss.str(), "(1, 2, 3)");
-}
\ No newline at end of file
+}
+/// \brief Test the float vector3 and the conversions between float and double
+TEST(vector3, float_precision) {
+    static_assert(std::is_same_v<bardrix::vector3, bardrix::basic_vector3<double>>);
+    static_assert(std::is_same_v<decltype(bardrix::vector3_f().x), float>);
+    static_assert(!std::is_convertible_v<bardrix::vector3, bardrix::vector3_f>, "the conversion must be explicit");
+    static_assert(sizeof(bardrix::vector3_f) < sizeof(bardrix::vector3));
+
+    const bardrix::vector3_f v(1, 2, 3);
+    EXPECT_FLOAT_EQ(v.length_squared(), 14);
+    EXPECT_FLOAT_EQ(v.dot(bardrix::vector3_f(4, 5, 6)), 32);
+    EXPECT_EQ(v.cross(bardrix::vector3_f(4, 5, 6)), bardrix::vector3_f(-3, 6, -3));
+    EXPECT_EQ(v * 2 + v, bardrix::vector3_f(3, 6, 9));
+    EXPECT_NEAR(v.normalized().length(), 1, 1e-6);
+
+    // double -> float rounds to the nearest float, float -> double is exact
+    const bardrix::vector3 precise(0.1, 0.2, 0.3);
+    const bardrix::vector3_f rounded(precise);
+    EXPECT_EQ(rounded.x, 0.1f);
+    EXPECT_EQ(bardrix::vector3(rounded).x, static_cast<double>(0.1f));
+    EXPECT_EQ(bardrix::vector3(rounded), precise);
+
+    std::stringstream ss;
+    ss << v;
+    EXPECT_EQ(ss.str(), "(1, 2, 3)");
+}
+
+/// \brief Test the vector3 operations at compile time, the results must be the same as at run time
+TEST(vector3, constexpr_evaluation) {
+    constexpr bardrix::vector3 a(1, 2, 3);
+    constexpr bardrix::vector3 b(0.1, -0.7, 1.3);
+
+    constexpr double dot = a.dot(b);
+    constexpr bardrix::vector3 cross = a.cross(b);
+    constexpr bardrix::vector3 sum = (a + b) * 0.3 - a / 7 + 1.0;
+    constexpr bardrix::vector3 table[] = { a.min(b), a.max(b), -a, a.cross(b).cross(a) };
+    static_assert(a.length_squared() == 14);
+    static_assert(a[bardrix::axis::z] == 3);
+    static_assert(bardrix::vector3(1, 0, 0).cross(bardrix::vector3(0, 1, 0)) == bardrix::vector3(0, 0, 1));
+    static_assert(bardrix::vector3_f(a).dot(bardrix::vector3_f(1, 1, 1)) == 6);
+
+    // Bit-identical to the SIMD paths at run time
+    const bardrix::vector3 runtime_a = a, runtime_b = b;
+    const bardrix::vector3 runtime_sum = (runtime_a + runtime_b) * 0.3 - runtime_a / 7 + 1.0;
+    EXPECT_EQ(runtime_a.dot(runtime_b), dot);
+    EXPECT_EQ(runtime_a.cross(runtime_b).x, cross.x);
+    EXPECT_EQ(runtime_a.cross(runtime_b).z, cross.z);
+    EXPECT_EQ(runtime_sum.x, sum.x);
+    EXPECT_EQ(runtime_sum.y, sum.y);
+    EXPECT_EQ(runtime_sum.z, sum.z);
+    EXPECT_EQ(runtime_a.min(runtime_b).y, table[0].y);
+    EXPECT_EQ(runtime_a.max(runtime_b).y, table[1].y);
+    EXPECT_EQ(runtime_a.cross(runtime_b).cross(runtime_a).z, table[3].z);
+}